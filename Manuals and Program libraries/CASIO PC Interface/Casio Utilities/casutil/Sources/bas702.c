@@ -17,6 +17,7 @@
 #include <errno.h>
 #include"bool.h"
 #include"wave.h"
+#include"keyword.h"
 
 #define LEAD_IN_TIME 15         /* tens of a second */
 #define LEAD_IN_TIME_FIRST 15   /* tens of a second */
@@ -709,14 +710,20 @@ long read_line( char *buffer, int *err )
 }
 
 
+/*
+ *  Keyword indexes of the token tables
+ */
+KEYWORDS Keywords;
+
+
 /*
  *  Encode (tokenize) a program line
  */
 int encode( long line_number, char *line, unsigned char *buffer )
 {
-    unsigned int i, l, tl;
+    unsigned int i, l;
+    int k, tl;
     long ln = line_number;
-    const char **tp;
     struct _specials *sp;
     bool in_string;
     unsigned char *buff = buffer;
@@ -800,18 +807,13 @@ int encode( long line_number, char *line, unsigned char *buffer )
                 /*
                  *  Look if a token is matched
                  */
-                tp = Tokens;
-                for ( i = 0x60; *tp != NULL; ++tp, ++i ) {
-                    if ( 0 == strncmp( line, *tp, tl = strlen( *tp ) ) ) {
-                        break;
-                    }
-                }
-                if ( *tp != NULL ) {
+                k = kwMatch( &Keywords, line, &tl );
+                if ( k >= 0 ) {
                     /*
                      *  Replace string by token value
                      */
                     line += tl;
-                    *buff++ = (unsigned char) i;
+                    *buff++ = (unsigned char) ( k + 0x60 );
                     ++l;
                     continue;
                 }
@@ -889,6 +891,15 @@ int main( int argc, char *argv[] )
     ++argv;
     --argc;
 
+    /*
+     *  Index the keyword tables
+     */
+    if ( kwBuild( &Keywords, Tokens, sizeof( Tokens[ 0 ] ), FALSE ) != 0 ) 
+    {
+        perror( "error" );
+        return 2;
+    }
+
     while ( argc > 0 && **argv == '-' ) {
         /*
          *  Options
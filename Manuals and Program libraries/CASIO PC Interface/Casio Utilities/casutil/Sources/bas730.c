@@ -21,6 +21,7 @@
 #include <errno.h>
 #include "bool.h"
 #include "wave.h"
+#include "keyword.h"
 
 #define LEAD_IN_TIME 20         /* tens of a second */
 #define LEAD_IN_TIME_FIRST 20   /* tens of a second */
@@ -875,14 +876,21 @@ long read_line( char *buffer, int *err )
 }
 
 
+/*
+ *  Keyword indexes of the token tables
+ */
+KEYWORDS Keywords;
+KEYWORDS Keywords100;
+
+
 /*
  *  Encode (tokenize) a program line
  */
 int encode( long line_number, char *line, unsigned char *buffer )
 {
-    unsigned int i, l, tl;
+    unsigned int i, l;
+    int k, tl;
     long ln = line_number;
-    const char **tp;
     struct _specials *sp;
     bool transparent, in_string;
     unsigned char *buff = buffer;
@@ -981,13 +989,10 @@ int encode( long line_number, char *line, unsigned char *buffer )
                 /*
                  *  Look if a token is matched
                  */
-                tp = OutputPB100 ? tokens100 : tokens;
-                for ( i = 0x80; *tp != NULL; ++tp, ++i ) {
-                    if ( 0 == strncmp( line, *tp, tl = strlen( *tp ) ) ) {
-                        break;
-                    }
-                }
-                if ( *tp != NULL ) {
+                k = kwMatch( OutputPB100 ? &Keywords100 : &Keywords, 
+                             line, &tl );
+                if ( k >= 0 ) {
+                    i = k + 0x80;
                     /*
                      *  Replace string by token value
                      */
@@ -1083,6 +1088,17 @@ int main( int argc, char *argv[] )
     ++argv;
     --argc;
 
+    /*
+     *  Index the keyword tables
+     */
+    if ( kwBuild( &Keywords, tokens, sizeof( tokens[ 0 ] ), FALSE ) != 0
+      || kwBuild( &Keywords100, tokens100, sizeof( tokens100[ 0 ] ), FALSE )
+         != 0 ) 
+    {
+        perror( "error" );
+        return 2;
+    }
+
     while ( argc > 0 && **argv == '-' ) {
         /*
          *  Options
@@ -18,6 +18,9 @@
  *    -u make all data uppercase (for FX-750P)
  *    -l allow lowercase (for FP-200, FX-850P, PB-1000)
  *    -p force PB-700 escape syntax (for FP-200, PB-1000)
+ *
+ *  Several sources may be given, they are written to a single tape.
+ *  Options between the sources change the type of the following sources.
  */
 
 #include <stdio.h>
@@ -27,6 +30,7 @@
 #include <errno.h>
 #include "bool.h"
 #include "wave.h"
+#include "keyword.h"
 
 #define LEAD_IN_TIME 20       /* tens of a second */
 #define LEAD_IN_TIME_FIRST 20 /* tens of a second */
@@ -948,6 +952,7 @@ bool PbEscapes = FALSE;
 bool Fp200 = FALSE;
 bool AsciiLargeBlocks = FALSE;
 int LeadInTime;
+int DataDelay;
 int DataLines;
 enum { LOG_NONE, LOG_FX, LOG_PB } LogarithmMode = LOG_NONE;
 enum { UTF8_NONE, UTF8_FX, UTF8_PB } Utf8Mode = UTF8_NONE; 
@@ -1688,12 +1693,21 @@ long read_line( char *buffer, int *err )
 }
 
 
+/*
+ *  Keyword indexes of the token tables
+ */
+KEYWORDS Keywords700;
+KEYWORDS Keywords850;
+KEYWORDS Keywords200;
+
+
 /*
  *  Encode (tokenize) a program line for PB-700/FX-750P
  */
 int encode700( long line_number, char *line, char *buffer )
 {
-    unsigned int i, l, tl;
+    unsigned int i, l;
+    int k, tl;
     long ln = line_number;
     TOKEN *tp;
     bool transparent, in_string;
@@ -1773,13 +1787,9 @@ int encode700( long line_number, char *line, char *buffer )
                 /*
                  *  Look if a token is matched
                  */
-                for ( tp = Tokens700; tp->text != NULL; ++tp ) {
-                    tl = strlen( tp->text );
-                    if ( 0 == compare( line, tp->text, tl ) ) {
-                        break;
-                    }
-                }
-                if ( tp->text != NULL ) {
+                k = kwMatch( &Keywords700, line, &tl );
+                if ( k >= 0 ) {
+                    tp = Tokens700 + k;
                     /*
                      *  Replace string by token value
                      */
@@ -1815,7 +1825,8 @@ int encode700( long line_number, char *line, char *buffer )
  */
 int encode850_200( long line_number, char *line, char *buffer )
 {
-    unsigned int i, l, tl;
+    unsigned int l;
+    int k, tl;
     long ln = line_number;
     TOKEN *tp;
     bool transparent, in_string, binary;
@@ -1915,14 +1926,10 @@ int encode850_200( long line_number, char *line, char *buffer )
                 /*
                  *  Look if a token is matched
                  */
-                tp = Fp200 ? Tokens200 : Tokens850;
-                for ( ; tp->text != NULL; ++tp ) {
-                    tl = strlen( tp->text );
-                    if ( 0 == compare( line, tp->text, tl ) ) {
-                        break;
-                    }
-                }
-                if ( tp->text != NULL ) {
+                k = kwMatch( Fp200 ? &Keywords200 : &Keywords850, 
+                             line, &tl );
+                if ( k >= 0 ) {
+                    tp = ( Fp200 ? Tokens200 : Tokens850 ) + k;
                     /*
                      *  Replace string by prefix and token value
                      */
@@ -1970,268 +1977,145 @@ int encode850_200( long line_number, char *line, char *buffer )
 
 
 /*
- *  Main program
+ *  Handle an option
+ *  Options are allowed before the first source and between sources
  */
-int main( int argc, char *argv[] )
+void option( char *arg, int *baudrate )
 {
-    int err = 0;
-    int baudrate = 300;   /* default is slow */
-    int i, l, linecount;
-    long line_number, file_number = 0;
-    char *p, *buff, c;
-    char ext[ 4 ];
+    char *p;
 
-    ++argv;
-    --argc;
-
-    Header.file_type = TYPE_ASCII;
-
-    while ( argc > 0 && **argv == '-' ) {
-        /*
-         *  Options
-         */
-        if ( strncmp( *argv, "-b", 2 ) == 0 ) {
-            OutputMode = MODE_BIN;
-        }
-        if ( strncmp( *argv, "-a", 2 ) == 0 ) {
-            OutputMode = MODE_ASCII;
-        }
-        if ( strncmp( *argv, "-s", 2 ) == 0 
-          || strncmp( *argv, "-w", 2 ) == 0 ) 
-        {
-            OutputMode = MODE_WAVE;
-            baudrate = 300;
-        }
-        if ( strncmp( *argv, "-f", 2 ) == 0 ) {
-            OutputMode = MODE_WAVE;
-            baudrate = 1200;
-        }
-        if ( strncmp( *argv, "-2", 2 ) == 0 ) {
-            Fp200 = TRUE;
+    if ( strncmp( arg, "-b", 2 ) == 0 ) {
+        OutputMode = MODE_BIN;
+    }
+    if ( strncmp( arg, "-a", 2 ) == 0 ) {
+        OutputMode = MODE_ASCII;
+    }
+    if ( strncmp( arg, "-s", 2 ) == 0 
+      || strncmp( arg, "-w", 2 ) == 0 ) 
+    {
+        OutputMode = MODE_WAVE;
+        *baudrate = 300;
+    }
+    if ( strncmp( arg, "-f", 2 ) == 0 ) {
+        OutputMode = MODE_WAVE;
+        *baudrate = 1200;
+    }
+    if ( strncmp( arg, "-2", 2 ) == 0 ) {
+        Fp200 = TRUE;
+        AsciiLargeBlocks = TRUE;
+    }
+    if ( strncmp( arg, "-t", 2 ) == 0 ) {
+        switch ( toupper( arg[ 2 ] ) ) {
+        case 'B':
             AsciiLargeBlocks = TRUE;
+        case 'A':
+            Header.file_type = TYPE_ASCII;
+            break;
+        case '7':
+            Header.file_type = TYPE_PROGRAM;
+            PbEscapes = TRUE;
+            break;
+        case '8':
+            Header.file_type = TYPE_PROG850;
+            break;
+        case '2':
+            Header.file_type = TYPE_PROG850;
+            Fp200 = TRUE;
+            break;
+        case 'T':
+        case '\0':
+            Header.file_type = TYPE_TEXT;
+            OutputMode = MODE_TEXT;
+            break;
         }
-        if ( strncmp( *argv, "-t", 2 ) == 0 ) {
-            switch ( toupper( (*argv)[ 2 ] ) ) {
-            case 'B':
-                AsciiLargeBlocks = TRUE;
-            case 'A':
-                Header.file_type = TYPE_ASCII;
-                break;
-            case '7':
-                Header.file_type = TYPE_PROGRAM;
-                PbEscapes = TRUE;
-                break;
-            case '8':
-                Header.file_type = TYPE_PROG850;
-                break;
-            case '2':
-                Header.file_type = TYPE_PROG850;
-                Fp200 = TRUE;
-                break;
-            case 'T':
-            case '\0':
-                Header.file_type = TYPE_TEXT;
-                OutputMode = MODE_TEXT;
-                break;
-            }
-        }
-        if ( strncmp( *argv, "-d", 2 ) == 0 ) {
-            Header.file_type = TYPE_DATA;
-            LeadInTime = atoi( *argv + 2 );
-            if ( LeadInTime <= 0 ) {
-                LeadInTime = 0;
-            }
-            p = strchr( *argv + 2, ',' );
-            if ( p != NULL ) {
-                DataLines = atoi( p + 1 );
-                if ( DataLines == 0 && p[ 1 ] == 'B' ) {
-                    AsciiLargeBlocks = TRUE;
-                }
-            }
-        }
-        if ( strncmp( *argv, "-u", 2 ) == 0 ) {
-            switch ( toupper( (*argv)[ 2 ] ) ) {
-            case 'F':
-                Utf8Mode = UTF8_FX; 
-                break;
-            case 'P':
-                Utf8Mode = UTF8_PB; 
-                break;
-            case '\0':
-                Uppercase = TRUE;
-                Lowercase = FALSE;
-                break;
-            }
-        }
-        if ( strncmp( *argv, "-l", 2 ) == 0 ) {
-            switch ( toupper( (*argv)[ 2 ] ) ) {
-            case 'F':
-                LogarithmMode = LOG_FX; 
-                break;
-            case 'P':
-                LogarithmMode = LOG_PB; 
-                break;
-            case '\0':
-                Uppercase = FALSE;
-                Lowercase = TRUE;
-                break;
-            }
+    }
+    if ( strncmp( arg, "-d", 2 ) == 0 ) {
+        Header.file_type = TYPE_DATA;
+        DataDelay = atoi( arg + 2 );
+        if ( DataDelay <= 0 ) {
+            DataDelay = 0;
         }
-        if ( strncmp( *argv, "-e", 2 ) == 0 ) {
-            switch ( toupper( (*argv)[ 2 ] ) ) {
-            case 'F':
-                PbEscapes = FALSE; 
-                break;
-            case 'P':
-                PbEscapes = TRUE; 
-                break;
+        p = strchr( arg + 2, ',' );
+        if ( p != NULL ) {
+            DataLines = atoi( p + 1 );
+            if ( DataLines == 0 && p[ 1 ] == 'B' ) {
+                AsciiLargeBlocks = TRUE;
             }
         }
-        if ( strncmp( *argv, "-o", 2 ) == 0 ) {
-            Translate = TRUE;
+    }
+    if ( strncmp( arg, "-u", 2 ) == 0 ) {
+        switch ( toupper( arg[ 2 ] ) ) {
+        case 'F':
+            Utf8Mode = UTF8_FX; 
+            break;
+        case 'P':
+            Utf8Mode = UTF8_PB; 
+            break;
+        case '\0':
+            Uppercase = TRUE;
+            Lowercase = FALSE;
+            break;
         }
-        ++argv;
-        --argc;
     }
-    if ( Lowercase || baudrate != 300 || OutputMode == MODE_TEXT
-         || AsciiLargeBlocks ) 
-    {
-        JisBasic = TRUE;
+    if ( strncmp( arg, "-l", 2 ) == 0 ) {
+        switch ( toupper( arg[ 2 ] ) ) {
+        case 'F':
+            LogarithmMode = LOG_FX; 
+            break;
+        case 'P':
+            LogarithmMode = LOG_PB; 
+            break;
+        case '\0':
+            Uppercase = FALSE;
+            Lowercase = TRUE;
+            break;
+        }
     }
-    if ( Fp200 ) {
-        baudrate = 300;
+    if ( strncmp( arg, "-e", 2 ) == 0 ) {
+        switch ( toupper( arg[ 2 ] ) ) {
+        case 'F':
+            PbEscapes = FALSE; 
+            break;
+        case 'P':
+            PbEscapes = TRUE; 
+            break;
+        }
     }
-    if ( LeadInTime == 0 ) {
-        LeadInTime = Fp200 || AsciiLargeBlocks     ? LEAD_IN_TIME_FP200 
-                   : Header.file_type == TYPE_DATA ? LEAD_IN_TIME_DATA
-                                                   : LEAD_IN_TIME;
+    if ( strncmp( arg, "-o", 2 ) == 0 ) {
+        Translate = TRUE;
     }
+}
 
-    if ( argc < 1 ) {
-        printf(
-         "usage: bas850 <options> infile outfile\n"
-         "         -a create an ASCII encoded file for Piotr's interface\n"
-         "         -b create a binary file\n"
-         "         -w or -s create a 300 baud WAV file "
-                   "(slow: PB-700, FX-750P)\n"
-         "         -f create a 1200 baud WAV file "
-                      "(fast: FX-850P, PB-1000)\n"
-         "         -2 create FP-200 compatible file\n"
-         "         -t[T|A|B|2|7|8] select type of output\n"
-         "           T: plain text for download via serial or USB interface\n"
-         "           A: SAVE,A output; load with LOAD,A on PB-700/FX-750P/FX-850P\n"
-         "           B: same as -A but creates large blocks: FP-200/FX-850P only\n"
-         "           2: internal format for FP-200\n"
-         "           7: internal format for PB-700 family\n" 
-         "           8: internal format for FX-850P/PB-1000 family\n"
-         "         -d<delay>,<count> process data file instead of BASIC code\n"
-         "           <delay> adjusts the time between data lines\n"
-         "           Start with 20 (default) and increase in case of difficulty\n"
-         "           <count> inserts a new file header each <count> data lines\n"
-         "           This must equal the number of items read by a PB-700 GET statement\n"
-         "         -e[F|P] backslash escape syntax used\n"
-         "           F: FX-850P/VX/Z extended character set\n"
-         "           P: PB-700/PB-1000/FP-200 graphics character set\n"
-         "         -l[F|P] handling of LOG/LN versus LGT/LOG\n"
-         "           F: convert to FX-850P/VX/Z logarithm syntax LOG and LN\n"
-         "              use with -t8 to translate PB-1000 programs\n" 
-         "           P: convert to PB-700/PB-1000/FP-200 logarithm syntax LGT and LOG\n"
-         "         -l allow lowercase keywords and variables "
-                      "for FX-850P/PB-1000/FP-200\n"
-         "         -u[F|P] enable Unicode (UTF-8) input\n"
-         "           F: FX-850P/VX/Z extended character set\n"
-         "           P: PB-700/PB-1000/FP-200 graphics character set\n"
-         "         -u make everything uppercase for FX-750P\n"
-         "         -o replace old style keywords like PRT, VAC or CSR\n" 
-        );
-        return 2;
-    }
+
+/*
+ *  Convert a single source file and append it to the output
+ *  name is used for the file name in the tape header
+ *  Returns 0 when OK or the error code
+ */
+int convert( char *source, char *name, int baudrate, bool last )
+{
+    int err = 0;
+    int i, l, linecount;
+    long line_number, file_number = 0;
+    char *p, *buff;
+    char ext[ 4 ];
+
+    JisBasic = Lowercase || baudrate != 300 || OutputMode == MODE_TEXT
+            || AsciiLargeBlocks;
+
+    LeadInTime = DataDelay > 0                  ? DataDelay
+               : Fp200 || AsciiLargeBlocks     ? LEAD_IN_TIME_FP200 
+               : Header.file_type == TYPE_DATA ? LEAD_IN_TIME_DATA
+                                               : LEAD_IN_TIME;
 
     /*
      *  Open input file
      */
-    if ( ( FileIn = fopen( *argv, "rt" ) ) == NULL ) {
+    if ( ( FileIn = fopen( source, "rt" ) ) == NULL ) {
         fprintf( stderr, "Cannot open input file\n" );
-        perror( *argv );
-        return 2;
-    }
-    ++argv;
-    --argc;
-
-    /*
-     *  Output file
-     */
-    if ( argc < 1 && OutputMode != MODE_TEXT ) {
-        fprintf( stderr, "Missing output file name\n" );
+        perror( source );
         return 2;
     }
-
-    switch ( OutputMode ) {
-        
-    case MODE_BIN:
-        /*
-         *  Open output file in binary mode
-         */
-        FileOut = fopen( *argv, "wb" );
-        if ( NULL == FileOut ) {
-            fprintf( stderr, "Cannot open binary output file %s\n", *argv );
-            perror( *argv );
-            return 2;
-        }
-        printf( "Creating binary file %s\n", *argv );
-        break;
-
-    case MODE_ASCII:
-        /*
-         *  Open output file in text mode
-         */
-        FileOut = fopen( *argv, "wt" );
-        if ( NULL == FileOut ) {
-            fprintf( stderr, "Cannot open ASCII output file %s\n", *argv );
-            perror( *argv );
-            return 2;
-        }
-        printf( "Creating ASCII file %s\n", *argv );
-        break;
-
-    case MODE_WAVE:
-        /*
-         *  Open the output WAV file
-         */
-        WaveOut = kcsOpen( *argv, "wb", baudrate, 8, 'E', 2 );
-        if ( NULL == WaveOut ) {
-            /*
-             *  I/O error
-             */
-            fprintf( stderr, "Cannot open wave output file %s\n", *argv );
-            if ( errno != 0 ) {
-                perror( *argv );
-            }
-            return 2;
-        }
-        printf( "Creating wave file %s at %d baud\n", *argv, baudrate );
-        break;
-
-    case MODE_TEXT:
-        /*
-         *  Open output file in binary mode for plain text output
-         *  Except for piping
-         */
-        if ( argc < 1 ) {
-            FileOut = stdout;
-        }
-        else {
-            FileOut = fopen( *argv, "wb" );
-            if ( NULL == FileOut ) {
-                fprintf( stderr, "Cannot open text output file %s\n", *argv );
-                perror( *argv );
-                return 2;
-            }
-            printf( "Creating text file %s\n", *argv );
-        }
-        break;
-    }
-
     switch ( Header.file_type ) {
 
     case TYPE_ASCII:
@@ -2285,25 +2169,25 @@ int main( int argc, char *argv[] )
 
     if ( OutputMode != MODE_TEXT ) {
         /*
-         *  Filename = basename of output file + "TXT", "BAS" or "DAT" extension
+         *  Filename = basename of output or source file + "TXT", "BAS" or "DAT" extension
          */
         memset( Header.file_name, ' ', 8 + 3 );
-        p = strrchr( *argv, '/' );
+        p = strrchr( name, '/' );
         if ( p != NULL ) {
             ++p;
         }
         else {
-            p = strrchr( *argv, '\\' );
+            p = strrchr( name, '\\' );
             if ( p != NULL ) {
                 ++p;
             }
             else {
-                p = strrchr( *argv, ':' );
+                p = strrchr( name, ':' );
                 if ( p != NULL ) {
                     ++p;
                 }
                 else {
-                    p = *argv;
+                    p = name;
                 }
             }
         }
@@ -2329,15 +2213,6 @@ int main( int argc, char *argv[] )
         memset( Header.parameters, 0, 12 );
     }
 
-    /*
-     *  Allocate Data area
-     */
-    Data = malloc( sizeof( struct _data ) );
-    if ( Data == NULL ) {
-        perror( "Allocate memory for data area" );
-        return 3;
-    }
-
     /*
      *  Process file
      */
@@ -2624,15 +2499,16 @@ int main( int argc, char *argv[] )
         break;
     }
 
-    if ( err == 0 ) {
+    if ( err == 0 && ( last || OutputMode != MODE_TEXT ) ) {
         /*
          *  Send a special termination to the file if neccessary
+         *  This also starts the next file with a long lead-in
          */
         err = output( EOF );
     }
 
     /*
-     *  Check for errors and close files
+     *  Check for errors
      */
     if ( err == 0 && linecount == 0 && Header.file_type != TYPE_DATA ) {
         /*
@@ -2642,10 +2518,230 @@ int main( int argc, char *argv[] )
     }
 
     if ( err == 2 ) {
-        perror( *argv );
+        perror( name );
     }
     else if ( err != 0 ) {
-        fprintf( stderr, "Error encountered: %s\n", err_msg[ err ] );
+        fprintf( stderr, "Error encountered in %s: %s\n", 
+                 source, err_msg[ err ] );
+    }
+
+    fclose( FileIn );
+    FileIn = NULL;
+
+    return err;
+}
+
+
+int main( int argc, char *argv[] )
+{
+    int err = 0;
+    int baudrate = 300;   /* default is slow */
+    int i, sources, mode, rate;
+    bool single;
+    char *name;
+
+    ++argv;
+    --argc;
+
+    /*
+     *  Index the keyword tables
+     */
+    if ( kwBuild( &Keywords700, Tokens700, sizeof( TOKEN ), TRUE ) != 0
+      || kwBuild( &Keywords850, Tokens850, sizeof( TOKEN ), TRUE ) != 0
+      || kwBuild( &Keywords200, Tokens200, sizeof( TOKEN ), TRUE ) != 0 ) 
+    {
+        perror( "error" );
+        return 2;
+    }
+
+    Header.file_type = TYPE_ASCII;
+
+    while ( argc > 0 && **argv == '-' ) {
+        /*
+         *  Options
+         */
+        option( *argv, &baudrate );
+        ++argv;
+        --argc;
+    }
+
+    if ( argc < 1 ) {
+        printf(
+         "usage: bas850 <options> infile [[<options>] infile ...] outfile\n"
+         "         -a create an ASCII encoded file for Piotr's interface\n"
+         "         -b create a binary file\n"
+         "         -w or -s create a 300 baud WAV file "
+                   "(slow: PB-700, FX-750P)\n"
+         "         -f create a 1200 baud WAV file "
+                      "(fast: FX-850P, PB-1000)\n"
+         "         -2 create FP-200 compatible file\n"
+         "         -t[T|A|B|2|7|8] select type of output\n"
+         "           T: plain text for download via serial or USB interface\n"
+         "           A: SAVE,A output; load with LOAD,A on PB-700/FX-750P/FX-850P\n"
+         "           B: same as -A but creates large blocks: FP-200/FX-850P only\n"
+         "           2: internal format for FP-200\n"
+         "           7: internal format for PB-700 family\n" 
+         "           8: internal format for FX-850P/PB-1000 family\n"
+         "         -d<delay>,<count> process data file instead of BASIC code\n"
+         "           <delay> adjusts the time between data lines\n"
+         "           Start with 20 (default) and increase in case of difficulty\n"
+         "           <count> inserts a new file header each <count> data lines\n"
+         "           This must equal the number of items read by a PB-700 GET statement\n"
+         "         -e[F|P] backslash escape syntax used\n"
+         "           F: FX-850P/VX/Z extended character set\n"
+         "           P: PB-700/PB-1000/FP-200 graphics character set\n"
+         "         -l[F|P] handling of LOG/LN versus LGT/LOG\n"
+         "           F: convert to FX-850P/VX/Z logarithm syntax LOG and LN\n"
+         "              use with -t8 to translate PB-1000 programs\n" 
+         "           P: convert to PB-700/PB-1000/FP-200 logarithm syntax LGT and LOG\n"
+         "         -l allow lowercase keywords and variables "
+                      "for FX-850P/PB-1000/FP-200\n"
+         "         -u[F|P] enable Unicode (UTF-8) input\n"
+         "           F: FX-850P/VX/Z extended character set\n"
+         "           P: PB-700/PB-1000/FP-200 graphics character set\n"
+         "         -u make everything uppercase for FX-750P\n"
+         "         -o replace old style keywords like PRT, VAC or CSR\n" 
+         "       Several sources are written to a single tape, each with a\n"
+         "       header named after the source. Options between the sources\n"
+         "       change the type of the following sources.\n"
+        );
+        return 2;
+    }
+
+    /*
+     *  The last argument is the output file
+     *  It may be omitted for plain text output
+     */
+    if ( argc > 1 ) {
+        name = argv[ --argc ];
+    }
+    else if ( OutputMode == MODE_TEXT ) {
+        name = NULL;
+    }
+    else {
+        fprintf( stderr, "Missing output file name\n" );
+        return 2;
+    }
+    for ( sources = 0, i = 0; i < argc; ++i ) {
+        if ( *argv[ i ] != '-' ) {
+            ++sources;
+        }
+    }
+    if ( sources == 0 ) {
+        fprintf( stderr, "Missing input file name\n" );
+        return 2;
+    }
+    single = sources == 1;
+
+    switch ( OutputMode ) {
+        
+    case MODE_BIN:
+        /*
+         *  Open output file in binary mode
+         */
+        FileOut = fopen( name, "wb" );
+        if ( NULL == FileOut ) {
+            fprintf( stderr, "Cannot open binary output file %s\n", name );
+            perror( name );
+            return 2;
+        }
+        printf( "Creating binary file %s\n", name );
+        break;
+
+    case MODE_ASCII:
+        /*
+         *  Open output file in text mode
+         */
+        FileOut = fopen( name, "wt" );
+        if ( NULL == FileOut ) {
+            fprintf( stderr, "Cannot open ASCII output file %s\n", name );
+            perror( name );
+            return 2;
+        }
+        printf( "Creating ASCII file %s\n", name );
+        break;
+
+    case MODE_WAVE:
+        /*
+         *  Open the output WAV file
+         */
+        WaveOut = kcsOpen( name, "wb", Fp200 ? 300 : baudrate, 8, 'E', 2 );
+        if ( NULL == WaveOut ) {
+            /*
+             *  I/O error
+             */
+            fprintf( stderr, "Cannot open wave output file %s\n", name );
+            if ( errno != 0 ) {
+                perror( name );
+            }
+            return 2;
+        }
+        printf( "Creating wave file %s at %d baud\n", name,
+                Fp200 ? 300 : baudrate );
+        break;
+
+    case MODE_TEXT:
+        /*
+         *  Open output file in binary mode for plain text output
+         *  Except for piping
+         */
+        if ( name == NULL ) {
+            FileOut = stdout;
+        }
+        else {
+            FileOut = fopen( name, "wb" );
+            if ( NULL == FileOut ) {
+                fprintf( stderr, "Cannot open text output file %s\n", name );
+                perror( name );
+                return 2;
+            }
+            printf( "Creating text file %s\n", name );
+        }
+        break;
+    }
+
+    /*
+     *  Allocate Data area
+     */
+    Data = malloc( sizeof( struct _data ) );
+    if ( Data == NULL ) {
+        perror( "Allocate memory for data area" );
+        return 3;
+    }
+
+    /*
+     *  Process the sources in the given order
+     */
+    for ( ; err == 0 && argc > 0; ++argv, --argc ) {
+
+        if ( **argv == '-' ) {
+            /*
+             *  Options between sources may not change the output format
+             */
+            mode = OutputMode;
+            rate = baudrate;
+            option( *argv, &baudrate );
+            if ( OutputMode != mode || baudrate != rate ) {
+                fprintf( stderr, "Option %s ignored after the first source\n",
+                         *argv );
+                OutputMode = mode;
+                baudrate = rate;
+            }
+            continue;
+        }
+        if ( single ) {
+            /*
+             *  Tape file is named after the output file
+             */
+            err = convert( *argv, name, baudrate, TRUE );
+        }
+        else {
+            /*
+             *  Tape files are named after the sources
+             */
+            printf( "Adding %s\n", *argv );
+            err = convert( *argv, *argv, baudrate, --sources == 0 );
+        }
     }
 
     if ( WaveOut != NULL ) {
@@ -2654,7 +2750,6 @@ int main( int argc, char *argv[] )
     if ( FileOut != NULL ) {
         fclose( FileOut );
     }
-    fclose( FileIn );
 
     return err != 0 ? 2 : 0;
 }
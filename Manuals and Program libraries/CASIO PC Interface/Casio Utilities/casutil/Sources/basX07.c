@@ -16,6 +16,7 @@
 #include <errno.h>
 #include "bool.h"
 #include "wave.h"
+#include "keyword.h"
 #ifdef __unix__
 #include <unistd.h>
 #else
@@ -940,12 +941,19 @@ long read_line( char *buffer, int *err )
 }
 
 
+/*
+ *  Keyword indexes of the token tables
+ */
+KEYWORDS Keywords;
+
+
 /*
  *  Encode (tokenize) a program line
  */
 int encode( long line_number, char *line, char *buffer )
 {
-    unsigned int i, l, tl;
+    unsigned int l;
+    int k, tl;
     char *lp = buffer;
     TOKEN *tp;
     bool transparent, in_string;
@@ -986,13 +994,9 @@ int encode( long line_number, char *line, char *buffer )
                 /*
                  *  Look if a token is matched
                  */
-                for ( tp = tokens; tp->text != NULL; ++tp ) {
-                    tl = strlen( tp->text );
-                    if ( 0 == compare( line, tp->text, tl ) ) {
-                        break;
-                    }
-                }
-                if ( tp->text != NULL ) {
+                k = kwMatch( &Keywords, line, &tl );
+                if ( k >= 0 ) {
+                    tp = tokens + k;
                     /*
                      *  Replace string by token value
                      */
@@ -1059,6 +1063,15 @@ int main( int argc, char *argv[] )
     ++argv;
     --argc;
 
+    /*
+     *  Index the keyword tables
+     */
+    if ( kwBuild( &Keywords, tokens, sizeof( TOKEN ), TRUE ) != 0 ) 
+    {
+        perror( "error" );
+        return 2;
+    }
+
     while ( argc > 0 && **argv == '-' ) {
         /*
          *  Options
@@ -0,0 +1,139 @@
+/*
+ *  bcd.c
+ *
+ *  BCD number formatting shared by the listing programs
+ *
+ *  Each BCD byte is converted to its two characters through a table
+ *  which is built on first use. Mantissas are expanded in one go, the
+ *  decimal point is inserted while copying.
+ */
+#include <string.h>
+#include "bcd.h"
+
+/*
+ *  Two characters per byte
+ */
+static char Pairs[ 256 ][ 2 ];
+static int Initialized = 0;
+
+
+/*
+ *  Build the table
+ */
+static void bcdInit( void )
+{
+    static const char hex[] = "0123456789ABCDEF";
+    int c;
+
+    for ( c = 0; c < 256; ++c ) {
+        Pairs[ c ][ 0 ] = hex[ c >> 4 ];
+        Pairs[ c ][ 1 ] = hex[ c & 0x0F ];
+    }
+    Initialized = 1;
+}
+
+
+/*
+ *  Convert a BCD coded byte to binary
+ */
+int bcd2bin( int c )
+{
+    int x;
+    x = c / 16;
+    return c - 6 * x;
+}
+
+
+/*
+ *  Format a mantissa
+ */
+char *bcdMantissa( char *dest, const unsigned char *bcd, int step,
+                   int count, int *exp, int fixed )
+{
+    char digits[ 2 * 32 ];
+    char *p = digits;
+    int i, n, point;
+
+    if ( !Initialized ) {
+        bcdInit();
+    }
+    if ( count > 31 ) {
+        count = 31;
+    }
+
+    /*
+     *  All digits without point
+     */
+    *p++ = Pairs[ *bcd ][ 0 ];
+    for ( i = 0; i < count; ++i ) {
+        bcd += step;
+        memcpy( p, Pairs[ *bcd ], 2 );
+        p += 2;
+    }
+    n = (int) ( p - digits );
+
+    /*
+     *  Strip trailing zeros
+     */
+    point = 1;
+    if ( *exp > 0 && *exp <= fixed && *exp < n ) {
+        point += *exp;
+        *exp = 0;
+    }
+    while ( n > point && digits[ n - 1 ] == '0' ) {
+        --n;
+    }
+
+    /*
+     *  Copy with decimal point
+     */
+    memcpy( dest, digits, point );
+    dest += point;
+    if ( n > point ) {
+        *dest++ = '.';
+        memcpy( dest, digits + point, n - point );
+        dest += n - point;
+    }
+    *dest = '\0';
+    return dest;
+}
+
+
+/*
+ *  Format a non negative decimal number with at least width digits
+ */
+char *bcdDecimal( char *dest, int value, int width )
+{
+    char buffer[ 12 ];
+    char *p = buffer + sizeof( buffer );
+    int n;
+
+    if ( !Initialized ) {
+        bcdInit();
+    }
+    do {
+        /*
+         *  Two digits at a time, the table is valid for 00 to 99
+         */
+        n = value % 100;
+        value /= 100;
+        p -= 2;
+        memcpy( p, Pairs[ n + 6 * ( n / 10 ) ], 2 );
+    } while ( value != 0 );
+
+    if ( *p == '0' && p < buffer + sizeof( buffer ) - 1 ) {
+        /*
+         *  Odd number of digits
+         */
+        ++p;
+    }
+    n = (int) ( buffer + sizeof( buffer ) - p );
+    while ( n < width ) {
+        *dest++ = '0';
+        --width;
+    }
+    memcpy( dest, p, n );
+    dest += n;
+    *dest = '\0';
+    return dest;
+}
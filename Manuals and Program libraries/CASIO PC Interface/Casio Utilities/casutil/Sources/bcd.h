@@ -0,0 +1,33 @@
+/*
+ *  bcd.h
+ *
+ *  Entry points of bcd.c
+ *
+ *  BCD number formatting shared by the listing programs
+ *
+ *  The functions write into a caller supplied buffer and return a
+ *  pointer to the terminating '\0'. Nibbles which are no valid BCD digits
+ *  are written as hex digits, just like printf( "%02X" ) would do.
+ */
+
+/*
+ *  Convert a BCD coded byte to binary
+ */
+extern int bcd2bin( int c );
+
+/*
+ *  Format a mantissa
+ *
+ *  The first digit is the high nibble of *bcd, followed by count digit
+ *  pairs in bcd[ step ], bcd[ 2 * step ], ...
+ *  The decimal point is placed after the first digit. If *exp is in the
+ *  range 1 to fixed, the point is moved *exp places to the right and
+ *  *exp is set to 0. Trailing zeros and a trailing point are dropped.
+ */
+extern char *bcdMantissa( char *dest, const unsigned char *bcd, int step,
+                          int count, int *exp, int fixed );
+
+/*
+ *  Format a non negative decimal number with at least width digits
+ */
+extern char *bcdDecimal( char *dest, int value, int width );
@@ -0,0 +1,558 @@
+/*
+ *  casutil.c - All Casio utilities in a single program
+ *
+ *  The tools are compiled with their main() renamed to <tool>_main and
+ *  all other symbols made local (see Makefile), so they can be linked
+ *  into one executable with a single copy of wave.o.
+ *
+ *  Usage:
+ *    casutil <tool> <options> ...
+ *    <tool> <options> ...         (casutil linked or copied as <tool>)
+ *
+ *  Pipelines:
+ *    casutil <tool> <options> @ + <tool> <options> @ [+ ...]
+ *
+ *    The stages are connected by pipes, no intermediate files are
+ *    created. In each stage "@" stands for the pipe, the first "@" of a
+ *    stage is its input (if it has a predecessor), the next one its output.
+ *    The standard output of all stages but the last is redirected to
+ *    standard error, so the last stage alone writes to standard output.
+ *    Pipes cannot be seeked, so WAV files can only be read from a pipe,
+ *    not written to it.
+ *
+ *    Example:
+ *      casutil wav2raw -f -b tape.wav @ + list850 -b @
+ *
+ *  Automatic model detection:
+ *    casutil auto <options> file.wav
+ *
+ *    The first seconds of the tape are decoded with all supported baud
+ *    rates and formats concurrently. The first decoder which finds a
+ *    header known to one of the list programs wins and the file is
+ *    passed to that program, together with <options>.
+ *
+ *  Written by Marcus von Cube
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __unix__
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <pthread.h>
+#endif
+#include "wave.h"
+
+/*
+ *  The renamed main functions of the tools
+ */
+typedef int TOOL_MAIN( int argc, char **argv );
+
+extern TOOL_MAIN wav2raw_main, wav2wav_main;
+extern TOOL_MAIN wave730_main, wave850_main, waveX07_main;
+extern TOOL_MAIN list702_main, list730_main, list850_main, list8000_main;
+extern TOOL_MAIN listX07_main, list74_main;
+extern TOOL_MAIN bas702_main, bas730_main, bas850_main, basX07_main;
+extern TOOL_MAIN md100_main;
+
+struct _tool {
+    char *name;
+    TOOL_MAIN *fn;
+    char *description;
+} Tools[] =
+{
+    { "wav2raw",  wav2raw_main,  "decode a KCS wave file" },
+    { "wav2wav",  wav2wav_main,  "clean up or convert a KCS wave file" },
+    { "wave730",  wave730_main,  "binary to wave, PB-100/FX-700P/FX-730P" },
+    { "wave850",  wave850_main,  "binary to wave, PB-700/FX-850P/PB-1000" },
+    { "waveX07",  waveX07_main,  "binary to wave, Canon X-07" },
+    { "list702",  list702_main,  "list FX-702P programs" },
+    { "list730",  list730_main,  "list PB-100/FX-700P/FX-730P programs" },
+    { "list850",  list850_main,  "list PB-700/FX-850P/PB-1000 programs" },
+    { "list8000", list8000_main, "list fx-8000G programs" },
+    { "listX07",  listX07_main,  "list Canon X-07 programs" },
+    { "list74",   list74_main,   "list TI-74 programs" },
+    { "bas702",   bas702_main,   "tokenize FX-702P programs" },
+    { "bas730",   bas730_main,   "tokenize PB-100/FX-700P/FX-730P programs" },
+    { "bas850",   bas850_main,   "tokenize PB-700/FX-850P/PB-1000 programs" },
+    { "basX07",   basX07_main,   "tokenize Canon X-07 programs" },
+    { "md100",    md100_main,    "handle MD-100 disk images" },
+    { NULL,       NULL,          NULL }
+};
+
+#define PIPE_ARG  "@"
+#define PIPE_SEP  "+"
+
+/*
+ *  Automatic detection: decode at most DETECT_TIME milliseconds
+ *  and DETECT_BYTES data bytes per candidate
+ */
+#define DETECT_TIME  30000
+#define DETECT_BYTES 24
+
+typedef struct _candidate {
+    /*
+     *  Decoder parameters
+     */
+    int baud;
+    int bits;
+    char parity;
+    int stopbits;
+    /*
+     *  Recognizer, returns the offset of the header or -1
+     */
+    int ( *recognize )( struct _candidate *cp );
+    /*
+     *  Lister and its option
+     */
+    char *tool;
+    char *option;
+    char *model;
+    /*
+     *  Results
+     */
+    char *filename;
+    unsigned char data[ DETECT_BYTES ];
+    uint32_t where[ DETECT_BYTES ];
+    int count;
+    uint32_t found;
+} CANDIDATE;
+
+
+/*
+ *  Find a tool by name
+ */
+struct _tool *findTool( char *name )
+{
+    struct _tool *tp;
+    char *p;
+
+    /*
+     *  Strip path and extension
+     */
+    for ( p = name; *p != '\0'; ++p ) {
+        if ( *p == '/' || *p == '\\' ) {
+            name = p + 1;
+        }
+    }
+    for ( tp = Tools; tp->name != NULL; ++tp ) {
+        if ( 0 == strncmp( name, tp->name, strlen( tp->name ) )
+          && ( name[ strlen( tp->name ) ] == '\0'
+            || name[ strlen( tp->name ) ] == '.' ) )
+        {
+            return tp;
+        }
+    }
+    return NULL;
+}
+
+
+/*
+ *  Print usage information
+ */
+int usage( void )
+{
+    struct _tool *tp;
+
+    printf( "usage: casutil <tool> <options> ...\n"
+            "       casutil <tool> <options> @ + <tool> <options> @ ...\n"
+            "         @ is replaced by the pipe between two stages\n"
+            "       casutil auto <options> infile\n"
+            "         detects the model and runs the matching list program\n"
+            "       tools are:\n" );
+    for ( tp = Tools; tp->name != NULL; ++tp ) {
+        printf( "         %-9s %s\n", tp->name, tp->description );
+    }
+    return 2;
+}
+
+
+#ifdef __unix__
+/*
+ *  Run a pipeline of tools, argv is terminated by NULL
+ */
+int pipeline( char **argv )
+{
+    static char names[ 2 ][ 20 ];
+    char **stage;
+    char **p;
+    struct _tool *tp;
+    int in = -1;
+    int fd[ 2 ];
+    int last;
+    int count = 0;
+    int rc = 0;
+    int status;
+    pid_t pid;
+
+    while ( *argv != NULL ) {
+        /*
+         *  Isolate the next stage
+         */
+        stage = argv;
+        while ( *argv != NULL && 0 != strcmp( *argv, PIPE_SEP ) ) {
+            ++argv;
+        }
+        last = *argv == NULL;
+        if ( !last ) {
+            *argv++ = NULL;
+        }
+
+        tp = findTool( *stage );
+        if ( tp == NULL ) {
+            fprintf( stderr, "casutil: unknown tool %s\n", *stage );
+            return usage();
+        }
+
+        if ( !last && 0 != pipe( fd ) ) {
+            perror( "pipe" );
+            return 2;
+        }
+
+        pid = fork();
+        if ( pid < 0 ) {
+            perror( "fork" );
+            return 2;
+        }
+        if ( pid == 0 ) {
+            /*
+             *  Child: replace the pipe placeholders and run the tool
+             */
+            int argc = 0;
+            int n = 0;
+
+            if ( in >= 0 ) {
+                sprintf( names[ n++ ], "/dev/fd/%d", in );
+            }
+            if ( !last ) {
+                close( fd[ 0 ] );
+                sprintf( names[ n++ ], "/dev/fd/%d", fd[ 1 ] );
+                dup2( 2, 1 );
+            }
+            for ( p = stage, n = 0; *p != NULL; ++p, ++argc ) {
+                if ( 0 == strcmp( *p, PIPE_ARG ) && n < 2 ) {
+                    *p = names[ n++ ];
+                }
+            }
+            exit( tp->fn( argc, stage ) );
+        }
+
+        /*
+         *  Parent: hand the read end to the next stage
+         */
+        ++count;
+        if ( in >= 0 ) {
+            close( in );
+        }
+        if ( !last ) {
+            close( fd[ 1 ] );
+            in = fd[ 0 ];
+        }
+    }
+
+    /*
+     *  Wait for all stages, report the first error
+     */
+    while ( count-- > 0 ) {
+        if ( wait( &status ) > 0 && rc == 0 ) {
+            rc = WIFEXITED( status ) ? WEXITSTATUS( status ) : 2;
+        }
+    }
+    return rc;
+}
+#endif
+
+
+/*
+ *  Recognizers for the tape headers of the list programs
+ *  They look at the first few data bytes only, leading garbage is skipped
+ */
+#define SEARCH 6
+
+/*
+ *  FX-702P: file id 0xD0..0xF0 and data segment 0x01 after the header
+ */
+int isFx702P( CANDIDATE *cp )
+{
+    int i;
+
+    for ( i = 0; i < SEARCH && i + 11 < cp->count; ++i ) {
+        if ( cp->data[ i ] >= 0xD0 && cp->data[ i + 11 ] == 0x01 ) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*
+ *  PB-100/FX-700P/FX-730P: file id 0x90..0xF0 and data segment 0x02
+ */
+int isFx730P( CANDIDATE *cp )
+{
+    int i;
+
+    for ( i = 0; i < SEARCH && i + 11 < cp->count; ++i ) {
+        if ( cp->data[ i ] >= 0x90 && cp->data[ i + 11 ] == 0x02 ) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*
+ *  PB-700/FX-850P/PB-1000/FP-200: 'H'eader segment with known file type
+ */
+int isPb700( CANDIDATE *cp )
+{
+    int i;
+
+    for ( i = 0; i < SEARCH && i + 1 < cp->count; ++i ) {
+        if ( cp->data[ i ] == 'H' 
+          && NULL != memchr( "\xD0\xC1\x30\x24\x10\x90",
+                             cp->data[ i + 1 ], 6 ) )
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*
+ *  fx-8000G: header segment 0x08 followed by the file name
+ */
+int isFx8000G( CANDIDATE *cp )
+{
+    int i;
+
+    for ( i = 0; i < SEARCH && i + 1 < cp->count; ++i ) {
+        if ( cp->data[ i ] == 0x08 
+          && cp->data[ i + 1 ] >= ' ' && cp->data[ i + 1 ] < 0x7F )
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*
+ *  Canon X-07: at least 8 sync bytes 0xD3
+ */
+int isX07( CANDIDATE *cp )
+{
+    int i, n;
+
+    for ( i = 0, n = 0; i < cp->count; ++i ) {
+        n = cp->data[ i ] == 0xD3 ? n + 1 : 0;
+        if ( n == 8 ) {
+            return i - 7;
+        }
+    }
+    return -1;
+}
+
+/*
+ *  TI-74: block start 0xFF followed by a full block
+ */
+int isTi74( CANDIDATE *cp )
+{
+    int i;
+
+    for ( i = 0; i < SEARCH && i + 8 < cp->count; ++i ) {
+        if ( cp->data[ i ] == 0xFF && cp->data[ i + 1 ] != 0xFF ) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+CANDIDATE Candidates[] =
+{
+    {   300, 8, 'E', 2, isFx702P,  "list702",  "-w",  "FX-702P" },
+    {   300, 8, 'E', 2, isFx730P,  "list730",  "-w",  "PB-100/FX-730P" },
+    {   300, 8, 'E', 2, isPb700,   "list850",  "-wS", "PB-700/FX-750P" },
+    {  1200, 8, 'E', 2, isPb700,   "list850",  "-wF", "FX-850P/PB-1000" },
+    {  2400, 8, 'E', 2, isPb700,   "list850",  "-wH", "PB-1000 (FA-7)" },
+    { -2400, 8, 'E', 2, isFx8000G, "list8000", "-w",  "fx-8000G" },
+    {  2400, 8, 'E', 2, isFx8000G, "list8000", "-w-", "fx-8000G" },
+    {  1200, 8, 'N', 2, isX07,     "listX07",  "-w",  "Canon X-07" },
+    {  1400, 8, 'N', 0, isTi74,    "list74",   "-w",  "TI-74" },
+    {     0, 0, 0,   0, NULL,      NULL,       NULL,  NULL }
+};
+
+
+/*
+ *  Decode the start of the tape for one candidate
+ */
+void *detect( void *arg )
+{
+    CANDIDATE *cp = (CANDIDATE *) arg;
+    KCS_FILE *wfp;
+    short c;
+    int i;
+
+    cp->count = 0;
+    cp->found = 0xFFFFFFFFul;
+
+    wfp = kcsOpen( cp->filename, "rb", cp->baud, cp->bits, cp->parity,
+                   cp->stopbits );
+    if ( wfp == NULL ) {
+        return NULL;
+    }
+    while ( cp->count < DETECT_BYTES && wtell( wfp->file ) < DETECT_TIME ) {
+
+        c = kcsReadByte( wfp );
+        if ( c < 0 ) {
+            break;
+        }
+        if ( c == KCS_LEAD_IN ) {
+            continue;
+        }
+        if ( c & ( KCS_PARITY | KCS_FRAMING ) ) {
+            /*
+             *  Wrong format, start over
+             */
+            cp->count = 0;
+            continue;
+        }
+        cp->where[ cp->count ] = wtell( wfp->file );
+        cp->data[ cp->count++ ] = (unsigned char) c;
+    }
+    kcsClose( wfp );
+
+    i = cp->recognize( cp );
+    if ( i >= 0 ) {
+        cp->found = cp->where[ i ];
+    }
+    return NULL;
+}
+
+
+/*
+ *  auto <options> <file.wav>
+ *
+ *  Detect the model and run the matching list program
+ */
+int autoList( int argc, char **argv )
+{
+    CANDIDATE *cp, *best = NULL;
+    struct _tool *tp;
+    char **args;
+    int i;
+#ifdef __unix__
+    pthread_t threads[ sizeof( Candidates ) / sizeof( Candidates[ 0 ] ) ];
+    int started[ sizeof( Candidates ) / sizeof( Candidates[ 0 ] ) ];
+#endif
+
+    if ( argc < 2 ) {
+        printf( "usage: casutil auto <options> infile > outfile\n"
+                "         detects the model and passes the WAV file and\n"
+                "         <options> to the matching list program\n" );
+        return 2;
+    }
+
+    /*
+     *  Run all decoders concurrently, they read only the start of the
+     *  tape and would hash the whole file for the cache in vain
+     */
+    kcsUseCache( 0 );
+    for ( cp = Candidates, i = 0; cp->tool != NULL; ++cp, ++i ) {
+        cp->filename = argv[ argc - 1 ];
+#ifdef __unix__
+        started[ i ] = 0 == pthread_create( threads + i, NULL, detect, cp );
+        if ( !started[ i ] ) {
+            detect( cp );
+        }
+#else
+        detect( cp );
+#endif
+    }
+
+    /*
+     *  The earliest header found wins
+     */
+    for ( cp = Candidates, i = 0; cp->tool != NULL; ++cp, ++i ) {
+#ifdef __unix__
+        if ( started[ i ] ) {
+            pthread_join( threads[ i ], NULL );
+        }
+#endif
+        if ( cp->found != 0xFFFFFFFFul
+          && ( best == NULL || cp->found < best->found ) )
+        {
+            best = cp;
+        }
+    }
+    kcsUseCache( 1 );
+    if ( best == NULL ) {
+        fprintf( stderr, "%s: no known tape format found\n",
+                 argv[ argc - 1 ] );
+        return 2;
+    }
+    fprintf( stderr, "%s: %s tape, using %s %s\n", argv[ argc - 1 ],
+             best->model, best->tool, best->option );
+
+    /*
+     *  Build the command line for the list program
+     */
+    args = malloc( ( argc + 2 ) * sizeof( char * ) );
+    if ( args == NULL ) {
+        perror( "casutil" );
+        return 2;
+    }
+    args[ 0 ] = best->tool;
+    args[ 1 ] = best->option;
+    for ( i = 1; i < argc; ++i ) {
+        args[ i + 1 ] = argv[ i ];
+    }
+    args[ argc + 1 ] = NULL;
+
+    tp = findTool( best->tool );
+    return tp->fn( argc + 1, args );
+}
+
+
+int main( int argc, char **argv )
+{
+    struct _tool *tp;
+    int i;
+
+    /*
+     *  Called by the name of a tool?
+     */
+    tp = findTool( argv[ 0 ] );
+    if ( tp != NULL ) {
+        return tp->fn( argc, argv );
+    }
+
+    if ( argc < 2 ) {
+        return usage();
+    }
+    ++argv;
+    --argc;
+
+    /*
+     *  Pipeline or single tool?
+     */
+    for ( i = 0; i < argc; ++i ) {
+        if ( 0 == strcmp( argv[ i ], PIPE_SEP ) ) {
+#ifdef __unix__
+            return pipeline( argv );
+#else
+            fprintf( stderr, "casutil: pipelines are not supported\n" );
+            return 2;
+#endif
+        }
+    }
+
+    if ( 0 == strcmp( *argv, "auto" ) ) {
+        return autoList( argc, argv );
+    }
+
+    tp = findTool( *argv );
+    if ( tp == NULL ) {
+        fprintf( stderr, "casutil: unknown tool %s\n", *argv );
+        return usage();
+    }
+    return tp->fn( argc, argv );
+}
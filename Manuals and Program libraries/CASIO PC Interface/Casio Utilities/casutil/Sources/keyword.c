@@ -0,0 +1,131 @@
+/*
+ *  keyword.c
+ *
+ *  Keyword matcher shared by the BASIC tokenizers
+ *
+ *  The keywords are grouped by their first character (converted to
+ *  upper case if the match ignores case). Within a group they keep the
+ *  order of the table, so the first match is the same a linear search
+ *  would have found.
+ *
+ *  All functions return errors in errno. This is indicated by
+ *  a nonzero result.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include "keyword.h"
+
+/*
+ *  Group key of a character
+ */
+static int kwKey( KEYWORDS *kw, int c )
+{
+    c &= 0xFF;
+    return kw->ignoreCase ? toupper( c ) : c;
+}
+
+
+/*
+ *  Build the index for a keyword table
+ */
+int kwBuild( KEYWORDS *kw, const void *table, size_t size, int ignoreCase )
+{
+    const char *p = (const char *) table;
+    const char *text;
+    int i, c;
+    short next[ 257 ];
+
+    memset( kw, 0, sizeof( KEYWORDS ) );
+    kw->ignoreCase = ignoreCase;
+
+    /*
+     *  Count the entries
+     */
+    while ( *(const char * const *) p != NULL ) {
+        ++kw->count;
+        p += size;
+    }
+    kw->text = (const char **) malloc( kw->count * sizeof( char * ) );
+    kw->length = (unsigned char *) malloc( kw->count );
+    kw->order = (short *) malloc( kw->count * sizeof( short ) );
+    if ( kw->text == NULL || kw->length == NULL || kw->order == NULL ) {
+        kwFree( kw );
+        errno = ENOMEM;
+        return 1;
+    }
+
+    /*
+     *  Collect texts and group sizes
+     */
+    p = (const char *) table;
+    for ( i = 0; i < kw->count; ++i, p += size ) {
+        text = *(const char * const *) p;
+        kw->text[ i ] = text;
+        kw->length[ i ] = (unsigned char) strlen( text );
+        ++kw->start[ kwKey( kw, *text ) + 1 ];
+    }
+    for ( c = 0; c < 256; ++c ) {
+        kw->start[ c + 1 ] += kw->start[ c ];
+    }
+
+    /*
+     *  Distribute the entries in table order
+     */
+    memcpy( next, kw->start, sizeof( next ) );
+    for ( i = 0; i < kw->count; ++i ) {
+        kw->order[ next[ kwKey( kw, *kw->text[ i ] ) ]++ ] = (short) i;
+    }
+    return 0;
+}
+
+
+/*
+ *  Find the keyword at the start of line
+ */
+int kwMatch( KEYWORDS *kw, const char *line, int *length )
+{
+    int c = kwKey( kw, *line );
+    int i, j, l;
+    const char *p;
+
+    for ( j = kw->start[ c ]; j < kw->start[ c + 1 ]; ++j ) {
+        i = kw->order[ j ];
+        p = kw->text[ i ];
+        l = kw->length[ i ];
+        if ( kw->ignoreCase ) {
+            while ( l > 0 && *line != '\0'
+                    && toupper( *line & 0xFF ) == toupper( *p & 0xFF ) )
+            {
+                ++line;
+                ++p;
+                --l;
+            }
+            line -= p - kw->text[ i ];
+        }
+        else if ( strncmp( line, p, l ) == 0 ) {
+            l = 0;
+        }
+        if ( l == 0 ) {
+            *length = kw->length[ i ];
+            return i;
+        }
+    }
+    return -1;
+}
+
+
+/*
+ *  Release the index
+ */
+void kwFree( KEYWORDS *kw )
+{
+    free( kw->text );
+    free( kw->length );
+    free( kw->order );
+    kw->text = NULL;
+    kw->length = NULL;
+    kw->order = NULL;
+    kw->count = 0;
+}
@@ -0,0 +1,51 @@
+/*
+ *  keyword.h
+ *
+ *  Entry points of keyword.c
+ *
+ *  Keyword matcher shared by the BASIC tokenizers
+ *
+ *  A keyword table is any array of structures (or plain string pointers)
+ *  whose first member is the keyword text, terminated by a NULL text.
+ *  The table is indexed once by the first character of each keyword.
+ *  A match returns the first matching entry in table order, just like
+ *  a linear search through the table.
+ *
+ *  All functions return errors in errno. This is indicated by
+ *  a nonzero result.
+ */
+#include <stddef.h>
+
+/*
+ *  Keyword index
+ */
+typedef struct _keywords {
+    int count;
+    int ignoreCase;
+    const char **text;
+    unsigned char *length;
+    short *order;
+    short start[ 257 ];
+} KEYWORDS;
+
+/*
+ *  Build the index for a keyword table
+ *
+ *  size is the size of a table entry
+ *  ignoreCase selects case insensitive matching
+ */
+extern int kwBuild( KEYWORDS *kw, const void *table, size_t size,
+                    int ignoreCase );
+
+/*
+ *  Find the keyword at the start of line
+ *
+ *  Returns the entry number in the table or -1 if nothing matches.
+ *  The length of the keyword is returned in *length.
+ */
+extern int kwMatch( KEYWORDS *kw, const char *line, int *length );
+
+/*
+ *  Release the index
+ */
+extern void kwFree( KEYWORDS *kw );
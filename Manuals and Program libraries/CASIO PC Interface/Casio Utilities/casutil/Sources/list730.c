@@ -19,6 +19,7 @@
 #include <stdlib.h>
 #include "bool.h"
 #include "wave.h"
+#include "bcd.h"
 
 /*
  *  Error messages 
@@ -157,9 +158,81 @@ const char *tokens[] =
 bool BinMode = TRUE;
 bool EscapeMode = TRUE;
 
-void casioprint( int c )
+/*
+ *  Output text for each character code, built by buildCharTable()
+ *  PlainTable is used outside strings, QuotedTable inside strings.
+ *  NULL entries are tokens or codes without a printable representation.
+ */
+const char *PlainTable[ 256 ];
+const char *QuotedTable[ 256 ];
+char HexTable[ 256 ][ 4 ];
+
+/*
+ *  Build the output tables for the current EscapeMode
+ */
+void buildCharTable( void )
 {
+    static char single[ 256 ][ 2 ];
+    static char escaped[ 256 ][ 4 ];
     struct _specials *sp;
+    int c;
+
+    for ( c = 0; c < 256; ++c ) {
+
+        sprintf( HexTable[ c ], "\\%2.2X", c );
+        PlainTable[ c ] = NULL;
+
+        if ( c <= 0x7F ) {
+            /*
+             *  Other characters
+             */
+            if ( EscapeMode && characters[ c ] == ' ' ) {
+                PlainTable[ c ] = HexTable[ c ];
+            }
+            else if ( characters[ c ] == '\0' ) {
+                /*
+                 *  No representation, don't write a NUL to the listing
+                 */
+                PlainTable[ c ] = EscapeMode ? HexTable[ c ] : "?";
+            }
+            else {
+                single[ c ][ 0 ] = characters[ c ];
+                PlainTable[ c ] = single[ c ];
+            }
+        }
+    }
+
+    /*
+     *  Special characters
+     */
+    for ( sp = specials + sizeof( specials ) / sizeof( specials[ 0 ] ) - 2;
+          sp >= specials; --sp )
+    {
+        PlainTable[ sp->token ] = sp->text;
+    }
+    memcpy( QuotedTable, PlainTable, sizeof( QuotedTable ) );
+
+    /*
+     *  Escape sequences like \pi for PI, only in strings
+     */
+    for ( sp = escapes; EscapeMode && sp->text != NULL; ++sp ) {
+        if ( sp->token <= 0x7F 
+          && QuotedTable[ sp->token ] != escaped[ sp->token ] ) 
+        {
+            sprintf( escaped[ sp->token ], "\\%s", sp->text );
+            QuotedTable[ sp->token ] = escaped[ sp->token ];
+        }
+    }
+}
+
+
+/*
+ *  Size of the stdout buffer
+ */
+#define OUTPUT_BUFFER 0x10000
+
+void casioprint( int c )
+{
     static bool in_string = FALSE;
     static bool transparent = FALSE;
     static bool space_pending = FALSE;
@@ -193,40 +266,16 @@ void casioprint( int c )
     }
     space_pending = FALSE;
 
-    if ( ( transparent || in_string ) && EscapeMode && c <= 0x7F ) {
-        /*
-         *  Print escape sequences like \pi for PI
-         */
-        for ( sp = escapes; sp->text != NULL; ++sp ) {
-            if ( c == sp->token ) {
-                printf( "\\%s", sp->text );
-                return;
-            }
-        }
-    }
-        
     /*
-     *  Print special characters
+     *  Print escape sequences, special characters and other characters
      */
-    for ( sp = specials; sp->text != NULL; ++sp ) {
-        if ( c == sp->token ) {
-            printf( "%s", sp->text );
-            return;
-        }
+    p = ( transparent || in_string ) ? QuotedTable[ c ] : PlainTable[ c ];
+    if ( p != NULL ) {
+        fputs( p, stdout );
+        return;
     }
 
-    if ( c <= 0x7F ) {
-        /*
-         *  Print other characters or tokens
-         */
-        if ( EscapeMode && characters[ c ] == ' ' ) {
-            printf( "\\%2.2X", c );
-        }
-        else {
-            printf( "%c", characters[ c ] );
-        }
-    }
-    else if ( !in_string && !transparent && c <= 0xD1 ) {
+    if ( !in_string && !transparent && c <= 0xD1 ) {
         /*
          *  Token
          */
@@ -241,11 +290,11 @@ void casioprint( int c )
             --l;
             space_pending = TRUE;
         }
-        printf( "%.*s", l, tokens[ c - 0x80 ] );
+        fwrite( p, 1, l, stdout );
     }
     else {
         if ( EscapeMode ) {
-            printf( "\\%2.2X", c );
+            fputs( HexTable[ c ], stdout );
         }
         else {
             putchar( '?' );
@@ -254,14 +303,6 @@ void casioprint( int c )
 }
 
 
-int bcd2bin (int c)
-{
-  int x;
-  x = c/16;
-  return c - 6*x;
-}
-
-
 /* returns 0 when OK or the error code when invalid data encountered */
 int list( int c )
 {
@@ -531,6 +572,8 @@ int main(int argc, char *argv[])
                 "         -e generate backslash escapes for special codes\n" );
         return 2;
     }
+    setvbuf( stdout, NULL, _IOFBF, OUTPUT_BUFFER );
+    buildCharTable();
 
     if ( wavemode )
     {
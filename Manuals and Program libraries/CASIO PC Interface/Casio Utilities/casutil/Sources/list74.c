@@ -476,6 +476,26 @@ struct _header {
 unsigned char Block[ 64 ];
 int BlockSize;
 
+/*
+ *  One of the two copies of a block on tape
+ */
+typedef struct _copy
+{
+    unsigned char data[ 64 ];
+    bool bad[ 64 ];
+    unsigned char check;
+    bool check_bad;
+    unsigned char sum;
+    bool valid;
+} COPY;
+
+/*
+ *  Maximum number of differing bytes tried in all combinations
+ *  Each wrong combination matches the 8 bit check sum by chance with
+ *  a probability of 1/256, more tries make a false match likely.
+ */
+#define MAX_VOTES 2
+
 /*
  *  Layout of length block
  */
@@ -522,59 +542,52 @@ int readByte( void )
 
 
 /*
- *  Read low level block
+ *  Read one copy of a low level block
  *  Returns internal error code
  */
-int readBlock( int length )
+int readCopy( COPY *cp, int length )
 {
-    int c, count;
-    unsigned char check = 0;
-    bool retry = FALSE;
+    int c, count, size;
 
-#if _DEBUG
-    printf( "readBlock(%d):", length );
-#endif
-    if ( length < 0 ) {
-        retry = TRUE;
-        length = -length;
-    }
-    
-    BlockSize = -1;
+    size = -1;
     count = 0;
+    cp->sum = 0;
+    cp->valid = FALSE;
 
-    while ( BlockSize < length ) {
+    while ( size < length ) {
         c = readByte();
         if ( c < 0 ) {
             /*
              *  Read error
              */
-            return 1;            
+            return 1;
         }
 #if _DEBUG
         printf( "[%2.2X]", c );
 #endif
         if ( c == KCS_LEAD_IN ) {
-            if ( BlockSize != -1 ) {
+            if ( size != -1 ) {
                 /*
                  *  Block ends too early
                  */
                 return 4;
             }
         }
-        else if ( BlockSize == -1 && c == 0xFF ) {
+        else if ( size == -1 && c == 0xFF ) {
             /*
              *  Block starts here
              */
             count = 0;
-            BlockSize = 0;
-            check = 0;
+            size = 0;
+            cp->sum = 0;
         }
-        else if ( BlockSize != -1 ) {
+        else if ( size != -1 ) {
             /*
-             *  Store byte
+             *  Store byte, remember framing or parity errors
              */
-            Block[ BlockSize++ ] = (unsigned char) c;
-            check += (unsigned char) c;
+            cp->data[ size ] = (unsigned char) c;
+            cp->bad[ size++ ] = ( c & ( KCS_PARITY | KCS_FRAMING ) ) != 0;
+            cp->sum += (unsigned char) c;
         }
         else if ( ++count > 8 ) {
             /*
@@ -585,7 +598,7 @@ int readBlock( int length )
     }
 
     /*
-     *  Compare check sum
+     *  Read the check sum
      */
     c = readByte();
     if ( c < 0 ) {
@@ -595,66 +608,149 @@ int readBlock( int length )
         return 1;
     }
 #if _DEBUG
-        printf( "[%2.2X]", c );
-#endif
-#if _DEBUG
-    printf( "Checksum: %X, BlockSize: %d\n", check, BlockSize );
+    printf( "[%2.2X]", c );
+    printf( "Checksum: %X, Sum: %X\n", c & 0xFF, cp->sum );
 #endif
-    if ( (unsigned char) c != check ) {
-        /*
-         *  Bad check sum
-         */
-        if ( retry ) {
-            return 2;
-        }
+    cp->check = (unsigned char) c;
+    cp->check_bad = ( c & ( KCS_PARITY | KCS_FRAMING ) ) != 0;
+    cp->valid = cp->check == cp->sum && !cp->check_bad;
+    return 0;
+}
+
+
+/*
+ *  Vote between two copies of a block which both fail their check sums
+ *  Bytes on which the copies agree are taken as they are. Where they
+ *  differ, all combinations of the differing bytes are tried, except
+ *  those taking a byte with a framing or parity error against a clean
+ *  one. The block is only accepted if exactly one combination matches
+ *  the check sum. The check sum must be read cleanly and be the same in
+ *  both copies, else the block can't be verified and is reported as bad.
+ *  Returns TRUE if a consistent block could be assembled in Block.
+ */
+bool voteBlock( COPY *copy, int length )
+{
+    int diff[ MAX_VOTES ];
+    int ndiff = 0;
+    int i, j, k, c, match = -1;
+    unsigned char sum;
+
+    if ( copy[ 0 ].check != copy[ 1 ].check
+         || copy[ 0 ].check_bad || copy[ 1 ].check_bad )
+    {
         /*
-         *  Try again
+         *  No check sum to verify the result against
          */
-        return readBlock( -length );
+        return FALSE;
     }
 
-    if ( retry ) {
+    for ( i = 0; i < length; ++i ) {
+        Block[ i ] = copy[ 0 ].data[ i ];
+        if ( copy[ 0 ].data[ i ] == copy[ 1 ].data[ i ] ) {
+            continue;
+        }
+        if ( ndiff < MAX_VOTES ) {
+            diff[ ndiff ] = i;
+        }
+        ++ndiff;
+    }
+    if ( ndiff > MAX_VOTES ) {
         /*
-         *  Retry attempt was successful
+         *  Too many disagreements to guess
          */
-#if _DEBUG
-        printf( "Success on retry\n" );
-#endif
-        return 0;
+        return FALSE;
     }
 
-    /*
-     *  Skip the duplicate
-     */
-    count = 0;
-    do {
-        c = readByte();
-#if _DEBUG
-        printf( "<%2.2X>", c );
-#endif
-        if ( c < 0 ) {
+    for ( k = 0; k < ( 1 << ndiff ); ++k ) {
+        for ( j = 0; j < ndiff; ++j ) {
+            i = diff[ j ];
+            c = ( k >> j ) & 1;
+            if ( copy[ c ].bad[ i ] && !copy[ 1 - c ].bad[ i ] ) {
+                break;
+            }
+            Block[ i ] = copy[ c ].data[ i ];
+        }
+        if ( j < ndiff ) {
             /*
-             *  Read error - ignore
+             *  Uses a byte with a reading error
              */
             continue;
         }
-    } while ( c != 0xFF && count++ < 9 );
-
-    count = 0;
-    do {
-        c = readByte();
+        for ( sum = 0, i = 0; i < length; ++i ) {
+            sum += Block[ i ];
+        }
+        if ( sum == copy[ 0 ].check ) {
+            if ( match >= 0 ) {
+                /*
+                 *  Ambiguous, both results would be guesses
+                 */
+                return FALSE;
+            }
+            match = k;
+        }
+    }
+    if ( match < 0 ) {
+        return FALSE;
+    }
+    for ( j = 0; j < ndiff; ++j ) {
+        i = diff[ j ];
+        Block[ i ] = copy[ ( match >> j ) & 1 ].data[ i ];
+    }
 #if _DEBUG
-        printf( "<%2.2X>", c );
+    printf( "Voted block, %d byte(s) differ\n", ndiff );
 #endif
-    } while ( count++ < BlockSize && c >= 0 );
+    return TRUE;
+}
+
+
+/*
+ *  Read low level block
+ *  The TI-74 writes each block twice. Both copies are read. If neither
+ *  passes its check sum, the block is assembled from both copies.
+ *  Returns internal error code
+ */
+int readBlock( int length )
+{
+    COPY copy[ 2 ];
+    int err, err2;
 
+#if _DEBUG
+    printf( "readBlock(%d):", length );
+#endif
+    err = readCopy( copy, length );
+    if ( err == 1 ) {
+        return err;
+    }
+    err2 = readCopy( copy + 1, length );
 #if _DEBUG
     putchar( '\n' );
 #endif
-    /*
-     *  OK
-     */
-    return 0;
+
+    BlockSize = length;
+    if ( err == 0 && copy[ 0 ].valid ) {
+        /*
+         *  Errors in the duplicate don't matter
+         */
+        memcpy( Block, copy[ 0 ].data, length );
+        return 0;
+    }
+    if ( err2 == 0 && copy[ 1 ].valid ) {
+        /*
+         *  Retry attempt was successful
+         */
+#if _DEBUG
+        printf( "Success on retry\n" );
+#endif
+        memcpy( Block, copy[ 1 ].data, length );
+        return 0;
+    }
+    if ( err != 0 ) {
+        return err;
+    }
+    if ( err2 != 0 ) {
+        return err2;
+    }
+    return voteBlock( copy, length ) ? 0 : 2;
 }
 
 
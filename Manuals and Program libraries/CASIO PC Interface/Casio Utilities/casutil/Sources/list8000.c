@@ -15,6 +15,7 @@
 #include <errno.h>
 #include "bool.h"
 #include "wave.h"
+#include "bcd.h"
 
 /*
  *  Error messages
@@ -426,6 +427,11 @@ struct _cas_prog_table {
 #define G_IMAGE_SIZE ( G_WIDTH * G_HEIGHT / ( 8 / G_BITS ) )
 #define G_RESOLUTION 2500
 
+/*
+ *  Size of the stdout buffer
+ */
+#define OUTPUT_BUFFER 0x10000
+
 struct _bitmap {
     char _filler[ 2 ];
     char id[ 2 ];
@@ -469,39 +475,159 @@ unsigned char BitmapImage[ 9 * G_IMAGE_SIZE ];
 unsigned char Graphic[ 0xF00 ];
 
 
+/*
+ *  Number of the current graphic on tape
+ */
+int GraphNumber = 0;
+
+
+/*
+ *  Transpose a column of eight screen bytes into eight pixel rows
+ *  The calculator stores eight rows per byte in the order 4..7, 0..3
+ *  with the pixels inverted. in[ k * in_step ] holds the k-th pixel of
+ *  each row, it ends up in bit 7 - k of out[ j * out_step ] for row j.
+ */
+void transposeColumn( unsigned char *in, int in_step, 
+                      unsigned char *out, int out_step )
+{
+    unsigned long x, y, t;
+
+    x = (unsigned long) in[ 0 ] << 24 
+      | (unsigned long) in[ in_step ] << 16 
+      | (unsigned long) in[ 2 * in_step ] << 8 
+      | (unsigned long) in[ 3 * in_step ];
+    y = (unsigned long) in[ 4 * in_step ] << 24 
+      | (unsigned long) in[ 5 * in_step ] << 16 
+      | (unsigned long) in[ 6 * in_step ] << 8 
+      | (unsigned long) in[ 7 * in_step ];
+    x = ~x & 0xFFFFFFFFUL;
+    y = ~y & 0xFFFFFFFFUL;
+
+    /*
+     *  Swap 1x1, 2x2 and 4x4 blocks
+     */
+    t = ( x ^ ( x >> 7 ) ) & 0x00AA00AAUL;  x = x ^ t ^ ( t << 7 );
+    t = ( y ^ ( y >> 7 ) ) & 0x00AA00AAUL;  y = y ^ t ^ ( t << 7 );
+    t = ( x ^ ( x >> 14 ) ) & 0x0000CCCCUL; x = x ^ t ^ ( t << 14 );
+    t = ( y ^ ( y >> 14 ) ) & 0x0000CCCCUL; y = y ^ t ^ ( t << 14 );
+    t = ( x & 0xF0F0F0F0UL ) | ( ( y >> 4 ) & 0x0F0F0F0FUL );
+    y = ( ( x << 4 ) & 0xF0F0F0F0UL ) | ( y & 0x0F0F0F0FUL );
+    x = t;
+
+    /*
+     *  x holds the source bits 7..4, y the bits 3..0
+     */
+    out[ 0 ]            = (unsigned char) x;
+    out[ out_step ]     = (unsigned char) ( x >> 8 );
+    out[ 2 * out_step ] = (unsigned char) ( x >> 16 );
+    out[ 3 * out_step ] = (unsigned char) ( x >> 24 );
+    out[ 4 * out_step ] = (unsigned char) y;
+    out[ 5 * out_step ] = (unsigned char) ( y >> 8 );
+    out[ 6 * out_step ] = (unsigned char) ( y >> 16 );
+    out[ 7 * out_step ] = (unsigned char) ( y >> 24 );
+}
+
+
+/*
+ *  Convert a screen to BMP rows
+ *  The bits are stored right to left, bottom to top, inverted.
+ */
+void convertScreen( unsigned char *dest, unsigned char *source,
+                    int width, int height )
+{
+    int x, y;
+    int row_size = width / 8;
+
+    for ( y = 0; y < height; y += 8, source += width ) {
+        for ( x = 0; x < width; x += 8 ) {
+            /*
+             *  Pixels are stored rightmost first
+             */
+            transposeColumn( source + width - 1 - x, -1,
+                             dest + y * row_size + x / 8, row_size );
+        }
+    }
+}
+
+
+/*
+ *  Create the bitmap filename
+ *  '#' is replaced by the pass, '*' by the number of the graphic.
+ *  Pass 0 keeps the '#'.
+ */
+char *makeBitmapName( int pass )
+{
+    static char name[ FILENAME_MAX ];
+    char *p = name;
+    char *q;
+
+    for ( q = BitmapFile; *q != '\0' && p < name + FILENAME_MAX - 8; ++q ) {
+        if ( *q == '#' && pass != 0 ) {
+            *p++ = (char) ( '0' + pass );
+        }
+        else if ( *q == '*' ) {
+            p += sprintf( p, "%d", GraphNumber );
+        }
+        else {
+            *p++ = *q;
+        }
+    }
+    *p = '\0';
+    return name;
+}
+
+
 /*
  *  Create Bitmaps
  *  There are two pictures in the file
- *  If the name contains a '?', we dump them all
+ *  If the name contains a '#', we dump them all
+ *  If the name contains a '*', each graphic gets its own set of files
  */
 int createBitmap( void )
 {
+    static unsigned long triple[ 256 ];
+    static bool initialized = FALSE;
+    unsigned char screen[ G_IMAGE_SIZE ];
     FILE *fd;
     unsigned char *p, *source;
-    int x, y, fcount;
-    unsigned char mask, source_mask;
-    char *fn_index_pos;
-    int bit, pass;
+    unsigned long bits;
+    char *name;
+    int x, y, i, fcount;
+    int pass;
 
     if ( BitmapFile == NULL ) {
         return 0;
     }
+    ++GraphNumber;
 
-    LSB_FIRST( BitmapHeader.offset );
-    LSB_FIRST( BitmapHeader.header_size );
-    LSB_FIRST( BitmapHeader.planes );
-    LSB_FIRST( BitmapHeader.bits );
-    LSB_FIRST( BitmapHeader.compression );
-    LSB_FIRST( BitmapHeader.x_resolution );
-    LSB_FIRST( BitmapHeader.y_resolution );
-    LSB_FIRST( BitmapHeader.palette_size );
-    LSB_FIRST( BitmapHeader.important );
+    if ( !initialized ) {
+        /*
+         *  Static header fields and a table to enlarge each pixel
+         *  to 2 pixels in a 3 pixel box
+         */
+        LSB_FIRST( BitmapHeader.offset );
+        LSB_FIRST( BitmapHeader.header_size );
+        LSB_FIRST( BitmapHeader.planes );
+        LSB_FIRST( BitmapHeader.bits );
+        LSB_FIRST( BitmapHeader.compression );
+        LSB_FIRST( BitmapHeader.x_resolution );
+        LSB_FIRST( BitmapHeader.y_resolution );
+        LSB_FIRST( BitmapHeader.palette_size );
+        LSB_FIRST( BitmapHeader.important );
+
+        for ( i = 0; i < 256; ++i ) {
+            for ( bits = 0, x = 0x80; x != 0; x >>= 1 ) {
+                bits = ( bits << 3 ) | ( ( i & x ) ? 6 : 0 );
+            }
+            triple[ i ] = bits;
+        }
+        initialized = TRUE;
+    }
 
     /*
      *  Look for wildcard in filename for index
      */
-    fn_index_pos = strchr( BitmapFile, '#' );
-    if ( fn_index_pos == NULL ) {
+    if ( strchr( BitmapFile, '#' ) == NULL ) {
         /*
          *  no wildcard found, output only first file
          */
@@ -514,7 +640,6 @@ int createBitmap( void )
     for ( pass = 1; pass <= fcount; ++pass ) {
         /*
          *  Analyze the Image and convert it to a BMP file.
-         *  The bits are stored right to left, bottom to top, inverted.
          *  One byte is 2x4 rows, high nibble comes first.
          *
          *  The second picture is double sized !
@@ -523,72 +648,42 @@ int createBitmap( void )
          */
         int height = G_HEIGHT * pass;
         int width  = G_WIDTH  * pass;
-        int source_width = G_WIDTH * ( pass == 2 ? 2 : 1 );
         int size = height * width / ( 8 / G_BITS );
 
 #if DEBUG
         printf( "\nPass %d, %dx%d (%d)\n", pass, height, width, size );
         fflush( stdout );
 #endif
-        p = BitmapImage;
-        memset( BitmapImage, 0, size );
-        source = pass != 2 ? Graphic : Graphic + G_IMAGE_SIZE;
-
-        for ( y = 0, source_mask = 0x10; y < height; ++y ) {
+        if ( pass == 1 ) {
+            convertScreen( BitmapImage, Graphic, width, height );
+            memcpy( screen, BitmapImage, G_IMAGE_SIZE );
+        }
+        else if ( pass == 2 ) {
+            convertScreen( BitmapImage, Graphic + G_IMAGE_SIZE, 
+                           width, height );
+        }
+        else {
             /*
-             *  Bottom to top ordering of lines is standard with BMP files
+             *  Every third row is empty, the others are enlarged copies
              */
-            for ( x = 0, mask = 0x80; x < width; ++x ) {
-                /*
-                 *  Pixels are stored rightmost first
-                 */
-                if ( pass <= 2 ) {
-                    bit = ( ~source[ source_width - 1 - x ] ) & source_mask;
-                }
-                else {
-                    if ( x % 3 == 2 || y % 3 == 0 ) {
-                        bit = 0;
-                    }
-                    else {
-                        bit = ( ~source[ source_width - 1 - x / 3 ] ) 
-                            & source_mask;
-                    }
-                }
-                if ( bit ) {    
-                    *p |= mask;
-                }
-                mask >>= 1; 
-                if ( mask == 0 ) {
-                    mask = 0x80;
-                    ++p;
+            p = BitmapImage;
+            source = screen;
+            for ( y = 0; y < G_HEIGHT; ++y ) {
+                memset( p, 0, width / 8 );
+                p += width / 8;
+                for ( x = 0; x < G_WIDTH / 8; ++x ) {
+                    bits = triple[ *source++ ];
+                    *p++ = (unsigned char) ( bits >> 16 );
+                    *p++ = (unsigned char) ( bits >> 8 );
+                    *p++ = (unsigned char) bits;
                 }
+                memcpy( p, p - width / 8, width / 8 );
+                p += width / 8;
             }
-#if DEBUG
-            printf( "y=%d,s=%p,m=%x,b=%x\n", y, source - Graphic, source_mask,
-                                        *source );
-            fflush( stdout );
-#endif
-            if ( pass <= 2 || y % 3 == 2 ) {
-                source_mask <<= 1;
-                if ( source_mask == 0 ) {
-                    source_mask = 1;
-                }
-                else if ( source_mask == 0x10 ) {
-                    /*
-                     *  Next eight rows
-                     */
-                    source += source_width;
-                }
-            }
-        } 
-
-        if ( fn_index_pos != NULL ) {
-            /*
-             *  Set index in filename
-             */
-            *fn_index_pos = (char) ( '0' + pass );
         }
 
+        name = makeBitmapName( fcount == 1 ? 0 : pass );
+
         /*
          *  Update some fields depending on size
          */
@@ -605,28 +700,21 @@ int createBitmap( void )
         /*
          *  Write the file to disk
          */
-        fd = fopen( BitmapFile, "wb" );
+        fd = fopen( name, "wb" );
         if ( fd == NULL ) {
-            perror( BitmapFile );
+            perror( name );
             return 6;
         }
         if ( 1 != fwrite( BitmapHeader.id, B_HEADER_SIZE, 1, fd ) ) {
-            perror( BitmapFile );
+            perror( name );
             return 6;
         }
         if ( 1 != fwrite( BitmapImage, size, 1, fd ) ) {
-            perror( BitmapFile );
+            perror( name );
             return 6;
         }
         fclose( fd );
     }
-
-    if ( fn_index_pos != NULL ) {
-        /*
-         *  Repair filename
-         */
-        *fn_index_pos = '#';
-    }
     return 0;
 }
 
@@ -817,31 +905,65 @@ int writeCasRange( void )
     
 
 /*
- *  Find a token in the token table
+ *  Direct token index, built by buildTokenIndex()
+ *  TokenIndex[ 1 ] has the fx-8000G only tokens merged in,
+ *  TokenIndex_7F holds the extended tokens following 0x7F.
+ *  Unknown codes point to the empty entry at the end of a table.
+ */
+TOKEN *TokenIndex[ 2 ][ 256 ];
+TOKEN *TokenIndex_7F[ 256 ];
+
+/*
+ *  Enter a token table into an index, earlier entries take precedence
  */
-TOKEN *findToken( int c, TOKEN *tp )
+void indexTokens( TOKEN **index, TOKEN *tp )
 {
-    if ( tp == NULL ) {
-        /*
-         *  Default handling
-         */
-        if ( Fx8000G ) {
-            /*
-             *  Search fx-8000G only tokens first
-             */
-            tp = findToken( c, Tokens_fx8000G );
-            if ( tp->token != 0 ) {
-                return tp;
-            }
+    for ( ; tp->token != 0; ++tp ) {
+        if ( index[ tp->token ] == NULL ) {
+            index[ tp->token ] = tp;
         }
-        tp = Tokens;
     }
+}
 
-    /*
-     *  Search loop
-     */
-    while ( tp->token != 0 && tp->token != c ) ++tp;
-    return tp;
+/*
+ *  Fill the unused entries of an index with the table end
+ */
+void closeIndex( TOKEN **index, TOKEN *tp )
+{
+    int i;
+
+    while ( tp->token != 0 ) ++tp;
+    for ( i = 0; i < 256; ++i ) {
+        if ( index[ i ] == NULL ) {
+            index[ i ] = tp;
+        }
+    }
+}
+
+/*
+ *  Build the token index from the token tables
+ */
+void buildTokenIndex( void )
+{
+    indexTokens( TokenIndex[ 1 ], Tokens_fx8000G );
+    indexTokens( TokenIndex[ 1 ], Tokens );
+    indexTokens( TokenIndex[ 0 ], Tokens );
+    indexTokens( TokenIndex_7F, Tokens_7F );
+
+    closeIndex( TokenIndex[ 0 ], Tokens );
+    closeIndex( TokenIndex[ 1 ], Tokens );
+    closeIndex( TokenIndex_7F, Tokens_7F );
+}
+
+/*
+ *  Find a token in the token index
+ */
+TOKEN *findToken( int c, bool ext_7F )
+{
+    if ( ext_7F ) {
+        return TokenIndex_7F[ c & 0xFF ];
+    }
+    return TokenIndex[ Fx8000G ? 1 : 0 ][ c & 0xFF ];
 }
 
 
@@ -881,7 +1003,7 @@ void casioprint( int c )
         /*
          *  Replacable token
          */
-        tp = findToken( c, ext_7F ? Tokens_7F : NULL );
+        tp = findToken( c, ext_7F );
         p = tp->text;
 
         if ( quoted || cat ) {
@@ -1038,25 +1160,14 @@ void printHeader( void )
 }
 
 
-/*
- *  Convert a BCD coded byte to binary
- */
-int bcd2bin( int c )
-{
-    int x;
-    x = c / 16;
-    return c - 6 * x;
-}
-
-
 /*
  *  Print a number (from SAVE M)
  *  If result is present, the string is put therein and not printed 
  */
 char *printNumber( unsigned char *buffer, ENCODING enc, char *result )
 {
-    int exp, flag, i;
-    char c, *fmt, *save = result;
+    int exp, flag;
+    char c, *save = result;
     static char temp[] = "+1.234567890123\\EE+12";
 
     /*
@@ -1077,21 +1188,6 @@ char *printNumber( unsigned char *buffer, ENCODING enc, char *result )
         *result++ = c;
     }
 
-    /*
-     *  First digit
-     */
-    c = '0' + ( buffer[ 7 ] >> 4 );
-    *result++ = c;
-    *result++ = '.';
-
-    /*
-     *  Digits 2 to 13
-     */
-    for ( i = 6; i > 0; --i ) {
-        sprintf( result, "%02.2X", buffer[ i ] );
-        result += 2;
-    }
-
     /*
      *  calculate exponent
      */
@@ -1100,47 +1196,42 @@ char *printNumber( unsigned char *buffer, ENCODING enc, char *result )
     if ( exp != 0 && ( flag == 0 || flag == 5 ) ) {
         exp -= 100;
     }
-    if ( exp <= 9 && exp > 0 ) {
-        /*
-         *  Adjust the decimal point
-         */
-        for ( i = 0; i < exp; ++i ) {
-            result[ i - 13 ] = result[ i - 12 ];
-        }
-        result[ i - 13 ] = '.';
-        exp = 0;
-    }
 
     /*
-     *  Strip trailing zeros
+     *  13 digits, the first in the high nibble of the sign byte
+     *  The decimal point is adjusted for exponents up to 9
      */
-    for ( i = 0; i < 12 && result[ -1 ] == '0'; ++i, --result );
-    if ( result[ -1 ] == '.' ) --result;
-    *result = '\0';
+    result = bcdMantissa( result, buffer + 7, -1, 6, &exp, 9 );
 
     /*
      *  Append the exponent if non zero
      */
     if ( exp != 0 ) {
+        if ( enc == ENC_ESCAPE ) {
+            memcpy( result, "\\EE", 3 );
+            result += 3;
+        }
+        else if ( enc == ENC_INTERNAL ) {
+            *result++ = 0x0F;
+        }
+        else {
+            *result++ = 'e';
+        }
         if ( exp < 0 ) {
-            fmt = enc == ENC_ESCAPE   ? "\\EE-%d" :
-                  enc == ENC_INTERNAL ? "\x0F\x87%d" :
-                  "e-%02.2d";
+            *result++ = enc == ENC_INTERNAL ? 0x87 : '-';
             exp = -exp;
         }
-        else {
-            fmt = enc == ENC_ESCAPE   ? "\\EE%d" :
-                  enc == ENC_INTERNAL ? "\x0F%d" :
-                  "e+%02.2d";
+        else if ( enc == ENC_ASCII ) {
+            *result++ = '+';
         }
-        sprintf( result, fmt, exp );
+        bcdDecimal( result, exp, enc == ENC_ASCII ? 2 : 1 );
     }
 
     /*
      *  Result
      */
     if ( save == NULL ) {
-        printf( "%s", temp );
+        fputs( temp, stdout );
     }
     return save;
 }
@@ -1324,9 +1415,8 @@ void dumpBitmap( int color, int width, int height )
 void exportImages( void )
 {
     unsigned char *p, *source;
-    int x, y, x0;
-    unsigned char mask, source_mask;
-    int bit, pass;
+    int y, x0;
+    int pass;
 
     for ( pass = 1; pass <= 4; ++pass ) {
         /*
@@ -1346,7 +1436,6 @@ void exportImages( void )
          *  orange, blue, green and white. 
          *  Only one color is filled with actual data.
          */
-        p = BitmapImage + x_offset * height / 8;
         memset( BitmapImage, 0, size );
 
         printCatHeader( TYPE_GRAPH, 0, 
@@ -1359,38 +1448,17 @@ void exportImages( void )
             dumpBitmap( color , width, height );
         }
 
-        for ( x0 = x_offset; x0 < width - x_offset; x0 += 8 ) {
+        for ( x0 = 0; x0 < source_width; x0 += 8 ) {
             /*
              *  Casio bitmaps are organized in 8 pixel width columns
              *  bottom to top, right to left
+             *  The leftmost pixel of each column goes to the lowest bit
              */
-            source_mask = 0x10;
-            source = Graphic;
+            p = BitmapImage + ( x_offset + x0 ) * height / 8;
+            source = Graphic + x0;
 
-            for ( y = 0; y < height; ++y, ++p ) {
-                /*
-                 *  Bottom to top ordering of lines is the same
-                 */
-                for ( x = x0, mask = 1; x < x0 + 8; ++x ) {
-                    /*
-                     *  Pixels are stored rightmost first
-                     */
-                    bit = ~source[ x - x_offset ] & source_mask;
-                    if ( bit ) {
-                        *p |= mask;
-                    }
-                    mask <<= 1; 
-                }
-                source_mask <<= 1;
-                if ( source_mask == 0 ) {
-                    source_mask = 1;
-                }
-                else if ( source_mask == 0x10 ) {
-                    /*
-                     *  Next eight rows
-                     */
-                    source += source_width;
-                }
+            for ( y = 0; y < height; y += 8, source += source_width ) {
+                transposeColumn( source + 7, -1, p + y, 1 );
             }
         } 
 
@@ -1458,7 +1526,7 @@ unsigned char *storeToken( int c, unsigned char* ptr )
     static int last_token;
     
     if ( c < ' ' || c > 0x7f ) {
-        p = findToken( c, NULL )->escape;
+        p = findToken( c, FALSE )->escape;
     }
     if ( p == NULL || *p == '\\' || strlen( p ) == 1 ) {
         /*
@@ -2407,7 +2475,7 @@ int list( int c )
                     return i;
                 }
                 if ( !cat ) {
-                    printf( "File(s) %s created", BitmapFile ); 
+                    printf( "File(s) %s created", makeBitmapName( 0 ) ); 
                 }
             }
         }
@@ -2456,6 +2524,8 @@ int main( int argc, char *argv[] )
     bool ignore = TRUE;
     int baud = -2400;
 
+    buildTokenIndex();
+
     ++argv;
     --argc;
 
@@ -2553,6 +2623,7 @@ int main( int argc, char *argv[] )
                 "         -c takes precedence over -e. Both can be mixed.\n"
                 "         -l<width> limits the listing width. Default is 40.\n"
                 "         -g<name#.bmp> creates bitmap files for any graphic.\n"
+                "           A '*' in the name numbers the graphics on tape.\n"
                 "         -cas[A|P|E|M|R|7] translate output to CAS format for "
                           "FA-121 software.\n"
                 "           A: Export all supported types (default).\n"
@@ -2588,6 +2659,7 @@ int main( int argc, char *argv[] )
         freopen( argv[ 1 ], "wt", stdout );
 #endif
     }
+    setvbuf( stdout, NULL, _IOFBF, OUTPUT_BUFFER );
 
     if ( wavemode ) {
         /*
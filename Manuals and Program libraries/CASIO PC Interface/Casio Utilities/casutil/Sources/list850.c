@@ -10,6 +10,7 @@
  *    -a        read ASCII file (Piotr's format)
  *    -w[S|F|H] read WAV file, Slow (default) or Fast (FX-850P only)
  *                             High speed (PB-1000)
+ *    -m[<dir>] list all files of an MD100 disk image into <dir>
  *
  *  Inspired by work from Piotr Piatek
  *  Written by Marcus von Cube
@@ -25,6 +26,12 @@
 #include <errno.h>
 #include "bool.h"
 #include "wave.h"
+#include "bcd.h"
+#ifdef __unix__
+#include <unistd.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#endif
 
 /*
  *  Error messages
@@ -691,6 +698,18 @@ bool Fp200 = FALSE;
 enum { ESC_NONE, ESC_FX, ESC_PB, ESC_HEX, UTF8_PB, UTF8_FX 
 } EscapeMode = ESC_NONE;
 
+/*
+ *  Output text for each character code according to EscapeMode
+ *  Built by buildCharTable() whenever EscapeMode changes
+ */
+char *CharTable[ 256 ];
+char HexTable[ 256 ][ 4 ];
+
+/*
+ *  Size of the stdout buffer
+ */
+#define OUTPUT_BUFFER 0x10000
+
 /*
  *  Logarithm mode
  */
@@ -755,6 +774,39 @@ struct _disk_header {
 #define DTYPE_R    0xA4           /* relative file for random access */
 #define DTYPE_C    0xD4           /* C source file (ASCII) */
 
+/*
+ *  MD100 disk image layout
+ */
+#define SIZE_SECTOR 256
+#define SIZE_BLOCK ( 4 * SIZE_SECTOR )
+#define MAX_BLOCKS ( 128 * 4 )
+#define START_DIR 1
+#define MAX_DIR_ENTRY ( 3 * SIZE_BLOCK / 16 )
+#define EOF_CHAR 0x1A
+#define FB_IN_USE  0x8000     /* marks a used entry */
+#define FB_LAST    0x4000     /* marks end of chain */
+#define FB_SECTORS 0x3000     /* number of last sector in last block */
+#define FB_BLOCK   0x01FF     /* number of block (this or next in chain) */
+
+/*
+ *  Directory entry of the MD100
+ */
+struct _dir_entry {
+    unsigned char type;
+    char name[ 8 ];
+    char ext[ 3 ];
+    unsigned char unused;
+    unsigned char block[ 2 ];
+    unsigned char protect;
+};
+
+/*
+ *  Disk image for -m and number of parallel workers
+ */
+unsigned char *DiskImage = NULL;
+int DiskBlocks = 0;
+int Workers = 1;
+
 void printHeader( void )
 {
     int i;
@@ -926,6 +978,77 @@ void printDiskHeader( void )
 
 
 
+/*
+ *  Build the output table for the current EscapeMode
+ *  Single characters, hex escapes, symbolic escapes or UTF-8 sequences
+ */
+void buildCharTable( void )
+{
+    static char chars[ 256 ][ 2 ];
+    static char *allocated[ 256 ];
+    struct _escapes *ep;
+    struct _utf8 *up;
+    int c;
+
+    up = EscapeMode == UTF8_FX ? Utf8_FX
+       : EscapeMode == UTF8_PB ? Utf8_PB
+       : NULL;
+    ep = EscapeMode == ESC_FX ? Escapes_FX
+       : EscapeMode == ESC_PB ? Escapes_PB
+       : NULL;
+
+    for ( c = 0; c < 256; ++c ) {
+
+        sprintf( HexTable[ c ], "\\%02.2X", c );
+        chars[ c ][ 0 ] = (char) c;
+        chars[ c ][ 1 ] = '\0';
+        CharTable[ c ] = chars[ c ];
+        if ( allocated[ c ] != NULL ) {
+            free( allocated[ c ] );
+            allocated[ c ] = NULL;
+        }
+    }
+    if ( !EscapeMode ) {
+        return;
+    }
+
+    /*
+     *  UTF-8 takes precedence of escaping
+     */
+    for ( ; up != NULL && up->text != NULL; ++up ) {
+        if ( CharTable[ up->token ] == chars[ up->token ] ) {
+            CharTable[ up->token ] = up->text;
+        }
+    }
+
+    /*
+     *  Create escape sequences like \PI
+     */
+    for ( ; ep != NULL && ep->text != NULL; ++ep ) {
+        if ( CharTable[ ep->token ] == chars[ ep->token ] ) {
+            c = ep->token;
+            allocated[ c ] = malloc( strlen( ep->text ) + 2 );
+            if ( allocated[ c ] != NULL ) {
+                sprintf( allocated[ c ], "\\%s", ep->text );
+                CharTable[ c ] = allocated[ c ];
+            }
+        }
+    }
+
+    /*
+     *  Hex escapes for the rest
+     */
+    for ( c = 0x80; c < 256; ++c ) {
+        if ( CharTable[ c ] == chars[ c ] ) {
+            CharTable[ c ] = HexTable[ c ];
+        }
+    }
+    if ( CharTable[ '\\' ] == chars[ '\\' ] ) {
+        CharTable[ '\\' ] = HexTable[ '\\' ];
+    }
+}
+
+
 /*
  *  Print a character, translate tokens
  */
@@ -938,8 +1061,6 @@ void casioprint( int c, bool is_data )
     static bool quoted_until_eol = FALSE;
     char *p = NULL;
     char buffer[] = "\\XX\\XX";
-    struct _escapes *ep;
-    struct _utf8 *up;
 
     if ( is_data ) {
         /*
@@ -1113,55 +1234,10 @@ void casioprint( int c, bool is_data )
     }
     else {
         if ( p == NULL ) {
-            
-            if ( EscapeMode ) {
-                /*
-                 *  UTF-8 takes precedence of escaping
-                 */
-                up = EscapeMode == UTF8_FX ? Utf8_FX
-                   : EscapeMode == UTF8_PB ? Utf8_PB
-                   : NULL;
-
-                if ( up != NULL ) {
-                    for ( ; up != NULL && up->text != NULL; ++up ) {
-                        if ( c == up->token ) {
-                            p = up->text;
-                            break;
-                        }
-                    }
-                }
-                else {
-                    /*
-                     *  Create escape sequences like \PI
-                     */
-                    ep = EscapeMode == ESC_FX ? Escapes_FX
-                       : EscapeMode == ESC_PB ? Escapes_PB
-                       : NULL;
-
-                    for ( ; ep != NULL && ep->text != NULL; ++ep ) {
-                        if ( c == ep->token ) {
-                            sprintf( buffer, "\\%s", ep->text );
-                            p = buffer;
-                            break;
-                        }
-                    }
-                }
-                if ( p == NULL && ( c >= 0x80 || c == '\\' ) ) {
-                    /*
-                     *  Hex escape
-                     */
-                    sprintf( buffer, "\\%02.2X", c );
-                    p = buffer;
-                }
-            }
-            if ( p == NULL ) {
-                /*
-                 *  Save character as string and point to it
-                 */
-                buffer[ 0 ] = (char) c;
-                buffer[ 1 ] = '\0';
-                p = buffer;
-            }
+            /*
+             *  Character, escape sequence or UTF-8 from precomputed table
+             */
+            p = CharTable[ c & 0xff ];
         }
 
         switch ( LogarithmMode ) {
@@ -1243,7 +1319,7 @@ void casioprint( int c, bool is_data )
                  *  Check for spaces and unprintable characters
                  */
                 if ( c < ' ' && c != '\n' ) {
-                    printf( "\\%02.2X", (unsigned char) c );
+                    fputs( HexTable[ (unsigned char) c ], stdout );
                 }
                 else if ( c == ' ' && *p == '\0' ) {
                     /*
@@ -1268,17 +1344,6 @@ void casioprint( int c, bool is_data )
 }
 
 
-/*
- *  Convert a BCD coded byte to binary
- */
-int bcd2bin( int c )
-{
-    int x;
-    x = c / 16;
-    return c - 6 * x;
-}
-
-
 /*
  *  Handle next character from file
  *
@@ -1960,6 +2025,7 @@ int list( int c )
                  *  Wrong escape mode, correct it
                  */
                 EscapeMode = ESC_PB;
+                buildCharTable();
             }
             ignore_counter = Fp200 ? 2 : 1;
             dataseg_expected = TRUE;
@@ -1974,6 +2040,293 @@ int list( int c )
 }
 
 
+/*
+ *  Collect a file from the disk image
+ *  Follows the FAT chain and strips the EOF padding of the last block
+ *  Returns the size or -1 if the chain is broken or longer than the disk
+ */
+long readDiskFile( struct _dir_entry *entry, unsigned char *dest )
+{
+    unsigned char *fat = DiskImage;
+    int i, next, sectors;
+    int blocks = 0;
+    long size = 0;
+
+    i = entry->block[ 0 ] << 8 | entry->block[ 1 ];
+
+    while ( i != 0 ) {
+        i &= FB_BLOCK;
+        if ( i >= DiskBlocks || ++blocks > DiskBlocks ) {
+            /*
+             *  Block outside the image or a cycle in the chain
+             */
+            return -1;
+        }
+        next = fat[ 2 * i ] << 8 | fat[ 2 * i + 1 ];
+        if ( !( next & FB_IN_USE ) ) {
+            return -1;
+        }
+        if ( next & FB_LAST ) {
+            /*
+             *  Partial last block, search backwards for EOF_CHAR
+             */
+            sectors = ( ( next & FB_SECTORS ) >> 12 ) + 1;
+            memcpy( dest + size, DiskImage + i * SIZE_BLOCK, 
+                    sectors * SIZE_SECTOR );
+            size += sectors * SIZE_SECTOR;
+            for ( i = 1; i <= SIZE_SECTOR; ++i ) {
+                if ( dest[ size - i ] == EOF_CHAR ) {
+                    size -= i;
+                    break;
+                }
+            }
+            break;
+        }
+        memcpy( dest + size, DiskImage + i * SIZE_BLOCK, SIZE_BLOCK );
+        size += SIZE_BLOCK;
+        i = next;
+    }
+    return size;
+}
+
+
+/*
+ *  List a single file of the disk image to stdout
+ *  BASIC and machine code files have a header and go through list(),
+ *  text files are copied.
+ *  Invalid data is reported in the listing like in single file mode.
+ */
+void listDiskFile( struct _dir_entry *entry, unsigned char *data, long size )
+{
+    long position;
+    int err_code;
+
+    switch ( entry->type ) {
+
+    case DTYPE_B:
+    case DTYPE_M:
+        for ( position = 0; position < size; ++position ) {
+            if ( ( err_code = list( data[ position ] ) ) != 0 ) {
+                printf( "\nInvalid data @%04.4lX \\%02.2X - %s.\n",
+                         position, data[ position ], err_msg[ err_code ] );
+                break;
+            }
+        }
+        list( EOF );
+        break;
+
+    case DTYPE_R:
+        /*
+         *  Records of 256 bytes, strip trailing blanks
+         */
+        for ( position = 0; position < size; position += SIZE_SECTOR ) {
+            int l = size - position < SIZE_SECTOR ? size - position 
+                                                  : SIZE_SECTOR;
+            while ( l > 0 && data[ position + l - 1 ] == ' ' ) --l;
+            printf( "%4ld: %.*s\n", position / SIZE_SECTOR + 1, 
+                    l, data + position );
+        }
+        break;
+
+    default:
+        /*
+         *  Text file
+         */
+        for ( position = 0; position < size; ++position ) {
+            if ( data[ position ] != '\r' ) {
+                putchar( data[ position ] );
+            }
+        }
+    }
+}
+
+
+/*
+ *  Letter of a file type, the same md100 shows
+ */
+void diskTypeName( char *dest, int type )
+{
+    switch ( type ) {
+    case DTYPE_B: strcpy( dest, "B" ); break;
+    case DTYPE_C: strcpy( dest, "C" ); break;
+    case DTYPE_M: strcpy( dest, "M" ); break;
+    case DTYPE_R: strcpy( dest, "R" ); break;
+    case DTYPE_S: strcpy( dest, "S" ); break;
+    default:      sprintf( dest, "%02X", type );
+    }
+}
+
+
+/*
+ *  List all files of an MD100 disk image into a directory
+ *  Each file is listed by a separate worker process because list()
+ *  keeps its state in static variables.
+ *  Two entries with the same name and type get a running number,
+ *  listings of earlier runs are overwritten.
+ */
+int listDisk( char *image, char *dir )
+{
+    FILE *fp;
+    struct _dir_entry *entry;
+    unsigned char *data;
+    char name[ 8 + 1 + 3 + 1 ];
+    char type[ 3 ];
+    char *out;
+    char done[ MAX_DIR_ENTRY ][ sizeof( name ) + sizeof( type ) ];
+    long size;
+    int i, j, k, l, n, running = 0, status, err = 0;
+#ifdef __unix__
+    int fd;
+#endif
+
+    /*
+     *  Load the complete image
+     */
+    DiskImage = malloc( MAX_BLOCKS * SIZE_BLOCK );
+    data = malloc( MAX_BLOCKS * SIZE_BLOCK );
+    out = malloc( strlen( dir ) + sizeof( name ) + sizeof( type ) + 10 );
+    if ( DiskImage == NULL || data == NULL || out == NULL ) {
+        perror( "Allocate memory for disk image" );
+        return 2;
+    }
+    if ( ( fp = fopen( image, "rb" ) ) == NULL ) {
+        fprintf( stderr, "\nCannot open the file %s\n", image );
+        perror( "error" );
+        return 2;
+    }
+    DiskBlocks = fread( DiskImage, SIZE_BLOCK, MAX_BLOCKS, fp );
+    fclose( fp );
+    if ( DiskBlocks <= START_DIR + 3 ) {
+        fprintf( stderr, "%s is not an MD100 disk image\n", image );
+        return 2;
+    }
+
+    entry = (struct _dir_entry *) ( DiskImage + START_DIR * SIZE_BLOCK );
+
+    for ( i = 0; i < MAX_DIR_ENTRY; ++i, ++entry ) {
+
+        if ( entry->type == 0 ) {
+            /*
+             *  Entry is unused
+             */
+            continue;
+        }
+
+        /*
+         *  Build the name of the listing: <dir>/<name>.<ext>.<type>.txt
+         */
+        for ( l = 8; l > 0 && entry->name[ l - 1 ] == ' '; --l );
+        memcpy( name, entry->name, l );
+        j = l;
+        for ( l = 3; l > 0 && entry->ext[ l - 1 ] == ' '; --l );
+        if ( l > 0 ) {
+            name[ j++ ] = '.';
+            memcpy( name + j, entry->ext, l );
+            j += l;
+        }
+        name[ j ] = '\0';
+        while ( j-- > 0 ) {
+            if ( name[ j ] < ' ' || strchr( ":\\/*?[]", name[ j ] ) != NULL ) {
+                name[ j ] = '_';
+            }
+        }
+        diskTypeName( type, entry->type );
+
+        /*
+         *  Count the entries of this run with the same name and type,
+         *  the second one becomes <dir>/<name>.<ext>.<type>.2.txt
+         */
+        sprintf( done[ i ], "%s.%s", name, type );
+        for ( n = 1, k = 0; k < i; ++k ) {
+            if ( strcmp( done[ k ], done[ i ] ) == 0 ) {
+                ++n;
+            }
+        }
+        if ( n == 1 ) {
+            sprintf( out, "%s/%s.txt", dir, done[ i ] );
+        }
+        else {
+            sprintf( out, "%s/%s.%d.txt", dir, done[ i ], n );
+        }
+
+        size = readDiskFile( entry, data );
+        if ( size < 0 ) {
+            fprintf( stderr, "%s: broken FAT chain\n", name );
+            err = 1;
+            continue;
+        }
+        printf( "%-12s %6ld -> %s\n", name, size, out );
+        fflush( stdout );
+
+#ifdef __unix__
+        if ( running == Workers ) {
+            /*
+             *  Wait for a free worker
+             */
+            wait( &status );
+            --running;
+            if ( !WIFEXITED( status ) || WEXITSTATUS( status ) != 0 ) {
+                err = 1;
+            }
+        }
+        /*
+         *  Create the listing here, so an error shows up in the order
+         *  of the directory
+         */
+        fd = open( out, O_WRONLY | O_CREAT | O_TRUNC, 0666 );
+        if ( fd < 0 ) {
+            perror( out );
+            err = 1;
+            continue;
+        }
+        switch ( fork() ) {
+
+        case -1:
+            perror( "fork" );
+            close( fd );
+            return 2;
+
+        case 0:
+            /*
+             *  Worker: list the file and quit
+             */
+            if ( dup2( fd, fileno( stdout ) ) < 0 ) {
+                perror( out );
+                _exit( 2 );
+            }
+            close( fd );
+            setvbuf( stdout, NULL, _IOFBF, OUTPUT_BUFFER );
+            listDiskFile( entry, data, size );
+            _exit( fflush( stdout ) != 0 ? 2 : 0 );
+
+        default:
+            close( fd );
+            ++running;
+        }
+#else
+        /*
+         *  Without worker processes, the state of list() can't be reset
+         */
+        fprintf( stderr, "Listing disk images is not supported\n" );
+        return 2;
+#endif
+    }
+
+#ifdef __unix__
+    while ( running-- > 0 ) {
+        /*
+         *  Wait for the remaining workers
+         */
+        wait( &status );
+        if ( !WIFEXITED( status ) || WEXITSTATUS( status ) != 0 ) {
+            err = 1;
+        }
+    }
+#endif
+    return err;
+}
+
+
 /*
  *  Main program
  */
@@ -1989,6 +2342,7 @@ int main( int argc, char *argv[] )
     int skip = 0;
     enum { NO, SLOW, FAST, HIGH } wavemode = NO;
     int ignore = FALSE;
+    char *disk_dir = NULL;
 
     ++argv;
     --argc;
@@ -2006,6 +2360,11 @@ int main( int argc, char *argv[] )
             BinMode = TRUE;
             DiskMode = TRUE;
         }
+        if ( strncmp( *argv, "-m", 2 ) == 0 ) {
+            BinMode = TRUE;
+            DiskMode = TRUE;
+            disk_dir = (*argv)[ 2 ] != '\0' ? *argv + 2 : ".";
+        }
         if ( strncmp( *argv, "-a", 2 ) == 0 ) {
             BinMode = FALSE;
             skip = atoi( *argv + 2 );
@@ -2074,6 +2433,9 @@ int main( int argc, char *argv[] )
                 "         -b<skip> reads a binary file, "
                           "<skip> is an optional offset\n"
                 "         -d reads a file copied from an MD100 disk\n" 
+                "         -m[<dir>] lists all files of an MD100 disk image\n"
+                "           into <dir>/<name>.<ext>.<type>.txt, <dir> defaults to .\n"
+                "           a repeated name gets a number, <name>.<ext>.<type>.2.txt\n"
                 "         -i ignores any errors on the input stream\n"
                 "         -e[F|P|X] use backslash escapes in strings\n"
                 "           F: FX-850P extended character set\n"
@@ -2088,6 +2450,25 @@ int main( int argc, char *argv[] )
         return 2;
     }
 
+    /*
+     *  Prepare output
+     */
+    setvbuf( stdout, NULL, _IOFBF, OUTPUT_BUFFER );
+    buildCharTable();
+
+    if ( disk_dir != NULL ) {
+        /*
+         *  List a complete disk image
+         */
+#ifdef _SC_NPROCESSORS_ONLN
+        Workers = (int) sysconf( _SC_NPROCESSORS_ONLN );
+        if ( Workers < 1 ) {
+            Workers = 1;
+        }
+#endif
+        return listDisk( *argv, disk_dir ) != 0 ? 2 : 0;
+    }
+
     if ( wavemode ) {
         /*
          *  Open WAV file
@@ -13,12 +13,20 @@
  *   09.12.2010 1.4 added -eC for compatibility and pipe input for put        
  *   14.03.2015 1.5 new info about "flag" and "null" byte in directory
  *                  FAT mask and variable disk size
+ *   19.10.2026 1.6 image is loaded once, changed blocks are written back
+ *                  batch command
+ *                  contiguous allocation, defrag command
+ *                  patterns are compiled, directory index
+ *                  export command
+ *                  catalog and query commands
+ *                  search command
  */
 
 #define DEBUG 0
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdarg.h>
 #include <errno.h>
 #include <string.h>
 #include <ctype.h>
@@ -40,6 +48,16 @@
 #define memicmp  _memicmp
 #endif
 
+#include <sys/stat.h>
+#if defined(_WIN32)
+#include <direct.h>
+#define makeDir( name ) _mkdir( name )
+#define fullPath( name ) _fullpath( NULL, name, 0 )
+#else
+#define makeDir( name ) mkdir( name, 0777 )
+#define fullPath( name ) realpath( name, NULL )
+#endif
+
 /*
  *  Constants
  */
@@ -127,8 +145,42 @@ typedef struct _file_info {
     long           remaining;   /* bytes to read */
     DIR_ENTRY      *entry;      /* original directory entry */
     ERROR          error;       /* Copy or Rename failed */
+    unsigned short reserve;     /* expected number of blocks when writing */
 } FILE_INFO;
 
+/*
+ *  Run of free blocks
+ */
+typedef struct _extent {
+    unsigned short start;
+    unsigned short length;
+} EXTENT;
+
+/*
+ *  Compiled file pattern
+ */
+typedef struct _pattern {
+    char text[ 8 + 3 ];         /* expanded, upper case if ignoreCase */
+    unsigned char pos[ 8 + 3 ]; /* positions which are no '?' */
+    int count;                  /* number of positions to compare */
+    int ignoreCase;
+} PATTERN;
+
+/*
+ *  Directory index, used entries in directory order
+ */
+#define HASH_SIZE 256
+
+typedef struct _dir_index {
+    int valid;
+    int used;                              /* number of used entries */
+    short order[ MAX_DIR_ENTRY ];          /* all used entries */
+    short byType[ MAX_DIR_ENTRY ];         /* grouped by type */
+    short typeStart[ 256 + 1 ];            /* start of group in byType */
+    short hash[ HASH_SIZE ];               /* first entry + 1 per name */
+    short next[ MAX_DIR_ENTRY ];           /* next entry + 1, same hash */
+} DIR_INDEX;
+
 /*
  *  Option -l or -u
  */
@@ -171,10 +223,31 @@ typedef struct _options {
     int           noUpdate;    /* -n */
     int           create;      /* -c */
     int           size;        /* argument to -c */
+    int           prune;       /* -r */
 } OPTIONS;
 
 #define DEFAULT_OPTIONS \
-    { FALSE, AS_IS, 0, "", -1, AUTO, FALSE, NULL, FALSE, FALSE, DEFAULT_BLOCKS }
+    { FALSE, AS_IS, 0, "", -1, AUTO, FALSE, NULL, FALSE, FALSE, DEFAULT_BLOCKS, \
+      FALSE }
+
+/*
+ *  Limits for batch scripts
+ */
+#define MAX_LINE 1024
+#define MAX_ARGS 64
+
+/*
+ *  Image in a catalog
+ */
+typedef struct _catalog_entry {
+    char *image;                /* path relative to the catalog or absolute */
+    long  mtime;                /* modification time of the image */
+    long  size;                 /* size of the image */
+    char *files;                /* file records, one per line */
+} CATALOG_ENTRY;
+
+#define CATALOG_HEADER "md100 catalog 1\n"
+#define SIZE_RECORD ( 64 + 8 + 3 + 13 )
 
 /*
  *  Types as Strings
@@ -405,12 +478,21 @@ ESCAPE Escapes[] =
  */
 char *MyName;
 char *DiskName;
+int Direct = FALSE;           /* drive instead of image file */
 int MustUpdate = FALSE;
 int Blocks = DEFAULT_BLOCKS;
 unsigned char FAT_Block[ SIZE_BLOCK * BLOCKS_FAT ];
 unsigned char DirBlocks[ SIZE_BLOCK * BLOCKS_DIR ];
 DIR_ENTRY *Directory = (DIR_ENTRY *) DirBlocks;
 unsigned char Block[ SIZE_BLOCK ];
+EXTENT FreeMap[ MAX_BLOCKS / 2 + 1 ];
+int FreeExtents = 0;
+int FreeMapValid = FALSE;
+DIR_INDEX DirIndex;
+int CatalogMode = FALSE;
+char *Text = NULL;
+size_t TextLength = 0;
+size_t TextSize = 0;
 
 /*
  *  Local functions
@@ -420,13 +502,28 @@ int doCmd( int argc, char **argv, OPTIONS *options );
 int parseOptions( int *argcp, char ***argvp, OPTIONS *options, char *opts );
 int cmdDir(  int argc, char **argv, OPTIONS *options );
 int cmdType( int argc, char **argv, OPTIONS *options );
+int cmdSearch( int argc, char **argv, OPTIONS *options );
 int cmdGet(  int argc, char **argv, OPTIONS *options );
 int cmdMget( int argc, char **argv, OPTIONS *options );
+int cmdExport( int argc, char **argv, OPTIONS *options );
 int cmdPut(  int argc, char **argv, OPTIONS *options );
 int cmdMput( int argc, char **argv, OPTIONS *options );
 int cmdDel(  int argc, char **argv, OPTIONS *options );
 int cmdRen(  int argc, char **argv, OPTIONS *options );
 int cmdSet(  int argc, char **argv, OPTIONS *options );
+int cmdBatch( int argc, char **argv, OPTIONS *options );
+int cmdDefrag( int argc, char **argv, OPTIONS *options );
+int cmdCatalog( int argc, char **argv, OPTIONS *options );
+int cmdQuery( int argc, char **argv, OPTIONS *options );
+int readCatalog( char *name, CATALOG_ENTRY **catalog, int *count );
+char *catalogDir( char *name );
+char *catalogPath( char *dir, char *image );
+char *imagePath( char *dir, char *image );
+int isAbsolute( char *path );
+int writeCatalog( char *name, CATALOG_ENTRY *catalog, int count );
+void freeCatalog( CATALOG_ENTRY *catalog, int count );
+char *catalogImage( char *image );
+int splitLine( char *line, char **args, int max );
 char *getFile( FILE_INFO *info, char *dest, MODE mode, ESCAPE_MODE escape );
 FILE_INFO *putFile( char *source, char *dest, MODE mode, ESCAPE_MODE escape, 
                     CASE setCase, int type, int protect, int noUpdate );
@@ -435,9 +532,17 @@ FILE_INFO *renFile( FILE_INFO *info, char *newName, CASE setCase );
 FILE_INFO *setFile( FILE_INFO *info, int type, int protect );
 int printFile( FILE_INFO *info, MODE mode, ESCAPE_MODE escape, FILE *out );
 void printToken( int c, ESCAPE_MODE esc, FILE *out );
+void putOut( int c, FILE *out );
+void writeOut( const void *data, size_t length, FILE *out );
+void printOut( FILE *out, const char *format, ... );
+char *findText( char *line, size_t length, const char *text, int ignoreCase );
 FILE_INFO *fileInfo( DIR_ENTRY *dptr, FILE_INFO *info, CASE setCase );
 DIR_ENTRY *findFile( char *pattern, int ignoreCase, int type, int protect );
 int isWildcard( char *pattern );
+void compilePattern( char *pattern, PATTERN *compiled, int ignoreCase );
+int matchPattern( PATTERN *compiled, DIR_ENTRY *dptr );
+int nameHash( const char *name );
+void buildDirIndex( void );
 void expandPattern( char *pattern, char expPattern[ 8 + 3 + 1 ],
                     CASE setCase );
 int readFile( FILE_INFO *info );
@@ -445,8 +550,14 @@ int writeFile( FILE_INFO *info, int count, int noUpdate );
 int diskFree( void );
 int dirFree( void );
 int findFreeBlock( int start );
+void buildFreeMap( void );
+int findFreeExtent( int count );
+int fileFragments( FILE_INFO *info );
+unsigned long fileCrc( FILE_INFO *info );
 int updateDisk( void );
 int openDisk( char *name, int create, int size, int noUpdate );
+int flushDisk( void );
+void discardDisk( void );
 int closeDisk( void );
 int readBlocks( void *dest, int number, int count );
 int writeBlocks( void *source, int number, int count );
@@ -488,6 +599,19 @@ int main( int argc, char **argv )
     DiskName = *argv;
     ++argv;
     --argc;
+    if ( argc > 0 && ( 0 == stricmp( *argv, "catalog" )
+                    || 0 == stricmp( *argv, "query" ) ) )
+    {
+        /*
+         *  The catalog commands work on a catalog file, not on an image
+         */
+        CatalogMode = TRUE;
+        if ( OK != doCmd( argc, argv, &options ) ) {
+            fprintf( stderr, "\007Command failed\n" );
+            return 2;
+        }
+        return 0;
+    }
     if ( OK != openDisk( DiskName, options.create, options.size, options.noUpdate ) ) {
         return 2;
     }
@@ -542,8 +666,15 @@ int usage( void )
              "       <cmd> <parameters> is one of:\n"
              "         dir  <options> \"<md100-pattern>\"\n"
              "         type <options> <md100-file>\n"
+             "         search <options> <text> [\"<md100-pattern>\"]\n"
+             "              lists the lines of the files which contain"
+                            " <text>\n"
              "         get  <options> <md100-file> [<pc-file>]\n"
              "         mget <options> \"<md100-pattern>\"\n"
+             "         export <options> [\"<md100-pattern>\"]\n"
+             "              copies all files to a directory (-d, default is"
+                            " the\n"
+             "              image name), writes manifest.txt\n"
              "         put  <options> <pc-file> [<md100-file>]\n"
              "              <pc-file> may be \"stdin\" or \"stdin.EXT\""
                             " to allow piping\n"
@@ -551,6 +682,22 @@ int usage( void )
              "         del  <options> \"<md100-pattern>\"\n"
              "         ren  <options> <md100-file> <new name>\n"
              "         set  <options> \"<md100-pattern>\" -t<type> -p<protect>\n"
+             "         batch <options> [<script>]\n"
+             "              runs the commands in <script> (default stdin),\n"
+             "              one per line, -n reports the result only,\n"
+             "              works on image files, not on drives\n"
+             "         defrag <options>\n"
+             "              makes all files contiguous, compacts the"
+                            " directory,\n"
+             "              -n lists the fragmented files only\n"
+             "       %s <catalog> catalog <options> [<images>]\n"
+             "              adds or updates the images in <catalog>, without"
+                            " images\n"
+             "              all images in <catalog> are checked again, -r removes\n"
+             "              the images which no longer exist\n"
+             "       %s <catalog> query <options> \"<md100-pattern>\"\n"
+             "              lists the matching files of all images in"
+                            " <catalog>\n"
              "       <options> are:\n"
              "         -i   ignore the case of md100-file(s)\n"
              "         -l   make all files lowercase\n"
@@ -563,9 +710,10 @@ int usage( void )
              "         -n   no updates are written to the image\n"
              "         -cS  create a new image if the file does not exist\n"
              "              S is the size (default 320, maximum 512)\n"
+             "         -r   remove missing images from the catalog\n"
              "       Patterns are DOS style, use \"*.*\" for all files\n"
              "       Wildcard expansion on local files depends on platform\n",
-             MyName );
+             MyName, MyName, MyName );
     return 2;
 }
 
@@ -584,8 +732,10 @@ int doCmd( int argc, char **argv, OPTIONS *options )
         { "dir",    cmdDir,  "nfpt   ilu " },
         { "type",   cmdType, "nfptabei   " },
         { "list",   cmdType, "nfptabei   " }, /* alias */
+        { "search", cmdSearch, "nfptabei   " },
         { "get",    cmdGet,  "nfptabeilud" },
         { "mget",   cmdMget, "nfptabeilud" },
+        { "export", cmdExport, "nfptabeilud" },
         { "put",    cmdPut,  "nfptabe lu " },
         { "mput",   cmdMput, "nfptabe lud" },
         { "del",    cmdDel,  "nfpt   i   " },
@@ -593,6 +743,10 @@ int doCmd( int argc, char **argv, OPTIONS *options )
         { "ren",    cmdRen,  "nfpt   ilu " },
         { "rename", cmdRen,  "nfpt   ilu " }, /* alias */
         { "set",    cmdSet,  "nfpt   i   " },
+        { "batch",  cmdBatch, "n          " },
+        { "defrag", cmdDefrag, "n          " },
+        { "catalog", cmdCatalog, "n         r" },
+        { "query",  cmdQuery, " fpt   i   " },
         { NULL,     NULL,    NULL          }
     };
     struct _cmds *cptr = cmds;
@@ -650,7 +804,8 @@ int doCmd( int argc, char **argv, OPTIONS *options )
 
 
 /*
- *  Parse options -i, -u, -l, -tX, (-fXX obsolete), -pX, -a, -b, -e, -d, -n, -c
+ *  Parse options -i, -u, -l, -tX, (-fXX obsolete), -pX, -a, -b, -e, -d, -n, -c,
+ *  -r
  */
 int parseOptions( int *argcp, char ***argvp, OPTIONS *options, char *opts )
 {
@@ -695,6 +850,12 @@ int parseOptions( int *argcp, char ***argvp, OPTIONS *options, char *opts )
             options->size   = size;
             options->create = TRUE;
         }
+        else if ( opt == 'r' ) {
+            /*
+             *  Remove missing images from a catalog
+             */
+            options->prune = TRUE;
+        }
         else if ( opt == 'i' ) {
             /*
              *  Ignore case
@@ -1003,6 +1164,105 @@ int cmdType( int argc, char **argv, OPTIONS *options )
 }
 
 
+/*
+ *  search <options> <text> [<md100-pattern> ...]
+ *  List the lines of the files which contain the text, the files are
+ *  listed to memory as type would show them
+ */
+int cmdSearch( int argc, char **argv, OPTIONS *options )
+{
+    char *text;
+    char *pattern;
+    FILE_INFO *info = NULL;
+    char *line, *end, *last;
+    int lineNr, number;
+    int count;
+    int hits = 0;
+    int files = 0;
+    int found;
+    char *p;
+
+    if ( argc < 1 ) {
+        return usage();
+    }
+    text = *argv++;
+    --argc;
+    pattern = argc > 0 ? *argv : "*";
+
+    /*
+     *  Search all files for all patterns on command line
+     */
+    do {
+        /*
+         *  Loop over all files
+         */
+        count = 0;
+        p = pattern;
+        while ( TRUE ) {
+            info = fileInfo( findFile( p, options->ignoreCase,
+                                          options->type,
+                                          options->protect ),
+                             info, options->setCase );
+            if ( info == NULL ) {
+                break;
+            }
+            p = NULL;
+            ++count;
+
+            TextLength = 0;
+            if ( OK != printFile( info, options->mode, options->escape, 
+                                  NULL ) ) 
+            {
+                fprintf( stderr, "%s: Error reading file\n", info->name );
+                return NOT_OK;
+            }
+
+            /*
+             *  Check line by line
+             */
+            found = FALSE;
+            last = Text + TextLength;
+            for ( line = Text, lineNr = 1; line < last;
+                  line = end + 1, ++lineNr )
+            {
+                end = (char *) memchr( line, '\n', last - line );
+                if ( end == NULL ) {
+                    end = last;
+                }
+                if ( NULL == findText( line, end - line, text,
+                                       options->ignoreCase ) )
+                {
+                    continue;
+                }
+
+                /*
+                 *  BASIC lines are identified by their own number
+                 */
+                number = lineNr;
+                if ( info->type == TYPE_B && options->mode != BINARY
+                  && isdigit( (unsigned char) *line ) )
+                {
+                    number = atoi( line );
+                }
+                printf( "%s:%d: %.*s\n", info->name, number,
+                        (int) ( end - line ), line );
+                ++hits;
+                found = TRUE;
+            }
+            files += found;
+        }
+        if ( count == 0 && argc > 0 ) {
+            fprintf( stderr, "%s: file not found\n", pattern );
+        }
+        pattern = argc > 0 ? *++argv : NULL;
+    } while ( --argc > 0 );
+
+    fprintf( stderr, "%d line%s found in %d file%s\n",
+             hits, hits == 1 ? "" : "s", files, files == 1 ? "" : "s" );
+    return OK;
+}
+
+
 /*
  *  get <options> <md100-file> [<destination>]
  */
@@ -1102,6 +1362,139 @@ int cmdMget( int argc, char **argv, OPTIONS *options )
 }
 
 
+/*
+ *  export <options> -d <directory> [<md100-pattern> ...]
+ *  Copy all files in one go and list them in a manifest
+ *  BASIC and data files are converted to text unless -b is given.
+ */
+int cmdExport( int argc, char **argv, OPTIONS *options )
+{
+    char dir[ FILENAME_MAX ];
+    char name[ FILENAME_MAX + 13 ];
+    char *pattern = argc > 0 ? *argv : "*";
+    MODE mode = options->mode == BINARY ? BINARY : ASCII;
+    FILE_INFO *info = NULL;
+    FILE_INFO copy;
+    FILE *manifest, *fp;
+    unsigned long crc;
+    long size;
+    int count;
+    int total = 0;
+    int l;
+    char *p;
+    char *dest;
+
+    /*
+     *  Destination directory, default is the image name without extension
+     */
+    if ( options->destination != NULL ) {
+        strncpy( dir, options->destination, FILENAME_MAX - 8 );
+        dir[ FILENAME_MAX - 8 ] = '\0';
+        l = (int) strlen( dir );
+    }
+    else {
+        strncpy( dir, DiskName, FILENAME_MAX - 8 );
+        dir[ FILENAME_MAX - 8 ] = '\0';
+        l = (int) strlen( dir );
+        while ( l > 0 && NULL == strchr( ".:/\\", dir[ l - 1 ] ) ) {
+            --l;
+        }
+        if ( l > 1 && dir[ l - 1 ] == '.'
+                   && NULL == strchr( ":/\\", dir[ l - 2 ] ) )
+        {
+            dir[ --l ] = '\0';
+        }
+        else {
+            /*
+             *  No extension
+             */
+            l = (int) strlen( dir );
+            strcpy( dir + l, ".dir" );
+            l += 4;
+        }
+    }
+    while ( l > 1 && ( dir[ l - 1 ] == '/' || dir[ l - 1 ] == '\\' ) ) {
+        dir[ --l ] = '\0';
+    }
+    if ( OK != makeDir( dir ) && errno != EEXIST ) {
+        perror( dir );
+        return NOT_OK;
+    }
+    strcpy( dir + l, "/" );
+
+    strcpy( name, dir );
+    strcat( name, "manifest.txt" );
+    manifest = fopen( name, "wt" );
+    if ( manifest == NULL ) {
+        perror( name );
+        return NOT_OK;
+    }
+    fprintf( manifest, "Image: %s\n\n", DiskName );
+    fprintf( manifest, "   Name     Type   Size  Blk  Prot  CRC-32     PC-Size"
+                       "  PC-File\n" );
+
+    /*
+     *  Export all files for all patterns on command line
+     */
+    do {
+        /*
+         *  Loop over all files
+         */
+        count = 0;
+        p = pattern;
+        while ( TRUE ) {
+            info = fileInfo( findFile( p, options->ignoreCase,
+                                          options->type,
+                                          options->protect ),
+                             info, options->setCase );
+            if ( info == NULL ) {
+                break;
+            }
+            p = NULL;
+            ++count;
+
+            /*
+             *  Checksum of the original data, then the copy
+             */
+            memcpy( &copy, info, sizeof( FILE_INFO ) );
+            crc = fileCrc( &copy );
+            dest = getFile( info, dir, mode, options->escape );
+            if ( dest == NULL ) {
+                fprintf( stderr, "%s: Error copying file\n", info->name );
+                fclose( manifest );
+                return NOT_OK;
+            }
+            size = -1;
+            fp = fopen( dest, "rb" );
+            if ( fp != NULL ) {
+                if ( fseek( fp, 0, SEEK_END ) == 0 ) {
+                    size = ftell( fp );
+                }
+                fclose( fp );
+            }
+            fprintf( manifest, "%-12s %2s  %6ld %4d    %2X  %08lX  %7ld  %s\n",
+                     info->name, info->typeS, info->size, info->blocks,
+                     info->protect, crc, size, dest + l + 1 );
+            printf( "%-12s %2s copied to %s\n",
+                    info->name, info->typeS, dest );
+        }
+        if ( count == 0 && argc > 0 ) {
+            fprintf( stderr, "%s: file not found\n", pattern );
+        }
+        total += count;
+        pattern = argc > 0 ? *++argv : NULL;
+    } while ( --argc > 0 );
+
+    if ( ferror( manifest ) | fclose( manifest ) ) {
+        perror( name );
+        return NOT_OK;
+    }
+    printf( "%d file%s exported to %s\n", total, total == 1 ? "" : "s",
+            dir );
+    return OK;
+}
+
+
 /*
  *  put <options> <pc-file> [<md100-file>]
  */
@@ -1405,78 +1798,914 @@ int cmdSet( int argc, char **argv, OPTIONS *options )
 
 
 /*
- *  Expand a file-pattern, DOS like, "*" is equivalent to "*.*"
+ *  batch <options> [<script>]
+ *  All commands run on the loaded image, changes are written once at the
+ *  end and only if every command succeeded.
+ *  A drive is written block by block while the commands run, the changes
+ *  could not be held back, so batch needs an image file.
  */
-void expandPattern( char *pattern, char expPattern[ 8 + 3 + 1 ], 
-                    CASE setCase )
+int cmdBatch( int argc, char **argv, OPTIONS *options )
 {
-    int i;
-    char c;
+    static OPTIONS defaults = DEFAULT_OPTIONS;
+    static char *all[] = { "*.*", NULL };
+    OPTIONS lineOptions;
+    unsigned char fat[ SIZE_BLOCK * BLOCKS_FAT ];
+    unsigned char dir[ SIZE_BLOCK * BLOCKS_DIR ];
+    char line[ MAX_LINE ];
+    char *args[ MAX_ARGS ];
+    char *script;
+    FILE *in;
+    int count;
+    int lineNr = 0;
+    int commands = 0;
+    int changed = FALSE;
+    int result = OK;
 
-    expPattern[ 8 + 3 ] = '\0';
+    if ( argc > 1 ) {
+        return usage();
+    }
+    if ( Direct ) {
+        fprintf( stderr, "%s: batch works on image files only, "
+                         "copy drive %s to an image first\n",
+                         MyName, DiskName );
+        return NOT_OK;
+    }
+    script = argc == 1 ? *argv : "stdin";
 
-    if ( pattern == NULL || 0 == strcmp( pattern, "*" ) ) {
+    if ( 0 == strcmp( script, "stdin" ) || 0 == strcmp( script, "-" ) ) {
+        in = stdin;
+    }
+    else {
+        in = fopen( script, "rt" );
+        if ( in == NULL ) {
+            perror( script );
+            return NOT_OK;
+        }
+    }
+
+    while ( result == OK && NULL != fgets( line, MAX_LINE, in ) ) {
         /*
-         *  "*": all files
+         *  Echo the command and split it into arguments
          */
-        memset( expPattern, '?', 8 + 3 );
-        return;
-    }
+        ++lineNr;
+        line[ strcspn( line, "\r\n" ) ] = '\0';
+        count = splitLine( line, args, MAX_ARGS );
+        if ( count == 0 ) {
+            continue;
+        }
+        if ( 0 == stricmp( args[ 0 ], "batch" ) ) {
+            fprintf( stderr, "%s(%d): batch cannot be nested\n",
+                             script, lineNr );
+            result = NOT_OK;
+            break;
+        }
+        printf( ">" );
+        for ( args[ count ] = NULL, argc = 0; argc < count; ++argc ) {
+            printf( " %s", args[ argc ] );
+        }
+        putchar( '\n' );
 
-    /*
-     *  Expand the pattern
-     */
-    i = 0;
-    memset( expPattern, ' ', 8 + 3 );
+        /*
+         *  Keep the FAT and directory for commands with option -n
+         */
+        memcpy( fat, FAT_Block, sizeof( fat ) );
+        memcpy( dir, DirBlocks, sizeof( dir ) );
+        lineOptions = defaults;
+        MustUpdate = FALSE;
 
-    while ( *pattern != '\0' && i < 8 + 3 ) {
-        if ( *pattern == '*' ) {
-            if ( i < 8 ) {
-                memset( expPattern + i, '?', 8 - i );
-                i = 8;
-            }
-            else {
-                memset( expPattern + i, '?', 8 + 3 - i );
-                i = 8 + 3;
-            }
+        result = doCmd( count, args, &lineOptions );
+        ++commands;
+
+        if ( lineOptions.noUpdate ) {
+            memcpy( FAT_Block, fat, sizeof( fat ) );
+            memcpy( DirBlocks, dir, sizeof( dir ) );
+            DirIndex.valid = FALSE;
         }
-        else if ( *pattern == '.' ) {
-            i = i < 8 ? 8 : 8 + 3;
+        else if ( MustUpdate ) {
+            changed = TRUE;
         }
-        else {
-            expPattern[ i ] = setCase == UPPER ? toupper( *pattern )
-                            : setCase == LOWER ? tolower( *pattern )
-                                               : *pattern;
-            ++i;
+        if ( result != OK ) {
+            fprintf( stderr, "%s(%d): %s failed, no changes written\n",
+                             script, lineNr, args[ 0 ] );
         }
-        if ( i == 8 ) {
-            while ( pattern[ 1 ] != '\0' && *pattern != '.' ) {
-                ++pattern;
-            }
+    }
+    if ( in != stdin ) {
+        fclose( in );
+    }
+
+    if ( result != OK || options->noUpdate ) {
+        /*
+         *  Nothing goes to the image
+         */
+        MustUpdate = FALSE;
+        discardDisk();
+        if ( result != OK ) {
+            return NOT_OK;
         }
-        ++pattern;
+        printf( "\nDry run, resulting directory:\n" );
+        cmdDir( 1, all, &defaults );
+        printf( "\n%d command%s, no changes written\n",
+                commands, commands == 1 ? "" : "s" );
+        return OK;
     }
-#if DEBUG
-    printf( "expandPattern: expanded pattern=\"%s\"\n", expPattern );
-#endif
+
+    printf( "\n%d command%s executed\n", commands, commands == 1 ? "" : "s" );
+    MustUpdate = changed;
+    return OK;
 }
 
 
 /*
- *  Copy a file to PC
+ *  defrag <options>
+ *  Move all files to the start of the disk, each in one piece, and
+ *  remove the gaps in the directory
  */
-char *getFile( FILE_INFO *info, char *dest, MODE mode, ESCAPE_MODE escape )
+int cmdDefrag( int argc, char **argv, OPTIONS *options )
 {
-    int count;
-    int i, j, l;
-    FILE *out;
-    int binary;
-    
+    FILE_INFO info;
+    DIR_ENTRY *dptr;
+    unsigned char *data, *p;
+    unsigned short last[ MAX_DIR_ENTRY ];
+    int blocks[ MAX_DIR_ENTRY ];
+    int i, j, k, n, next;
+    int files = 0;
+    int fragmented = 0;
+    int moved = 0;
+
+    if ( argc != 0 ) {
+        return usage();
+    }
+
     /*
-     *  Build destination filename
+     *  Check all chains
      */
-    if ( dest == NULL ) {
-        dest = "*";
+    for ( i = 0; i < MAX_DIR_ENTRY; ++i ) {
+        dptr = Directory + i;
+        if ( dptr->type == 0 ) {
+            continue;
+        }
+        fileInfo( dptr, &info, AS_IS );
+        n = fileFragments( &info );
+        if ( n == NOT_OK ) {
+            fprintf( stderr, "%s: Broken chain, disk not defragmented\n",
+                             info.name );
+            return NOT_OK;
+        }
+        ++files;
+        if ( n > 1 ) {
+            ++fragmented;
+            printf( "%-12s %2s %4d blocks in %d pieces\n",
+                    info.name, info.typeS, info.blocks, n );
+        }
+    }
+    if ( options->noUpdate ) {
+        printf( "%d of %d file%s fragmented\n",
+                fragmented, files, files == 1 ? " is" : "s are" );
+        return OK;
+    }
+
+    /*
+     *  Load the data of all files and compact the directory
+     */
+    data = malloc( (size_t) Blocks * SIZE_BLOCK );
+    if ( data == NULL ) {
+        perror( "defrag" );
+        return NOT_OK;
+    }
+    p = data;
+    for ( i = 0, k = 0; i < MAX_DIR_ENTRY; ++i ) {
+        dptr = Directory + i;
+        if ( dptr->type == 0 ) {
+            continue;
+        }
+        fileInfo( dptr, &info, AS_IS );
+        j = info.block & FB_BLOCK;
+        blocks[ k ] = 0;
+        while ( j != 0 ) {
+            if ( OK != readBlocks( p, j, 1 ) ) {
+                free( data );
+                return NOT_OK;
+            }
+            p += SIZE_BLOCK;
+            ++blocks[ k ];
+            last[ k ] = FAT_Block[ 2 * j ] << 8 | FAT_Block[ 2 * j + 1 ];
+
+            /*
+             *  Release the block
+             */
+            FAT_Block[ 2 * j ] = FAT_Block[ 2 * j + 1 ] = '\0';
+            j = last[ k ] & FB_LAST ? 0 : last[ k ] & FB_BLOCK;
+        }
+        if ( k != i ) {
+            memcpy( Directory + k, dptr, sizeof( DIR_ENTRY ) );
+        }
+        ++k;
+    }
+    memset( Directory + k, '\0', ( MAX_DIR_ENTRY - k ) * sizeof( DIR_ENTRY ) );
+
+    /*
+     *  Write all files back, one after the other
+     */
+    p = data;
+    next = START_DATA;
+    for ( i = 0; i < k; ++i ) {
+        dptr = Directory + i;
+        if ( blocks[ i ] == 0 ) {
+            continue;
+        }
+        if ( ( ( dptr->block[ 0 ] << 8 | dptr->block[ 1 ] ) & FB_BLOCK )
+             != findFreeBlock( next ) )
+        {
+            ++moved;
+        }
+        for ( n = 0; n < blocks[ i ]; ++n ) {
+            j = findFreeBlock( next );
+            if ( n == 0 ) {
+                dptr->block[ 0 ] = (unsigned char) ( j >> 8 );
+                dptr->block[ 1 ] = (unsigned char) j;
+            }
+            next = findFreeBlock( j + 1 );
+            if ( n == blocks[ i ] - 1 ) {
+                /*
+                 *  Keep the sector count of the last block
+                 */
+                next = ( last[ i ] & ( FB_IN_USE | FB_LAST | FB_SECTORS ) ) | j;
+            }
+            else {
+                next |= FB_IN_USE;
+            }
+            FAT_Block[ 2 * j ]     = (unsigned char) ( next >> 8 );
+            FAT_Block[ 2 * j + 1 ] = (unsigned char) next;
+            next = j + 1;
+
+            if ( OK != writeBlocks( p, j, 1 ) ) {
+                free( data );
+                return NOT_OK;
+            }
+            p += SIZE_BLOCK;
+        }
+    }
+    free( data );
+    FreeMapValid = FALSE;
+    DirIndex.valid = FALSE;
+    MustUpdate = TRUE;
+
+    printf( "%d file%s, %d moved\n", files, files == 1 ? "" : "s", moved );
+    return OK;
+}
+
+
+/*
+ *  catalog <options> [<images>]
+ *  Add or update images in a catalog file
+ *  Images are only read again if their size or time has changed.
+ *  The images are stored relative to the directory of the catalog, so
+ *  the catalog can be updated from anywhere. An image which can't be
+ *  found is kept unless -r is given.
+ */
+int cmdCatalog( int argc, char **argv, OPTIONS *options )
+{
+    CATALOG_ENTRY *catalog = NULL;
+    CATALOG_ENTRY *cp;
+    struct stat st;
+    char *dir;
+    char **names;
+    char *path;
+    char *files;
+    int count = 0;
+    int all = argc == 0;
+    int i, n;
+    int scanned = 0;
+    int removed = 0;
+    int missing = 0;
+    int complete;
+    int result = OK;
+
+    if ( !CatalogMode ) {
+        fprintf( stderr, "catalog: not allowed in a batch\n" );
+        return NOT_OK;
+    }
+    dir = catalogDir( DiskName );
+    names = (char **) calloc( argc + 1, sizeof( char * ) );
+    if ( dir == NULL || names == NULL ) {
+        perror( DiskName );
+        free( dir );
+        free( names );
+        return NOT_OK;
+    }
+    if ( OK != readCatalog( DiskName, &catalog, &count ) ) {
+        free( dir );
+        free( names );
+        return NOT_OK;
+    }
+
+    /*
+     *  Add new images
+     */
+    for ( i = 0; i < argc; ++i ) {
+        names[ i ] = catalogPath( dir, argv[ i ] );
+        if ( names[ i ] == NULL ) {
+            perror( argv[ i ] );
+            result = NOT_OK;
+            break;
+        }
+        for ( n = 0; n < count && 0 != strcmp( catalog[ n ].image, names[ i ] );
+              ++n );
+        if ( n < count ) {
+            continue;
+        }
+        cp = (CATALOG_ENTRY *)
+             realloc( catalog, ( count + 1 ) * sizeof( CATALOG_ENTRY ) );
+        if ( cp == NULL || NULL == ( cp[ count ].image = strdup( names[ i ] ) ) )
+        {
+            perror( DiskName );
+            result = NOT_OK;
+            if ( cp != NULL ) {
+                catalog = cp;
+            }
+            break;
+        }
+        catalog = cp;
+        cp += count++;
+        cp->mtime = cp->size = -1;
+        cp->files = NULL;
+    }
+    complete = i == argc;
+
+    /*
+     *  Check the images, unless adding them failed
+     */
+    for ( n = 0, cp = catalog; complete && n < count; ++n, ++cp ) {
+        for ( i = 0; !all && i < argc && 0 != strcmp( cp->image, names[ i ] );
+              ++i );
+        if ( !all && i == argc ) {
+            continue;
+        }
+        path = imagePath( dir, cp->image );
+        if ( path == NULL ) {
+            perror( cp->image );
+            result = NOT_OK;
+            break;
+        }
+        if ( 0 != stat( path, &st ) ) {
+            if ( cp->size < 0 ) {
+                /*
+                 *  New image which doesn't exist, not written
+                 */
+                fprintf( stderr, "%s: not found\n", cp->image );
+                result = NOT_OK;
+            }
+            else if ( options->prune ) {
+                /*
+                 *  Image is gone
+                 */
+                printf( "%s: removed\n", cp->image );
+                free( cp->files );
+                cp->files = NULL;
+                cp->size = -1;
+                ++removed;
+            }
+            else {
+                printf( "%s: not found, kept\n", cp->image );
+                ++missing;
+            }
+            free( path );
+            continue;
+        }
+        if ( cp->files != NULL
+          && (long) st.st_mtime == cp->mtime && (long) st.st_size == cp->size )
+        {
+            free( path );
+            continue;
+        }
+        files = catalogImage( path );
+        free( path );
+        if ( files == NULL ) {
+            result = NOT_OK;
+            continue;
+        }
+        printf( "%s: %s\n", cp->image, cp->files == NULL ? "added" : "updated" );
+        free( cp->files );
+        cp->files = files;
+        cp->mtime = (long) st.st_mtime;
+        cp->size = (long) st.st_size;
+        ++scanned;
+    }
+
+    if ( !options->noUpdate && ( scanned > 0 || removed > 0 ) ) {
+        if ( OK != writeCatalog( DiskName, catalog, count ) ) {
+            result = NOT_OK;
+        }
+    }
+    printf( "%d image%s read, %d removed", scanned,
+            scanned == 1 ? "" : "s", removed );
+    if ( missing > 0 ) {
+        printf( ", %d not found (-r removes %s)", missing,
+                missing == 1 ? "it" : "them" );
+    }
+    printf( "\n" );
+    freeCatalog( catalog, count );
+    for ( i = 0; i < argc; ++i ) {
+        free( names[ i ] );
+    }
+    free( names );
+    free( dir );
+    return result;
+}
+
+
+/*
+ *  query <options> <md100-pattern> ...
+ *  List the matching files of all images in a catalog
+ */
+int cmdQuery( int argc, char **argv, OPTIONS *options )
+{
+    CATALOG_ENTRY *catalog = NULL;
+    CATALOG_ENTRY *cp;
+    PATTERN *compiled;
+    DIR_ENTRY entry;
+    FILE_INFO info;
+    char *p;
+    unsigned long crc;
+    long size;
+    int type, blocks, protect;
+    int count = 0;
+    int found = 0;
+    int images = 0;
+    int i, n, l, match;
+
+    if ( !CatalogMode ) {
+        fprintf( stderr, "query: not allowed in a batch\n" );
+        return NOT_OK;
+    }
+    if ( argc < 1 ) {
+        return usage();
+    }
+    compiled = (PATTERN *) malloc( argc * sizeof( PATTERN ) );
+    if ( compiled == NULL ) {
+        perror( "query" );
+        return NOT_OK;
+    }
+    for ( i = 0; i < argc; ++i ) {
+        compilePattern( argv[ i ], compiled + i, options->ignoreCase );
+    }
+    if ( OK != readCatalog( DiskName, &catalog, &count ) ) {
+        free( compiled );
+        return NOT_OK;
+    }
+
+    for ( n = 0, cp = catalog; n < count; ++n, ++cp ) {
+        match = FALSE;
+        for ( p = cp->files; p != NULL && *p != '\0'; p += l ) {
+            /*
+             *  Type, size, blocks, protect, CRC and raw name
+             */
+            l = (int) ( strchr( p, '\n' ) + 1 - p );
+            if ( 5 != sscanf( p, "F %x %ld %d %x %lx ",
+                              &type, &size, &blocks, &protect, &crc ) )
+            {
+                continue;
+            }
+            memset( &entry, 0, sizeof( entry ) );
+            entry.type = (unsigned char) type;
+            entry.protect = (unsigned char) protect;
+            memcpy( entry.name, p + l - 1 - ( 8 + 3 ), 8 + 3 );
+
+            if ( ( options->type != 0
+                   && entry.type != (unsigned char) options->type )
+              || ( options->protect >= 0
+                   && entry.protect != (unsigned char) options->protect ) )
+            {
+                continue;
+            }
+            for ( i = 0; i < argc && !matchPattern( compiled + i, &entry );
+                  ++i );
+            if ( i == argc ) {
+                continue;
+            }
+            match = TRUE;
+            ++found;
+            fileInfo( &entry, &info, AS_IS );
+            printf( "%-12s %2s  %6ld %4d    %2X  %08lX  %s\n",
+                    info.name, info.typeS, size, blocks, protect, crc,
+                    cp->image );
+        }
+        images += match;
+    }
+    printf( "%d file%s found in %d image%s\n", found, found == 1 ? "" : "s",
+            images, images == 1 ? "" : "s" );
+    freeCatalog( catalog, count );
+    free( compiled );
+    return OK;
+}
+
+
+/*
+ *  Read a catalog file
+ *  A missing file is an empty catalog.
+ */
+int readCatalog( char *name, CATALOG_ENTRY **catalog, int *count )
+{
+    FILE *in;
+    CATALOG_ENTRY *cp = NULL;
+    char line[ MAX_LINE ];
+    char *p;
+    size_t used = 0;
+    int error = FALSE;
+    int n = 0;
+    int l;
+
+    *catalog = NULL;
+    *count = 0;
+    in = fopen( name, "rt" );
+    if ( in == NULL ) {
+        if ( errno == ENOENT ) {
+            /*
+             *  New catalog
+             */
+            return OK;
+        }
+        perror( name );
+        return NOT_OK;
+    }
+    if ( NULL == fgets( line, MAX_LINE, in )
+      || 0 != strcmp( line, CATALOG_HEADER ) )
+    {
+        fprintf( stderr, "%s: Not a catalog file\n", name );
+        fclose( in );
+        return NOT_OK;
+    }
+
+    while ( NULL != fgets( line, MAX_LINE, in ) ) {
+        l = (int) strlen( line );
+        if ( line[ 0 ] == 'I' && l > 2 ) {
+            /*
+             *  Next image: mtime, size and path
+             */
+            cp = (CATALOG_ENTRY *)
+                 realloc( *catalog, ( n + 1 ) * sizeof( CATALOG_ENTRY ) );
+            if ( cp == NULL ) {
+                error = TRUE;
+                break;
+            }
+            *catalog = cp;
+            cp += n++;
+            *count = n;
+            cp->image = NULL;
+            cp->files = NULL;
+            used = 0;
+            if ( 2 != sscanf( line, "I %ld %ld %n",
+                              &cp->mtime, &cp->size, &l )
+              || NULL == ( cp->image = strdup( line + l ) ) )
+            {
+                error = TRUE;
+                break;
+            }
+            cp->image[ strcspn( cp->image, "\n" ) ] = '\0';
+        }
+        else if ( line[ 0 ] == 'F' && cp != NULL
+                  && l > 8 + 3 + 1 && line[ l - 1 ] == '\n' )
+        {
+            /*
+             *  File record, kept as text
+             */
+            p = (char *) realloc( cp->files, used + l + 1 );
+            if ( p == NULL ) {
+                error = TRUE;
+                break;
+            }
+            cp->files = p;
+            strcpy( p + used, line );
+            used += l;
+        }
+    }
+    if ( error || ferror( in ) ) {
+        fprintf( stderr, "%s: Error reading catalog\n", name );
+        fclose( in );
+        freeCatalog( *catalog, *count );
+        *catalog = NULL;
+        *count = 0;
+        return NOT_OK;
+    }
+    fclose( in );
+    return OK;
+}
+
+
+/*
+ *  Absolute directory of a catalog file
+ *  Returns a new string or NULL
+ */
+char *catalogDir( char *name )
+{
+    char *dir, *p, *full;
+
+    dir = strdup( name );
+    if ( dir == NULL ) {
+        return NULL;
+    }
+    for ( p = dir + strlen( dir ); p > dir && p[ -1 ] != '/' && p[ -1 ] != '\\'
+                                   && p[ -1 ] != ':'; --p );
+    if ( p == dir ) {
+        strcpy( dir, "." );
+    }
+    else {
+        *p = '\0';
+    }
+    full = fullPath( dir );
+    free( dir );
+    return full;
+}
+
+
+/*
+ *  Check for an absolute path, "/x", "\x" or "C:x"
+ */
+int isAbsolute( char *path )
+{
+    return path[ 0 ] == '/' || path[ 0 ] == '\\'
+        || ( isalpha( (unsigned char) path[ 0 ] ) && path[ 1 ] == ':' );
+}
+
+
+/*
+ *  Name of an image in the catalog
+ *  An image below the directory of the catalog is stored relative to it,
+ *  else with its absolute path. Returns a new string or NULL.
+ */
+char *catalogPath( char *dir, char *image )
+{
+    char *full, *p;
+    size_t l = strlen( dir );
+
+    full = fullPath( image );
+    if ( full == NULL ) {
+        /*
+         *  Missing image, keep the name as given
+         */
+        return strdup( image );
+    }
+    if ( 0 == strncmp( full, dir, l )
+      && ( full[ l ] == '/' || full[ l ] == '\\' ) )
+    {
+        p = strdup( full + l + 1 );
+        free( full );
+        return p;
+    }
+    return full;
+}
+
+
+/*
+ *  Path of a catalog image to open it
+ *  Relative names are taken from the directory of the catalog.
+ *  Returns a new string or NULL.
+ */
+char *imagePath( char *dir, char *image )
+{
+    char *path;
+
+    if ( isAbsolute( image ) ) {
+        return strdup( image );
+    }
+    path = (char *) malloc( strlen( dir ) + 1 + strlen( image ) + 1 );
+    if ( path != NULL ) {
+        sprintf( path, "%s/%s", dir, image );
+    }
+    return path;
+}
+
+
+/*
+ *  Write a catalog file
+ *  The new catalog replaces the old one only if it is complete.
+ */
+int writeCatalog( char *name, CATALOG_ENTRY *catalog, int count )
+{
+    char tmp[ FILENAME_MAX + 5 ];
+    FILE *out;
+    int n;
+
+    strncpy( tmp, name, FILENAME_MAX );
+    tmp[ FILENAME_MAX ] = '\0';
+    strcat( tmp, ".tmp" );
+    out = fopen( tmp, "wt" );
+    if ( out == NULL ) {
+        perror( tmp );
+        return NOT_OK;
+    }
+    fputs( CATALOG_HEADER, out );
+    for ( n = 0; n < count; ++n, ++catalog ) {
+        if ( catalog->size < 0 ) {
+            /*
+             *  Removed image
+             */
+            continue;
+        }
+        fprintf( out, "I %ld %ld %s\n",
+                 catalog->mtime, catalog->size, catalog->image );
+        if ( catalog->files != NULL ) {
+            fputs( catalog->files, out );
+        }
+    }
+    if ( ferror( out ) | fclose( out ) ) {
+        perror( tmp );
+        remove( tmp );
+        return NOT_OK;
+    }
+    remove( name );
+    if ( 0 != rename( tmp, name ) ) {
+        perror( name );
+        return NOT_OK;
+    }
+    return OK;
+}
+
+
+/*
+ *  Release a catalog
+ */
+void freeCatalog( CATALOG_ENTRY *catalog, int count )
+{
+    int n;
+
+    for ( n = 0; n < count; ++n ) {
+        free( catalog[ n ].image );
+        free( catalog[ n ].files );
+    }
+    free( catalog );
+}
+
+
+/*
+ *  Read the directory of an image and build its file records
+ *  Each record holds type, size, blocks, protection, CRC-32 and the
+ *  name as stored in the directory.
+ */
+char *catalogImage( char *image )
+{
+    FILE_INFO info;
+    DIR_ENTRY *dptr;
+    char *files, *p;
+    int i;
+
+    files = (char *) malloc( MAX_DIR_ENTRY * SIZE_RECORD + 1 );
+    if ( files == NULL ) {
+        perror( image );
+        return NULL;
+    }
+    if ( OK != openDisk( image, FALSE, DEFAULT_BLOCKS, TRUE )
+      || OK != readBlocks( FAT_Block, START_FAT, BLOCKS_FAT )
+      || OK != readBlocks( DirBlocks, START_DIR, BLOCKS_DIR ) )
+    {
+        fprintf( stderr, "%s: Can't read disk directory\n", image );
+        closeDisk();
+        free( files );
+        return NULL;
+    }
+    DirIndex.valid = FALSE;
+    FreeMapValid = FALSE;
+
+    p = files;
+    *p = '\0';
+    for ( i = 0; i < MAX_DIR_ENTRY; ++i ) {
+        dptr = Directory + i;
+        if ( dptr->type == 0 ) {
+            continue;
+        }
+        fileInfo( dptr, &info, AS_IS );
+        p += sprintf( p, "F %02X %ld %d %X %08lX ",
+                      info.type, info.size, info.blocks, info.protect,
+                      fileCrc( &info ) );
+        memcpy( p, dptr->name, 8 + 3 );
+        p += 8 + 3;
+        *p++ = '\n';
+        *p = '\0';
+    }
+    closeDisk();
+    return files;
+}
+
+
+/*
+ *  Split a script line into arguments
+ *  Arguments are separated by blanks, double quotes protect blanks.
+ *  Lines starting with '#' are comments.
+ */
+int splitLine( char *line, char **args, int max )
+{
+    char *p = line;
+    char *q;
+    int count = 0;
+
+    while ( count < max - 1 ) {
+        while ( isspace( (unsigned char) *p ) ) {
+            ++p;
+        }
+        if ( *p == '\0' || ( count == 0 && *p == '#' ) ) {
+            break;
+        }
+        args[ count++ ] = q = p;
+
+        while ( *p != '\0' && !isspace( (unsigned char) *p ) ) {
+            if ( *p == '"' ) {
+                /*
+                 *  Quoted part
+                 */
+                ++p;
+                while ( *p != '\0' && *p != '"' ) {
+                    *q++ = *p++;
+                }
+                if ( *p == '"' ) {
+                    ++p;
+                }
+            }
+            else {
+                *q++ = *p++;
+            }
+        }
+        if ( *p != '\0' ) {
+            ++p;
+        }
+        *q = '\0';
+    }
+    return count;
+}
+
+
+/*
+ *  Expand a file-pattern, DOS like, "*" is equivalent to "*.*"
+ */
+void expandPattern( char *pattern, char expPattern[ 8 + 3 + 1 ], 
+                    CASE setCase )
+{
+    int i;
+    char c;
+
+    expPattern[ 8 + 3 ] = '\0';
+
+    if ( pattern == NULL || 0 == strcmp( pattern, "*" ) ) {
+        /*
+         *  "*": all files
+         */
+        memset( expPattern, '?', 8 + 3 );
+        return;
+    }
+
+    /*
+     *  Expand the pattern
+     */
+    i = 0;
+    memset( expPattern, ' ', 8 + 3 );
+
+    while ( *pattern != '\0' && i < 8 + 3 ) {
+        if ( *pattern == '*' ) {
+            if ( i < 8 ) {
+                memset( expPattern + i, '?', 8 - i );
+                i = 8;
+            }
+            else {
+                memset( expPattern + i, '?', 8 + 3 - i );
+                i = 8 + 3;
+            }
+        }
+        else if ( *pattern == '.' ) {
+            i = i < 8 ? 8 : 8 + 3;
+        }
+        else {
+            expPattern[ i ] = setCase == UPPER ? toupper( *pattern )
+                            : setCase == LOWER ? tolower( *pattern )
+                                               : *pattern;
+            ++i;
+        }
+        if ( i == 8 ) {
+            while ( pattern[ 1 ] != '\0' && *pattern != '.' ) {
+                ++pattern;
+            }
+        }
+        ++pattern;
+    }
+#if DEBUG
+    printf( "expandPattern: expanded pattern=\"%s\"\n", expPattern );
+#endif
+}
+
+
+/*
+ *  Copy a file to PC
+ */
+char *getFile( FILE_INFO *info, char *dest, MODE mode, ESCAPE_MODE escape )
+{
+    int count;
+    int i, j, l;
+    FILE *out;
+    int binary;
+    
+    /*
+     *  Build destination filename
+     */
+    if ( dest == NULL ) {
+        dest = "*";
     }
     l = strlen( dest );
     if ( dest[ l - 1 ] == '*'
@@ -1808,6 +3037,7 @@ FILE_INFO *putFile( char *source, char *dest, MODE mode, ESCAPE_MODE escape,
      *  Update the directory
      */
     memcpy( info->entry, &newEntry, sizeof( DIR_ENTRY ) );
+    DirIndex.valid = FALSE;
     MustUpdate = TRUE;
 
     /*
@@ -1821,8 +3051,9 @@ FILE_INFO *putFile( char *source, char *dest, MODE mode, ESCAPE_MODE escape,
     }
 
     /*
-     *  Now copy the data
+     *  Now copy the data, try to keep the file in one piece
      */
+    info->reserve = (unsigned short) ( length / SIZE_BLOCK + 1 );
     errno = 0;
     length = 0;
     clearBlockBuffer();
@@ -1990,6 +3221,7 @@ void delFile( FILE_INFO *info )
          *  Mark block as free
          */
         FAT_Block[ j ] = FAT_Block[ j + 1 ] = '\0';
+        FreeMapValid = FALSE;
 
         if ( i & FB_LAST ) {
             /*
@@ -2003,6 +3235,7 @@ void delFile( FILE_INFO *info )
      *  Delete directory entry
      */
     memset( info->entry, '\0', sizeof( DIR_ENTRY ) );
+    DirIndex.valid = FALSE;
 
     info->next = 0;
     MustUpdate = TRUE;
@@ -2067,6 +3300,7 @@ FILE_INFO *renFile( FILE_INFO *info, char *newName, CASE setCase )
          */
         memcpy( info->entry->name, newPattern, 8 + 3 );
         fileInfo( info->entry, &newInfo, AS_IS );
+        DirIndex.valid = FALSE;
         MustUpdate = TRUE;
     }
     return &newInfo;
@@ -2089,6 +3323,7 @@ FILE_INFO *setFile( FILE_INFO *info, int type, int protect )
     if ( protect >= 0 ) {
         info->entry->protect = (unsigned char) protect;
     }
+    DirIndex.valid = FALSE;
     MustUpdate = TRUE;
     return fileInfo( info->entry, &newInfo, AS_IS );
 }
@@ -2130,7 +3365,7 @@ int printFile( FILE_INFO *info, MODE mode, ESCAPE_MODE escape, FILE *out )
                 if ( c == '\r' ) {
                     continue;
                 }
-                fputc( c, out );
+                putOut( c, out );
             }
             break;
 
@@ -2139,10 +3374,10 @@ int printFile( FILE_INFO *info, MODE mode, ESCAPE_MODE escape, FILE *out )
              *  Data file
              */
             for ( i = 0; i < count; i += 256 ) {
-                fprintf( out, "%4d: ", ++addr );
+                printOut( out, "%4d: ", ++addr );
                 for ( l = 256; l > 0 && Block[ i + l - 1 ] == ' '; --l );
-                fwrite( Block + i, l, 1, out );
-                fputc( '\n', out );
+                writeOut( Block + i, l, out );
+                putOut( '\n', out );
             }
             break;
 
@@ -2159,17 +3394,17 @@ int printFile( FILE_INFO *info, MODE mode, ESCAPE_MODE escape, FILE *out )
                     /*
                      *  File has a password
                      */
-                    fprintf( out, "Password: " );
+                    printOut( out, "Password: " );
                     for( i = 17; i < 17 + 8 && Block[ i ] != 0xff; ++i ) {
                         c = Block[ i ] ^ 0xFF;
                         if ( c < ' ' || c >= 0x80 ) {
-                            fprintf( out, "\\%02.2X", c );
+                            printOut( out, "\\%02.2X", c );
                         }
                         else {
-                            fputc( c, out );
+                            putOut( c, out );
                         }
                     }
-                    fputc( '\n', out );
+                    putOut( '\n', out );
                 }
                 start = 256;
             }
@@ -2194,7 +3429,7 @@ int printFile( FILE_INFO *info, MODE mode, ESCAPE_MODE escape, FILE *out )
 
                 case 2:
                     line_nr += c * 256;
-                    fprintf( out, "%d ", line_nr );
+                    printOut( out, "%d ", line_nr );
                     continue;
 
                 case 3:
@@ -2212,7 +3447,7 @@ int printFile( FILE_INFO *info, MODE mode, ESCAPE_MODE escape, FILE *out )
                 /*
                  *  Print header information
                  */
-                fprintf( out, "Adresses: %02.2X%02.2X-%02.2X%02.2X,"
+                printOut( out, "Adresses: %02.2X%02.2X-%02.2X%02.2X,"
                                        " Entry: %02.2X%02.2X\n\n",
                               Block[ 26 ], Block[ 25 ],
                               Block[ 28 ], Block[ 27 ],
@@ -2227,35 +3462,128 @@ int printFile( FILE_INFO *info, MODE mode, ESCAPE_MODE escape, FILE *out )
              *  Binary data
              */
             for ( i = start; i < count; i += 16 ) {
-                fprintf( out, mode == BINARY ? "%05.5X: " : "%04.4X: ", addr );
+                printOut( out, mode == BINARY ? "%05.5X: " : "%04.4X: ", addr );
                 addr += 16;
                 l = count - i < 16 ? count - i : 16;
                 for ( j = 0; j < l; ++j ) {
-                    fprintf( out, "%02.2X ", Block[ i + j ] );
+                    printOut( out, "%02.2X ", Block[ i + j ] );
                 }
                 while ( j++ < 16 ) {
-                    fprintf( out, "   " );
+                    printOut( out, "   " );
                 }
-                fputc( ' ', out );
+                putOut( ' ', out );
                 for ( j = 0; j < l; ++j ) {
                     char c = Block[ i + j ];
-                    fputc( c < ' ' || c >= 0x7F ? ' ' : c, out );
+                    putOut( c < ' ' || c >= 0x7F ? ' ' : c, out );
                 }
-                fputc( '\n', out );
+                putOut( '\n', out );
+            }
+            break;
+        }
+        first = FALSE;
+    }
+    if ( info->type == TYPE_C || info->type == TYPE_S ) {
+        /*
+         *  Terminate output with a last linefeed
+         */
+        if ( c != '\n' ) {
+            putOut( '\n', out );
+        }
+    }
+    return count == NOT_OK ? NOT_OK : OK;
+}
+
+
+/*
+ *  Output of printFile() and printToken()
+ *  If out is NULL, the output is appended to the memory buffer Text.
+ */
+void putOut( int c, FILE *out )
+{
+    char *p;
+
+    if ( out != NULL ) {
+        fputc( c, out );
+        return;
+    }
+    if ( TextLength == TextSize ) {
+        p = (char *) realloc( Text, TextSize == 0 ? 4096 : 2 * TextSize );
+        if ( p == NULL ) {
+            /*
+             *  Out of memory, the text is truncated
+             */
+            return;
+        }
+        Text = p;
+        TextSize = TextSize == 0 ? 4096 : 2 * TextSize;
+    }
+    Text[ TextLength++ ] = (char) c;
+}
+
+
+/*
+ *  Write a block of characters
+ */
+void writeOut( const void *data, size_t length, FILE *out )
+{
+    const char *p = (const char *) data;
+
+    if ( out != NULL ) {
+        fwrite( data, length, 1, out );
+        return;
+    }
+    while ( length-- > 0 ) {
+        putOut( *p++, NULL );
+    }
+}
+
+
+/*
+ *  Formatted output, short texts only
+ */
+void printOut( FILE *out, const char *format, ... )
+{
+    char buffer[ 80 ];
+    va_list args;
+    int l;
+
+    va_start( args, format );
+    if ( out != NULL ) {
+        vfprintf( out, format, args );
+    }
+    else {
+        l = vsprintf( buffer, format, args );
+        writeOut( buffer, l, NULL );
+    }
+    va_end( args );
+}
+
+
+/*
+ *  Find text in a line which is not terminated
+ */
+char *findText( char *line, size_t length, const char *text, int ignoreCase )
+{
+    size_t l = strlen( text );
+    size_t i;
+    char *end;
+
+    if ( l > length ) {
+        return NULL;
+    }
+    for ( end = line + length - l; line <= end; ++line ) {
+        if ( ignoreCase ) {
+            for ( i = 0; i < l && toupper( line[ i ] & 0xFF )
+                                  == toupper( text[ i ] & 0xFF ); ++i );
+            if ( i == l ) {
+                return line;
             }
-            break;
         }
-        first = FALSE;
-    }
-    if ( info->type == TYPE_C || info->type == TYPE_S ) {
-        /*
-         *  Terminate output with a last linefeed
-         */
-        if ( c != '\n' ) {
-            fputc( '\n', out );
+        else if ( *line == *text && 0 == memcmp( line, text, l ) ) {
+            return line;
         }
     }
-    return count == NOT_OK ? NOT_OK : OK;
+    return NULL;
 }
 
 
@@ -2358,10 +3686,10 @@ void printToken( int c, ESCAPE_MODE escape, FILE *out )
             /*
              *  The colon had been postponed
              */
-            fputc( ':', out );
+            putOut( ':', out );
             pending_colon = FALSE;
         }
-        fputc( c, out );
+        putOut( c, out );
         insert_space = FALSE;
         last = ' ';
     }
@@ -2408,7 +3736,7 @@ void printToken( int c, ESCAPE_MODE escape, FILE *out )
                 /*
                  *  Print the postponed colon except before ELSE
                  */
-                fputc( ':', out );
+                putOut( ':', out );
             }
             pending_colon = FALSE;
         }
@@ -2437,7 +3765,7 @@ void printToken( int c, ESCAPE_MODE escape, FILE *out )
                 /*
                  *  Print char as is, no further translation
                  */
-                fputc( c, out );
+                putOut( c, out );
                 insert_space = FALSE;
             }
             else {
@@ -2445,7 +3773,7 @@ void printToken( int c, ESCAPE_MODE escape, FILE *out )
                  *  Check for spaces and unprintable characters
                  */
                 if ( c < ' ' && c != '\n' ) {
-                    fprintf( out, "\\%02.2X", (unsigned char) c );
+                    printOut( out, "\\%02.2X", (unsigned char) c );
                 }
                 else if ( c == ' ' && *p == '\0' ) {
                     /*
@@ -2458,9 +3786,9 @@ void printToken( int c, ESCAPE_MODE escape, FILE *out )
                      *  Printable character
                      */
                     if ( insert_space && ( c >= '0' && c <= '9' || c >= 'A' ) ) { 
-                        fputc( ' ', out );
+                        putOut( ' ', out );
                     }
-                    fputc( c, out );
+                    putOut( c, out );
                     insert_space = FALSE;
                 }
             }
@@ -2644,76 +3972,217 @@ FILE_INFO *fileInfo( DIR_ENTRY *dptr, FILE_INFO *info, CASE setCase )
 
 /*
  *  Find a file in the directory
+ *  The first call with a pattern compiles it and selects the candidates
+ *  from the directory index, calls with NULL return the next match.
  */
 DIR_ENTRY *findFile( char *pattern, int ignoreCase, int type, int protect )
 {
-    static char expPattern[ 8 + 3 + 1 ] = "";
+    static PATTERN compiled;
+    static short *list = NULL;
+    static int count = 0;
     static int position = 0;
-    int i;
-    char c;
-    int count;
-    int found = FALSE;
     DIR_ENTRY *dptr;
+    int i;
 
     if ( pattern != NULL ) {
         /*
          *  expand the pattern DOS like
          */
-        expandPattern( pattern, expPattern, ignoreCase ? UPPER : AS_IS );
+        compilePattern( pattern, &compiled, ignoreCase );
+        if ( !DirIndex.valid ) {
+            buildDirIndex();
+        }
 
         /*
-         *  initialize the pointer
+         *  Select the candidates
          */
-        position = -1;
+        if ( compiled.count == 8 + 3 ) {
+            /*
+             *  No wildcards: follow the hash chain
+             */
+            list = NULL;
+            position = DirIndex.hash[ nameHash( compiled.text ) ] - 1;
+        }
+        else if ( type != 0 ) {
+            list = DirIndex.byType + DirIndex.typeStart[ type & 0xFF ];
+            count = DirIndex.typeStart[ ( type & 0xFF ) + 1 ]
+                  - DirIndex.typeStart[ type & 0xFF ];
+            position = 0;
+        }
+        else {
+            list = DirIndex.order;
+            count = DirIndex.used;
+            position = 0;
+        }
     }
 
-    while ( !found && position < MAX_DIR_ENTRY - 1 ) {
+    while ( list != NULL ? position < count : position >= 0 ) {
         /*
-         *  find next entry
+         *  next candidate
          */
-        dptr = Directory + ++position;
+        if ( list != NULL ) {
+            i = list[ position++ ];
+        }
+        else {
+            i = position;
+            position = DirIndex.next[ i ] - 1;
+        }
+        dptr = Directory + i;
 
+        /*
+         *  The entry may have changed since the index was built
+         */
         if ( dptr->type == 0 ) {
-            /*
-             *  Entry is unused
-             */
             continue;
         }
         if ( type != 0 && dptr->type != (unsigned char) type ) {
-            /*
-             *  Type not matched
-             */
             continue;
         }
         if ( protect >= 0 && dptr->protect != (unsigned char) protect ) {
-            /*
-             *  Protect attribute not matched
-             */
             continue;
         }
+        if ( matchPattern( &compiled, dptr ) ) {
+            return dptr;
+        }
+    }
 
-        /*
-         *  Compare
-         */
-        for ( i = 0; i < 8 + 3; ++i ) {
-            if ( expPattern[ i ] == '?' ) {
-                continue;
-            }
-            c = dptr->name[ i ];
-            if ( expPattern[ i ] != ( ignoreCase ? toupper( c ) : c ) ) {
+    /*
+     *  No (more) matches
+     */
+    list = NULL;
+    position = -1;
+    return NULL;
+}
+
+
+/*
+ *  Compile a pattern for matchPattern()
+ */
+void compilePattern( char *pattern, PATTERN *compiled, int ignoreCase )
+{
+    char expPattern[ 8 + 3 + 1 ];
+    int i;
+
+    expandPattern( pattern, expPattern, ignoreCase ? UPPER : AS_IS );
+    memcpy( compiled->text, expPattern, 8 + 3 );
+    compiled->ignoreCase = ignoreCase;
+    compiled->count = 0;
+
+    for ( i = 0; i < 8 + 3; ++i ) {
+        if ( expPattern[ i ] != '?' ) {
+            compiled->pos[ compiled->count++ ] = (unsigned char) i;
+        }
+    }
+}
+
+
+/*
+ *  Compare a directory entry with a compiled pattern
+ */
+int matchPattern( PATTERN *compiled, DIR_ENTRY *dptr )
+{
+    int i, k;
+    char c;
+
+    for ( k = 0; k < compiled->count; ++k ) {
+        i = compiled->pos[ k ];
+        c = dptr->name[ i ];
+        if ( compiled->text[ i ] != ( compiled->ignoreCase ? toupper( c ) : c ) )
+        {
 #if DEBUG_
-                printf( "%c != %c\n", expPattern[ i ], c );
+            printf( "%c != %c\n", compiled->text[ i ], c );
 #endif
-                break;
-            }
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+
+/*
+ *  Hash of a file name (8 + 3 characters), case is ignored
+ */
+int nameHash( const char *name )
+{
+    unsigned int h = 0;
+    int i;
+
+    for ( i = 0; i < 8 + 3; ++i ) {
+        h = h * 31 + toupper( name[ i ] & 0xFF );
+    }
+    return (int) ( ( h ^ h >> 8 ) % HASH_SIZE );
+}
+
+
+/*
+ *  Build the directory index
+ */
+void buildDirIndex( void )
+{
+    short next[ 256 + 1 ];
+    DIR_ENTRY *dptr;
+    int i, h;
+
+    memset( &DirIndex, 0, sizeof( DirIndex ) );
+
+    /*
+     *  Used entries and type group sizes
+     */
+    for ( i = 0; i < MAX_DIR_ENTRY; ++i ) {
+        dptr = Directory + i;
+        if ( dptr->type == 0 ) {
+            continue;
         }
-        found = ( i == 8 + 3 );
+        DirIndex.order[ DirIndex.used++ ] = (short) i;
+        ++DirIndex.typeStart[ dptr->type + 1 ];
     }
+    for ( i = 0; i < 256; ++i ) {
+        DirIndex.typeStart[ i + 1 ] += DirIndex.typeStart[ i ];
+    }
+    memcpy( next, DirIndex.typeStart, sizeof( next ) );
 
     /*
-     *  Return entry or NULL if no match
+     *  Type groups and hash chains, both in directory order
      */
-    return found ? Directory + position : NULL;
+    for ( i = 0; i < DirIndex.used; ++i ) {
+        dptr = Directory + DirIndex.order[ i ];
+        DirIndex.byType[ next[ dptr->type ]++ ] = DirIndex.order[ i ];
+    }
+    for ( i = DirIndex.used - 1; i >= 0; --i ) {
+        h = nameHash( Directory[ DirIndex.order[ i ] ].name );
+        DirIndex.next[ DirIndex.order[ i ] ] = DirIndex.hash[ h ];
+        DirIndex.hash[ h ] = (short) ( DirIndex.order[ i ] + 1 );
+    }
+    DirIndex.valid = TRUE;
+}
+
+
+/*
+ *  CRC-32 of the file data, as used by zip
+ */
+unsigned long fileCrc( FILE_INFO *info )
+{
+    static unsigned long table[ 256 ];
+    unsigned long crc = 0xFFFFFFFFul;
+    int count;
+    int i, j;
+
+    if ( table[ 1 ] == 0 ) {
+        for ( i = 0; i < 256; ++i ) {
+            crc = (unsigned long) i;
+            for ( j = 0; j < 8; ++j ) {
+                crc = crc & 1 ? 0xEDB88320ul ^ crc >> 1 : crc >> 1;
+            }
+            table[ i ] = crc;
+        }
+        crc = 0xFFFFFFFFul;
+    }
+    while ( ( count = readFile( info ) ) > 0 ) {
+        for ( i = 0; i < count; ++i ) {
+            crc = table[ ( crc ^ Block[ i ] ) & 0xFF ] ^ crc >> 8;
+        }
+    }
+    return crc ^ 0xFFFFFFFFul;
 }
 
 
@@ -2787,9 +4256,9 @@ int writeFile( FILE_INFO *info, int count, int noUpdate )
 
     if ( i == 0 ) {
         /*
-         *  Find first free block
+         *  Find a free extent for the whole file
          */
-        i = findFreeBlock( 0 );
+        i = findFreeExtent( info->reserve );
         if ( i == 0 ) {
             /*
              *  Disk full
@@ -2808,7 +4277,13 @@ int writeFile( FILE_INFO *info, int count, int noUpdate )
         int j = findFreeBlock( i + 1 );
         if ( j == 0 ) {
             /*
-             *  Disk full
+             *  The extent may lie behind free blocks, wrap around
+             */
+            j = findFreeBlock( START_DATA );
+        }
+        if ( j == 0 || j == i ) {
+            /*
+             *  Disk full, block i itself is not yet marked
              */
             info->error = NO_ROOM;
             return NOT_OK;
@@ -2831,6 +4306,7 @@ int writeFile( FILE_INFO *info, int count, int noUpdate )
      */
     FAT_Block[ 2 * i ]     = (unsigned char) ( info->next >> 8 );
     FAT_Block[ 2 * i + 1 ] = (unsigned char) info->next;
+    FreeMapValid = FALSE;
     MustUpdate = TRUE;
 
     /*
@@ -2914,6 +4390,98 @@ int findFreeBlock( int start )
 }
 
 
+/*
+ *  Collect the runs of free blocks from the FAT
+ */
+void buildFreeMap( void )
+{
+    int i, j;
+
+    FreeExtents = 0;
+    for ( i = START_DATA; i < Blocks; i = j + 1 ) {
+        /*
+         *  Find start and end of next run
+         */
+        for ( ; i < Blocks && ( FAT_Block[ 2 * i ] & 0x80 ); ++i );
+        for ( j = i; j < Blocks && !( FAT_Block[ 2 * j ] & 0x80 ); ++j );
+        if ( j > i ) {
+            FreeMap[ FreeExtents ].start  = (unsigned short) i;
+            FreeMap[ FreeExtents ].length = (unsigned short) ( j - i );
+            ++FreeExtents;
+        }
+    }
+    FreeMapValid = TRUE;
+}
+
+
+/*
+ *  Find the first block of a free extent for count blocks
+ *  The smallest extent which is large enough is taken,
+ *  else the largest one. Returns 0 if the disk is full.
+ */
+int findFreeExtent( int count )
+{
+    int i;
+    int best = -1;
+
+    if ( !FreeMapValid ) {
+        buildFreeMap();
+    }
+    for ( i = 0; i < FreeExtents; ++i ) {
+        if ( FreeMap[ i ].length >= count
+          && ( best < 0 || FreeMap[ i ].length < FreeMap[ best ].length ) )
+        {
+            best = i;
+        }
+    }
+    if ( best < 0 ) {
+        /*
+         *  File must be split
+         */
+        for ( i = 0; i < FreeExtents; ++i ) {
+            if ( best < 0 || FreeMap[ i ].length > FreeMap[ best ].length ) {
+                best = i;
+            }
+        }
+    }
+    return best < 0 ? 0 : FreeMap[ best ].start;
+}
+
+
+/*
+ *  Count the pieces of a file
+ *  Returns NOT_OK if the chain is broken
+ */
+int fileFragments( FILE_INFO *info )
+{
+    int i = info->block & FB_BLOCK;
+    int j;
+    int count = 0;
+    int fragments = 1;
+
+    if ( i == 0 ) {
+        return 0;
+    }
+    while ( TRUE ) {
+        j = FAT_Block[ 2 * i ] << 8 | FAT_Block[ 2 * i + 1 ];
+        if ( !( j & FB_IN_USE ) || ++count > Blocks ) {
+            /*
+             *  Broken or circular chain
+             */
+            return NOT_OK;
+        }
+        if ( j & FB_LAST ) {
+            break;
+        }
+        if ( ( j & FB_BLOCK ) != i + 1 ) {
+            ++fragments;
+        }
+        i = j & FB_BLOCK;
+    }
+    return fragments;
+}
+
+
 /*
  *  Update the FAT and directory blocks
  */
@@ -3009,7 +4577,15 @@ int noDirectAccess( void )
  *  Global file handle
  */
 FILE *Handle;
-int Direct = FALSE;
+
+/*
+ *  An image file is loaded into memory once. Changed blocks are marked
+ *  dirty and written back by closeDisk().
+ */
+unsigned char *Image = NULL;
+unsigned char Dirty[ MAX_BLOCKS ];
+int ImageBlocks = 0;          /* blocks present in the file */
+int ReadOnly = FALSE;
 
 
 /*
@@ -3031,8 +4607,10 @@ int openDisk( char *name, int create, int size, int noUpdate )
          */
         char *mode;
         unsigned long image_size;
+        int created = FALSE;
         
         Direct = FALSE;
+        ReadOnly = noUpdate;
         Blocks = size;
         mode = noUpdate ? "rb" : "r+b";
 
@@ -3043,21 +4621,8 @@ int openDisk( char *name, int create, int size, int noUpdate )
              *  Image not found, create a new file
              */
             Handle = fopen( name, "w+b" );
-
-            if ( Handle != NULL ) {
-                /*
-                 *  File created, write FAT and empty directory
-                 */
-                if ( OK != updateDisk() ) {
-                    return NOT_OK;
-                }
-                /*
-                 *  Write a dummy block to the end of the image
-                 */
-                if ( OK != writeBlocks( Block, Blocks - 1, 1 ) ) {
-                    return NOT_OK;
-                }
-            }
+            created = TRUE;
+            ReadOnly = FALSE;
         }
         if ( Handle == NULL ) {
             perror( name );
@@ -3072,23 +4637,101 @@ int openDisk( char *name, int create, int size, int noUpdate )
         }
         image_size = ftell( Handle );
         size = (int) ( image_size / SIZE_BLOCK );
-        if ( size > MAX_BLOCKS || size < MIN_BLOCKS - 1 ) {
+        if ( !created 
+          && ( size > MAX_BLOCKS || size < MIN_BLOCKS - 1 ) ) 
+        {
             fprintf( stderr, "Image size out of range\n" );
             return NOT_OK;
         }
         if ( size > Blocks ) {
             Blocks = size;
         }
+
+        /*
+         *  Load the image
+         */
+        Image = calloc( Blocks, SIZE_BLOCK );
+        if ( Image == NULL ) {
+            perror( name );
+            return NOT_OK;
+        }
+        memset( Dirty, FALSE, sizeof( Dirty ) );
+        ImageBlocks = size;
+        if ( size > 0 ) {
+            if ( OK != fseek( Handle, 0, SEEK_SET )
+              || size != (int) fread( Image, SIZE_BLOCK, size, Handle ) )
+            {
+                perror( "fread" );
+                return NOT_OK;
+            }
+        }
+
+        if ( created ) {
+            /*
+             *  File created, write FAT, empty directory and all blocks
+             */
+            memset( Dirty, TRUE, Blocks );
+            if ( OK != updateDisk() || OK != flushDisk() ) {
+                return NOT_OK;
+            }
+        }
+    }
+    return OK;
+}
+
+
+/*
+ *  Write the dirty blocks back to the image file
+ *  Consecutive blocks are written in one go.
+ */
+int flushDisk( void )
+{
+    int i, j;
+
+    for ( i = 0; i < Blocks; i = j ) {
+        if ( !Dirty[ i ] ) {
+            j = i + 1;
+            continue;
+        }
+        for ( j = i + 1; j < Blocks && Dirty[ j ]; ++j );
+#if DEBUG
+        printf( "flush blocks %d-%d\n", i, j - 1 );
+#endif
+        if ( OK != fseek( Handle, SIZE_BLOCK * (long) i, SEEK_SET ) ) {
+            perror( "fseek" );
+            return NOT_OK;
+        }
+        if ( j - i != (int) fwrite( Image + SIZE_BLOCK * (long) i,
+                                    SIZE_BLOCK, j - i, Handle ) ) 
+        {
+            perror( "fwrite" );
+            return NOT_OK;
+        }
+        memset( Dirty + i, FALSE, j - i );
+        if ( j > ImageBlocks ) {
+            ImageBlocks = j;
+        }
     }
     return OK;
 }
 
 
+/*
+ *  Forget all changes to the loaded image
+ */
+void discardDisk( void )
+{
+    memset( Dirty, FALSE, sizeof( Dirty ) );
+}
+
+
 /*
  *  Close the disk image or device
  */
 int closeDisk( void )
 {
+    int result = OK;
+
     if ( Direct ) {
         /*
          *  Terminate access to device
@@ -3097,19 +4740,25 @@ int closeDisk( void )
     }
     else {
         /*
-         *  Close image file or Linux device
+         *  Write back and close image file or Linux device
          */
         if ( Handle != NULL ) {
             FILE *f = Handle;
+
+            if ( !ReadOnly && Image != NULL ) {
+                result = flushDisk();
+            }
             Handle = NULL;
 
             if ( 0 != fclose( f ) ) {
                 perror( "fclose" );
-                return NOT_OK;
+                result = NOT_OK;
             }
         }
+        free( Image );
+        Image = NULL;
     }
-    return OK;
+    return result;
 }
 
 
@@ -3136,20 +4785,15 @@ int readBlocks( void *dest, int number, int count )
     }
     else {
         /*
-         *  Position to block
-         */
-        if ( OK != fseek( Handle, SIZE_BLOCK * (long) number, SEEK_SET ) ) {
-            perror( "fseek" );
-            return NOT_OK;
-        }
-
-        /*
-         *  Read block(s)
+         *  Copy block(s) from the loaded image
          */
-        if ( count != (int) fread( dest, SIZE_BLOCK, count, Handle ) ) {
-            perror( "fread" );
+        if ( number + count > Blocks ) {
+            fprintf( stderr, "Block %d is outside of the image\n", 
+                     number + count - 1 );
             return NOT_OK;
         }
+        memcpy( dest, Image + SIZE_BLOCK * (long) number,
+                SIZE_BLOCK * count );
     }
     return OK;
 }
@@ -3160,6 +4804,8 @@ int readBlocks( void *dest, int number, int count )
  */
 int writeBlocks( void *source, int number, int count )
 {
+    unsigned char *p, *q;
+
     number &= FB_BLOCK;
 
 #if DEBUG
@@ -3173,19 +4819,22 @@ int writeBlocks( void *source, int number, int count )
     }
     else {
         /*
-         *  Position to block
+         *  Update the loaded image, only changed blocks become dirty
          */
-        if ( OK != fseek( Handle, SIZE_BLOCK * (long) number, SEEK_SET ) ) {
-            perror( "fseek" );
+        if ( number + count > Blocks ) {
+            fprintf( stderr, "Block %d is outside of the image\n", 
+                     number + count - 1 );
             return NOT_OK;
         }
-
-        /*
-         *  Write block(s)
-         */
-        if ( count != (int) fwrite( source, SIZE_BLOCK, count, Handle ) ) {
-            perror( "fwrite" );
-            return NOT_OK;
+        p = Image + SIZE_BLOCK * (long) number;
+        q = (unsigned char *) source;
+        for ( ; count > 0; --count, ++number ) {
+            if ( number >= ImageBlocks || 0 != memcmp( p, q, SIZE_BLOCK ) ) {
+                memcpy( p, q, SIZE_BLOCK );
+                Dirty[ number ] = TRUE;
+            }
+            p += SIZE_BLOCK;
+            q += SIZE_BLOCK;
         }
     }
     return OK;
@@ -0,0 +1,7 @@
+10 CLS
+20 FOR I=0 TO 31
+30 PSET(I,I/4)
+40 NEXT I
+50 LOCATE 0,3:PRINT " DONE  ";
+60 A$=INKEY$:IF A$="" THEN 60
+70 END
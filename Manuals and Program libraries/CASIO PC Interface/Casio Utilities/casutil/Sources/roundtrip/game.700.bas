@@ -0,0 +1,7 @@
+10 CLS:RANDOMIZE
+20 X=INT(RND*100)+1:T=0
+30 INPUT "GUESS";G:T=T+1
+40 IF G<X THEN PRINT "HIGHER":GOTO 30
+50 IF G>X THEN PRINT "LOWER":GOTO 30
+60 PRINT "FOUND IN ";T;" TRIES"
+70 BEEP:END
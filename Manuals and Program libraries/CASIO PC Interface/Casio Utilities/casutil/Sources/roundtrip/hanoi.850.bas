@@ -0,0 +1,12 @@
+10 REM TOWERS OF HANOI
+20 INPUT "DISCS";N
+30 IF N<1 OR N>9 THEN 20
+40 DIM S(3,10):H(1)=N:H(2)=0:H(3)=0
+50 FOR I=1 TO N:S(1,I)=N-I+1:NEXT I
+60 GOSUB 100:PRINT "MOVES = ";M
+70 END
+100 REM MOVE
+110 M=M+1:A$=STR$(M)+":"+CHR$(65)
+120 IF M<2^N-1 THEN 110
+130 PRINT USING "###.##";SQR(M);LOG(M);SIN(PI/4)
+140 RETURN
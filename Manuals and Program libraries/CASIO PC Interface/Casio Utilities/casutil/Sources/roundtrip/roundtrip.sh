@@ -0,0 +1,105 @@
+#!/bin/sh
+#
+# Round trip regression and timing harness for the BASIC tokenizers
+#
+# Every corpus file <name>.<model>.bas is tokenized into a WAV file by the
+# matching bas* program, listed again by the matching list* program and the
+# listing is compared with the source.  Blanks outside string literals are
+# ignored in the comparison since the listers insert their own spacing,
+# blanks inside strings must survive.  Timings are in milliseconds.
+#
+# usage: roundtrip.sh [<bindir> [<corpus file> ...]]
+#
+#   <bindir> defaults to ../linux, the corpus to all *.bas files next to
+#   this script.
+#
+#   model   tokenizer         lister
+#   702     bas702 -w         list702 -w
+#   730     bas730 -w         list730 -w
+#   700     bas850 -s -t7     list850 -wS
+#   850     bas850 -f -t8     list850 -wF
+#   X07     basX07 -w         listX07 -w
+#
+DIR=`dirname $0`
+BIN=${1:-$DIR/../linux}
+[ $# -gt 0 ] && shift
+[ $# -eq 0 ] && set -- $DIR/*.bas
+
+TMP=${TMPDIR:-/tmp}/roundtrip.$$
+mkdir $TMP || exit 2
+trap 'rm -rf $TMP' 0 1 2 15
+
+#
+#  Current time in milliseconds, falls back to seconds without %N
+#
+now() {
+	t=`date +%s%N`
+	case $t in
+	*N)	echo `date +%s`000 ;;
+	*)	echo `expr $t / 1000000` ;;
+	esac
+}
+
+#
+#  Keep numbered lines only, drop carriage returns and blanks outside
+#  of strings (every even field between quotes is inside a string)
+#
+normalize() {
+	tr -d '\r' < $1 | grep '^[0-9]' |
+	awk -F'"' -v OFS='"' '{ for (i = 1; i <= NF; i += 2) gsub(/ /, "", $i); print }'
+}
+
+failed=0
+count=0
+total_enc=0
+total_dec=0
+
+printf "%-24s %-5s %8s %8s  %s\n" "File" "Model" "Encode" "List" "Result"
+
+for f in "$@"
+do
+	model=`basename $f .bas`
+	model=${model##*.}
+	case $model in
+	702)	enc="bas702 -w";	dec="list702 -w" ;;
+	730)	enc="bas730 -w";	dec="list730 -w" ;;
+	700)	enc="bas850 -s -t7";	dec="list850 -wS" ;;
+	850)	enc="bas850 -f -t8";	dec="list850 -wF" ;;
+	X07)	enc="basX07 -w";	dec="listX07 -w" ;;
+	*)	echo "$f: unknown model $model" >&2
+		failed=`expr $failed + 1`
+		continue ;;
+	esac
+
+	t0=`now`
+	$BIN/$enc $f $TMP/tape.wav > $TMP/enc.log 2>&1
+	rc=$?
+	t1=`now`
+	$BIN/$dec $TMP/tape.wav > $TMP/list.txt 2> $TMP/dec.log
+	rc=`expr $rc + $?`
+	t2=`now`
+
+	normalize $f > $TMP/expect.txt
+	normalize $TMP/list.txt > $TMP/result.txt
+	if [ $rc -ne 0 ]; then
+		result=FAILED
+		cat $TMP/enc.log $TMP/dec.log
+	elif cmp -s $TMP/expect.txt $TMP/result.txt; then
+		result=OK
+	else
+		result=DIFF
+		diff $TMP/expect.txt $TMP/result.txt
+	fi
+	[ $result = OK ] || failed=`expr $failed + 1`
+	count=`expr $count + 1`
+
+	enc_ms=`expr $t1 - $t0`
+	dec_ms=`expr $t2 - $t1`
+	total_enc=`expr $total_enc + $enc_ms`
+	total_dec=`expr $total_dec + $dec_ms`
+	printf "%-24s %-5s %8d %8d  %s\n" `basename $f` $model $enc_ms $dec_ms $result
+done
+
+printf "%-24s %-5s %8d %8d  %d of %d failed\n" "Total" "" \
+	$total_enc $total_dec $failed $count
+[ $failed -eq 0 ]
@@ -0,0 +1,8 @@
+10 S=0
+20 FOR I=1 TO 100
+30 S=S+I*I
+40 NEXT I
+50 PRINT "SUM = ";S
+60 IF S>1000 THEN 80
+70 GOTO 10
+80 END
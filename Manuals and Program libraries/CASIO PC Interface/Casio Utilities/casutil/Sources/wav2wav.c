@@ -93,6 +93,10 @@ int main( int argc, char **argv )
               );
         return 2;
     }
+    /*
+     *  The bits are copied, the cache of decoded bytes doesn't help
+     */
+    kcsUseCache( 0 );
     in = kcsOpen( *++argv, "rb", in_baud, 8, 'N', 1 );
     if ( in == NULL ) {
         perror( "in" );
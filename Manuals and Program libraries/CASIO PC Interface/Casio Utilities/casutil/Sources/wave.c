@@ -16,6 +16,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <sys/stat.h>
 
 #define MIN_GOOD 4
 
@@ -93,6 +94,8 @@ WFILE *wopen( char *filename,
      *  save openmode
      */
     file->openmode = openmode[ 0 ];
+    file->isEof = 0;
+    file->position = 0;
 
     /*
      *  Input: Read Header
@@ -715,6 +718,154 @@ static int Threshold = 10;
  */
 static int AutoBias = 0;
 
+/*
+ *  Decode cache switch, see kcsUseCache()
+ */
+static int UseCache = 1;
+
+
+/*
+ *  Size of a decode cache record:
+ *  raw data (2 bytes), state (1 byte), unused (1 byte), position (4 bytes)
+ */
+#define CACHE_RECORD 8
+
+
+/*
+ *  Open the decode cache for a KCS file opened for reading
+ *
+ *  The cache file name is built from two FNV-1a hashes over the decoder
+ *  parameters and the complete wave file. If the file exists it is replayed,
+ *  else a temporary file is created to record the decoded data.
+ *  Only regular files are cached, hashing a pipe would consume its data.
+ */
+static void kcsCacheOpen( KCS_FILE *file, char *filename )
+{
+    char *dir = getenv( "WAVE_CACHE" );
+    struct stat st;
+    unsigned char buffer[ 4096 ];
+    uint32_t hash1 = 2166136261ul;
+    uint32_t hash2 = 0x811c9dc5ul ^ 0x5bd1e995ul;
+    FILE *f;
+    size_t len, i;
+    char *p;
+
+    file->cache = NULL;
+    file->cacheMode = KCS_CACHE_OFF;
+    file->cacheName = NULL;
+
+    if ( !UseCache || dir == NULL || *dir == '\0' ) {
+        return;
+    }
+    if ( fstat( fileno( file->file->file ), &st ) != 0
+      || !S_ISREG( st.st_mode ) )
+    {
+        return;
+    }
+
+    /*
+     *  Hash the decoder parameters first
+     */
+    sprintf( (char *) buffer, "%d,%d,%c,%d,%d,%d,%d",
+             file->baudrate, file->bits, file->parity, file->stopbits,
+             file->phase, Threshold, AutoBias );
+    for ( p = (char *) buffer; *p != '\0'; ++p ) {
+        hash1 = ( hash1 ^ (unsigned char) *p ) * 16777619ul;
+        hash2 = ( hash2 ^ (unsigned char) *p ) * 16777619ul;
+    }
+
+    /*
+     *  Hash the wave file
+     */
+    f = fopen( filename, "rb" );
+    if ( f == NULL ) {
+        return;
+    }
+    while ( ( len = fread( buffer, 1, sizeof( buffer ), f ) ) > 0 ) {
+        for ( i = 0; i < len; ++i ) {
+            hash1 = ( hash1 ^ buffer[ i ] ) * 16777619ul;
+            hash2 = ( hash2 ^ buffer[ len - 1 - i ] ) * 16777619ul;
+        }
+    }
+    fclose( f );
+
+    file->cacheName = malloc( strlen( dir ) + 1 + 16 + 4 + 4 + 1 );
+    if ( file->cacheName == NULL ) {
+        return;
+    }
+    sprintf( file->cacheName, "%s/%08lx%08lx.kcs",
+             dir, (unsigned long) hash1, (unsigned long) hash2 );
+
+    /*
+     *  Cached data available?
+     */
+    file->cache = fopen( file->cacheName, "rb" );
+    if ( file->cache != NULL ) {
+        file->cacheMode = KCS_CACHE_REPLAY;
+#if _DEBUG
+        printf( "kcsCacheOpen: replaying %s\n", file->cacheName );
+#endif
+        return;
+    }
+
+    /*
+     *  Record to temporary file, renamed on successful completion
+     */
+    strcat( file->cacheName, ".tmp" );
+    file->cache = fopen( file->cacheName, "wb" );
+    if ( file->cache != NULL ) {
+        file->cacheMode = KCS_CACHE_RECORD;
+    }
+}
+
+
+/*
+ *  Switch the decode cache on or off for the following kcsOpen() calls
+ */
+void kcsUseCache( int use )
+{
+    UseCache = use;
+}
+
+
+/*
+ *  Close the decode cache
+ *
+ *  A recording is kept only if the file has been decoded up to its end,
+ *  partial recordings are removed.
+ */
+static void kcsCacheClose( KCS_FILE *file )
+{
+    char *p;
+
+    if ( file->cache != NULL ) {
+        fclose( file->cache );
+
+        if ( file->cacheMode == KCS_CACHE_COMPLETE ) {
+            /*
+             *  Strip ".tmp" and publish
+             */
+            p = strdup( file->cacheName );
+            if ( p != NULL ) {
+                p[ strlen( p ) - 4 ] = '\0';
+                if ( 0 != rename( file->cacheName, p ) ) {
+                    remove( file->cacheName );
+                }
+                free( p );
+            }
+        }
+        else if ( file->cacheMode == KCS_CACHE_RECORD ) {
+            remove( file->cacheName );
+        }
+    }
+    if ( file->cacheName != NULL ) {
+        free( file->cacheName );
+    }
+    file->cache = NULL;
+    file->cacheMode = KCS_CACHE_OFF;
+    file->cacheName = NULL;
+}
+
 
 /*
  *  Open a wave file for "Kansas City Standard" (KCS) encoded data
@@ -850,6 +1001,9 @@ KCS_FILE *kcsOpen( char *filename,
     file->samplePointer      = 0;
     file->bias               = 0L;
     file->good_count         = 0;
+    file->cache              = NULL;
+    file->cacheMode          = KCS_CACHE_OFF;
+    file->cacheName          = NULL;
 
     /*
      *  Readjust size of control block
@@ -860,6 +1014,13 @@ KCS_FILE *kcsOpen( char *filename,
         wclose( wfile );
         return NULL;
     }
+
+    /*
+     *  Input: look for cached data
+     */
+    if ( wfile->openmode == 'r' ) {
+        kcsCacheOpen( file, filename );
+    }
 #if _DEBUG
     printf( "kcsOpen: samples/sec=%lu, bitLength=%d, zeroLength=%d,"
             " syncOnZero=%d\n",
@@ -894,8 +1055,9 @@ int kcsClose( KCS_FILE *file )
     }
 
     /*
-     *  Close wave file
+     *  Close the cache and the wave file
      */
+    kcsCacheClose( file );
     if ( rc == 0 ) {
         rc = wclose( file->file );
     }
@@ -1455,7 +1617,7 @@ int kcsReadBit( KCS_FILE *file )
 
 
 /*
- *  Read KCS coded data in uncooked form
+ *  Decode KCS coded data in uncooked form from the wave samples
  *
  *  Returns
  *     Positive 16 bit word - data successfully read
@@ -1463,7 +1625,7 @@ int kcsReadBit( KCS_FILE *file )
  *     KCS_EOF      (-2)    - end of file
  *     KCS_BAD_DATA (-3)    - no appropriate wave pattern found
  */
-short kcsReadRaw( KCS_FILE *file )
+static short kcsDecodeRaw( KCS_FILE *file )
 {
     short result = 0;
     int bits = ( file->stopbits != 0 ) + file->bits 
@@ -1521,6 +1683,57 @@ short kcsReadRaw( KCS_FILE *file )
 }
 
 
+/*
+ *  Read KCS coded data in uncooked form
+ *
+ *  Replays or records the result if the decode cache is active
+ */
+short kcsReadRaw( KCS_FILE *file )
+{
+    unsigned char record[ CACHE_RECORD ];
+    short result;
+
+    if ( file->cacheMode == KCS_CACHE_REPLAY ) {
+        /*
+         *  Get result, state and position from the cache
+         */
+        if ( 1 != fread( record, CACHE_RECORD, 1, file->cache ) ) {
+            return KCS_EOF;
+        }
+        file->state = record[ 2 ];
+        file->file->position = getLsbFirst( record + 4, 4 );
+        return (short) getLsbFirst( record, 2 );
+    }
+
+    result = kcsDecodeRaw( file );
+
+    if ( file->cacheMode == KCS_CACHE_RECORD ) {
+        /*
+         *  Save result, state and position
+         */
+        storeLsbFirst( (uint32_t) result, record, 2 );
+        record[ 2 ] = (unsigned char) file->state;
+        record[ 3 ] = 0;
+        storeLsbFirst( file->file->position, record + 4, 4 );
+        if ( result == KCS_ERROR
+          || 1 != fwrite( record, CACHE_RECORD, 1, file->cache ) )
+        {
+            /*
+             *  Do not cache I/O errors
+             */
+            fclose( file->cache );
+            remove( file->cacheName );
+            file->cache = NULL;
+            file->cacheMode = KCS_CACHE_OFF;
+        }
+        else if ( result == KCS_EOF ) {
+            file->cacheMode = KCS_CACHE_COMPLETE;
+        }
+    }
+    return result;
+}
+
+
 /*
  *  Read KCS coded data in uncooked ASCII armoured form
  *  - The lower 6 bits are transfered to the lower byte and 0x30 is added
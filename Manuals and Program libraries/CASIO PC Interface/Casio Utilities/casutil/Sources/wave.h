@@ -156,6 +156,14 @@ typedef struct _kcsfile {
     int lastSample;
     long bias;
     int good_count;
+    FILE *cache;
+    enum {
+        KCS_CACHE_OFF,
+        KCS_CACHE_RECORD,
+        KCS_CACHE_REPLAY,
+        KCS_CACHE_COMPLETE
+    } cacheMode;
+    char *cacheName;
     int sampleBufferLength;
     int samplePointer;
     long sampleBuffer[ 1 ];
@@ -175,6 +183,12 @@ typedef struct _kcsfile {
  *  bits is 7 or 8
  *  parity is one of 'E', 'O' or 'N'
  *  stopbits is 1 or 2
+ *
+ *  If the environment variable WAVE_CACHE names a directory, decoded data
+ *  is cached there, keyed by a hash of the wave file and the decoder
+ *  parameters. A later read of the same file with the same parameters
+ *  replays the cached data instead of decoding the samples again.
+ *  Pipes and devices are never cached.
  */
 KCS_FILE *kcsOpen( char *filename,
                    char *openmode,
@@ -183,6 +197,13 @@ KCS_FILE *kcsOpen( char *filename,
                    char parity,
                    int stopbits );
 
+/*
+ *  Switch the decode cache on (default) or off for the following kcsOpen()
+ *  calls. Programs which read only a part of the wave or single bits
+ *  switch it off, the hash over the whole file would be wasted.
+ */
+void kcsUseCache( int use );
+
 /*
  *  Close KCS file
  */
@@ -0,0 +1,120 @@
+/* Textcoding Unicode (UTF-8, no BOM), End of Line Windows (CRLF)
+
+wav2bin.h
+
+Options of ConvertWavToBin, to link the converter into another program.
+Compile wav2bin_200a.c with -DWAV2BIN_LIB, it has no main then.
+
+    OptionInfo  opt ;
+
+    SetDefaultOptions (&opt) ;
+    opt.argP = "myprog" ;
+    opt.Qcnt = 1 ;
+    error = ConvertWavToBin ("in.wav", "out.img", TYPE_IMG, ORDER_STD, UTF8_YES, 0, &opt) ;
+
+SetDefaultOptions sets the defaults of the command line, --pc=auto and
+--width=5. The options are copied into the FileInfo of the wave at the
+start, the converter keeps no state between the calls and writes no
+globals.
+*/
+
+#ifndef WAV2BIN_H
+#define WAV2BIN_H
+
+                        /* return codes of ConvertWavToBin */
+/* Regular Errors such as EOF and recoverable such as End of sync *MUST* have a lower value then ERR_OK */
+#define ERR_GLIT       -21  /* Glitch detected in the wave */
+#define ERR_DROP       -20  /* Dropout detected in the wave */
+
+#define ERR_NSYNC      -9   /* new long sync or low freq detected */
+#define ERR_EOT        -2   /* End of Pocket Computer Transmission */
+#define ERR_EOF        -1   /* Normal EOF, End of audio data, */
+#define ERR_NOK        -1   /* old definition minor error unspecified */
+
+#define ERR_OK          0   /* no error, nothing to do */
+
+/* Unexpected NOT recoverable error *MUST* have a higher value then ERR_OK */
+#define ERR_SYNT        1   /* arguments missing, syntax error or nothing to do */
+#define ERR_ORD         2   /* misplaced order, nibbles in bytes or other */
+#define ERR_ARG         3   /* arguments problem, pocket not implemented */
+#define ERR_LINE        4   /* error with line numbers */
+#define ERR_FILE        5   /* File I-O */
+#define ERR_MEM         6   /* Line to long, buffer overflow */
+#define ERR_FMT         7   /* False wave format or SHARP file header */
+#define ERR_SUM         8   /* Checksum read different from calculated */
+#define ERR_SYNC        9   /* No Sync found*/
+#define ERR_MULTI       10   /* multiple errors, exit code + last error */
+
+                        /* debug: special options, more levels see the source code */
+#define IGN_ERR_SUM   0x800     /* option flag to ignore false checksums */
+#define BASE_FRQ_FIX  0x1000    /* option flag not to tune the base frequency, use fixed base frequencies*/
+#define TRANS_OLD     0x2000    /* option flag to use old TRANS level definitions, no amplitude detect, no gain */
+#define NO_RATE_AMP   0x4000    /* option flag for amplitudes detect and count only, no gain */
+#define NO_PRE_AMP    0x8000    /* option flag for don't analyse Wave file, no Pre-Amplification */
+#define WRT_NUL_DATA  0x40000   /* option flag for writing zero data at end of file */
+
+                        /* utf8: destination type of a special char, only for TYPE_BAS */
+#define UTF8_NO         0       /* ASCII transcription with brackets [reversible] */
+#define UTF8_YES        1       /* special chars to UTF-8 */
+#define UTF8_ASC        2       /* for later serial transfer or from OLD_BAS to newer PC Groups */
+#define UTF8_DOS        3       /* for transfer to DOS-based Software with DOS-US graphics charset */
+
+                        /* type: destination file type */
+#define TYPE_NOK        0
+#define TYPE_BAS        1       /* Translate Basic intermediate code to lines of Basic source code */
+#define TYPE_IMG        2       /* Write a image of Binary code, Basic intermediate code, Text modus, ASCII or data */
+#define TYPE_RSV        5       /* Write a image of ReSerVable memory (for keys) */
+#define TYPE_ASC        6       /* For PC-E/G/1600 ASCII Data */
+#define TYPE_RAW        9       /* Raw data with checksums and name, also for emulator TAP format */
+
+                        /* order: nibbles in a byte */
+#define ORDER_STD       0       /* nibbles in a byte swapped */
+#define ORDER_INV       1       /* nibbles in a byte no swapped or two-times swapped, PC-1500 or DATA */
+#define ORDER_E         8       /* no nibbles, a byte with one start bit, newer method */
+
+                        /* devId: source of the wave */
+#define DEV_PC          0       /* digitalization directly from Pocket Computer interface*/
+#define DEV_CAS         1       /* digitalization directly from cassette recorder */
+#define DEV_AIR         2       /* digitalization with microphone from buzzer over air */
+#define DEV_EMU         3       /* digitalization from emulator sound */
+
+typedef struct {        /* options of one conversion, see the command line options */
+      const char*  argP ;   /* Program name, prefix of the messages */
+           double  speed ;  /* factor of recording or CPU speed to default speed */
+     unsigned int  SHAc ;   /* Write not to bas, but to Transfile PC plus SHA-format (name included) */
+     unsigned int  SHCc ;   /* Write not to bin, but to Transfile PC plus SHC-format (header included) */
+     unsigned int  TAPw ;   /* Write not to raw, but to Emulator TAP-format (header included) */
+     unsigned int  TAPc ;   /* Input not wav, from emulator tap format (raw byte)*/
+     unsigned int  Qcnt ;   /* Quiet, minimal output */
+    unsigned long  linewidth ;  /* Minimum width of line numbers, 3 to 10, 0 for SHAc */
+   unsigned short  devId ;  /* ID number of the device from witch was digitized the wave file */
+     unsigned int  pcId ;   /* ID number of the pocket computer, 0 for auto detection */
+   unsigned short  pcgrpId ;/* Group ID number, categorisation of the pocket computer */
+     unsigned int  ll_Img ; /* Max. length of BASIC IMAGE lines */
+           double  debug_time ; /* [s] start of debugging for sample value processing */
+
+                        /* Defaults of the detection parameters, adapted to each wave in its FileInfo */
+    unsigned long  Base_FREQ1 ;     /* Sync, stop bits or high bit for PC-12xx, 13xx, 14xx, 0 not searched for */
+    unsigned long  Base_FREQ2 ;     /* PC-1500 */
+    unsigned long  Base_FREQ3 ;     /* PC-1600, PC-E500, -E200, and G-series */
+              int  Stop_Bit_Max ;   /* Maximum of stop bits to expect after a bit for intermediate sync */
+              int  Trans_High_def ; /* Default level to accept transmission to high state (Schmitt Trigger)*/
+              int  Trans_Low_def ;  /* Default level to accept transmission to low state (Schmitt Trigger)*/
+              int  Trans_High_15 ;  /* Transmission to high state for PC-1500 */
+              int  Trans_Low_15 ;   /* Transmission to low state for PC-1500 */
+              int  Amp_Diff_Rel ;   /* Filter amplitudes, relative low to the last amplitude */
+              int  Amp_Diff_Mid ;   /* Filter amplitudes, relative low to the all counted amplitudes */
+              int  Rate_Amp_Def ;   /* Default gain for of the last amplitude based amplification of sample values */
+} OptionInfo ;
+
+void SetDefaultOptions (OptionInfo*  ptrOpt) ;
+
+int ConvertWavToBin (char*  ptrSrcFile,         /* Source file string*/
+                     char*  ptrDstFile,         /* Destination file string*/
+            unsigned long  type,               /* SHARP file type */
+            unsigned long  order,              /* Order of nibbles in a Byte or ORDER_E */
+            unsigned long  utf8,               /* destination type of a special char */
+            unsigned long  debug,              /* special options or debug traces */
+         const OptionInfo*  ptrOpt) ;           /* options of this conversion */
+
+#endif // WAV2BIN_H
@@ -150,6 +150,14 @@ wav2bin.c
     see wav2bin_199_changes.txt
 2015-06-09	V 2.0.0a
     BAS_15 ReadLine EOF checksum with full block
+2026-10-19	V 2.0.0b
+    wave data is read at once into a sample plane of 8-bit values, pre-amplification while loading
+    bit readers use a sample cursor of the plane instead of ftell/fseek, wave time calculated from it
+    sound levels for the pre-amplification counted while loading, no second pass through the wave
+    first sync search tries all base frequencies window by window, the earliest sync is used
+    --pc=auto, a header ident not valid for the base frequency restarts the search with all PC groups
+    decoder state of a wave moved from globals and statics into FileInfo, -DWAV2BIN_LIB without main
+    options passed to ConvertWavToBin in an OptionInfo (wav2bin.h), copied into FileInfo, no globals
 */
 
 #include <stdio.h>
@@ -157,6 +165,7 @@ wav2bin.c
 #include <string.h>
 #include <getopt.h>		/* Command line parser getopt(). */
 #include <ctype.h>
+#include "wav2bin.h"	/* OptionInfo, ConvertWavToBin */
                         /* delete "//" in next line to activate debug modus by default */
 // #define DEBUG           1   /* should be commented for final releases */
 #ifdef DEBUG
@@ -169,53 +178,8 @@ wav2bin.c
 #define STAT_FMT        -7  /* Manual check of format conversion needed */
 #define STAT_OK          0  /* Normal data transmission */
 
-/* Regular Errors such as EOF and recoverable such as End of sync *MUST* have a lower value then ERR_OK */
-#define ERR_GLIT       -21  /* Glitch detected in the wave */
-#define ERR_DROP       -20  /* Dropout detected in the wave */
-
-#define ERR_NSYNC      -9   /* new long sync or low freq detected */
-#define ERR_EOT        -2   /* End of Pocket Computer Transmission */
-#define ERR_EOF        -1   /* Normal EOF, End of audio data, */
-#define ERR_NOK        -1   /* old definition minor error unspecified */
-
-#define ERR_OK          0   /* no error, nothing to do */
-
-/* Unexpected NOT recoverable error *MUST* have a higher value then ERR_OK */
-#define ERR_SYNT        1   /* arguments missing, syntax error or nothing to do */
-#define ERR_ORD         2   /* misplaced order, nibbles in bytes or other */
-#define ERR_ARG         3   /* arguments problem, pocket not implemented */
-#define ERR_LINE        4   /* error with line numbers */
-#define ERR_FILE        5   /* File I-O */
-#define ERR_MEM         6   /* Line to long, buffer overflow */
-#define ERR_FMT         7   /* False wave format or SHARP file header */
-#define ERR_SUM         8   /* Checksum read different from calculated */
-#define ERR_SYNC        9   /* No Sync found*/
-#define ERR_MULTI       10   /* multiple errors, exit code + last error */
-
 #define ERR_CNT_MAX     768  /* exit, if this or more (minor) errors */
 
-#define IGN_ERR_SUM   0x800     /* option flag to ignore false checksums */
-#define BASE_FRQ_FIX  0x1000    /* option flag not to tune the base frequency, use fixed base frequencies*/
-#define TRANS_OLD     0x2000    /* option flag to use old TRANS level definitions, no amplitude detect, no gain */
-#define NO_RATE_AMP   0x4000    /* option flag for amplitudes detect and count only, no gain */
-#define NO_PRE_AMP    0x8000    /* option flag for don't analyse Wave file, no Pre-Amplification */
-#define WRT_NUL_DATA  0x40000   /* option flag for writing zero data at end of file */
-
-#define UTF8_ASC        2       /* for later serial transfer or from OLD_BAS to newer PC Groups */
-#define UTF8_DOS        3       /* for transfer to DOS-based Software with DOS-US graphics charset */
-
-#define TYPE_NOK        0
-#define TYPE_BAS        1       /* Translate Basic intermediate code to lines of Basic source code */
-#define TYPE_IMG        2       /* Write a image of Binary code, Basic intermediate code, Text modus, ASCII or data */
-#define TYPE_RSV        5       /* Write a image of ReSerVable memory (for keys) */
-#define TYPE_ASC        6       /* For PC-E/G/1600 ASCII Data */
-#define TYPE_RAW        9       /* Raw data with checksums and name, also for emulator TAP format */
-
-#define DEV_PC          0       /* digitalization directly from Pocket Computer interface*/
-#define DEV_CAS         1       /* digitalization directly from cassette recorder */
-#define DEV_AIR         2       /* digitalization with microphone from buzzer over air */
-#define DEV_EMU         3       /* digitalization from emulator sound */
-
                                 /* Group IDENT_PC1211 for PC-1210 ... 1212 */
 #define GRP_OLD         0x20    /* most inside PC-1245 ... 1255 */
 #define GRP_NEW         0x70    /* most of PC-1260 ... 1460 */
@@ -302,6 +266,8 @@ wav2bin.c
 #define SYNC_FRAC_1     3/4     /* fraction of bits in block with trans>=BIT_1 for start of first sync, no brackets! */
 #define BIT_LEN_RTOL    1/32    /* 3% relative tolerance of samples before calculating new frequency, no brackets! */
 #define SYNC_TIME_MIN   260     /* [msec] how long Sync-BIT_1 read after FindSync before accepting sync */
+#define SYNC_WINDOW     30      /* [sec] part of the wave, in that all base frequencies are tried for the first sync */
+#define SYNC_OVERLAP    10      /* [sec] next window starts before the end of the last, longer than a sync */
 
 #define SYNC_BIT_MAX    0x7FFF  /* how many Sync-BIT_1 read in mode FindSync before new sync */
 #define STOP_BIT_MAX    250     /* how many Stop-BIT_1 read in mode ReadBitField before new sync, normal 11 enough,  */
@@ -311,10 +277,6 @@ wav2bin.c
 #define SYNC_TR_TOL     3       /* how many trans less BIT_1 or above BIT_0 are accepted, multi-pass */
 #define CNT_ERR_ORD     0       /* try to shift the nibbles between bytes after (CNT_ERR_ORD+2) missing stop bits*/
 
-#define ORDER_STD       0       /* nibbles in a byte swapped */
-#define ORDER_INV       1       /* nibbles in a byte no swapped or two-times swapped, PC-1500 or DATA */
-#define ORDER_E         8       /* no nibbles, a byte with one start bit, newer method */
-
 #define BASE_FREQ1      4000    /* Sync, stop bits or high bit for PC-12xx, 13xx, 14xx, default, no speedup */
 #define BASE_FREQ2      2500    /* PC-1500 */
 #define BASE_FREQ3      3000    /* PC-1600, E/G-series */
@@ -361,6 +323,7 @@ wav2bin.c
 #define AMP_MIN_BLW_15  0x6C    /* AMP_MIN_BELOW start value for PC-1500 */
 
 #define TRANS_MID       0x80    /* Signal processing is done with 8-bit sample values */
+#define SAMPLES_READ    0x4000  /* Sample blocks read from the wave file with one fread */
 #define TRANS_DIFF_AIR  0x28    /* TRANS_HIGH - TRANS_MID for device AIR at start */
 
 #define TRANS_HIGH_15   0x8F    /* TRANS_HIGH from start and at reference level for PC-1500 */
@@ -386,49 +349,9 @@ typedef unsigned int	uint;
 /*			long;	    */
 typedef unsigned long	ulong;
 
-                                        /* This constants are modified by the --cspeed parameter */
- ulong  Base_FREQ1 = BASE_FREQ1 ;       /* Sync, stop bits or high bit for PC-12xx, 13xx, 14xx */
- ulong  Base_FREQ2 = BASE_FREQ2 ;       /* PC-1500 (Start bit and low bit are half of the following frequency) */
- ulong  Base_FREQ3 = BASE_FREQ3 ;       /* Sync and bit 0 of native PC-1600, PC-E500, -E200, and G-series */
-
-   int  Stop_Bit_Max = STOP_BIT_MAX ;   /* Maximum of stop bits to expect after a bit for intermediate sync */
-                                        /* The following values are sample values (8 bit) or differences of them */
-   int  Trans_High_def = TRANS_HIGH ;   /* Default level to accept transmission to high state (Schmitt Trigger)*/
-   int  Trans_Low_def  = TRANS_LOW  ;   /* Default level to accept transmission to low state (Schmitt Trigger)*/
-   int  Trans_High_15 = TRANS_HIGH_15 ; /* Transmission to high state for PC-1500 */
-   int  Trans_Low_15  = TRANS_LOW_15  ; /* Transmission to low state for PC-1500 */
-   int  Trans_High ;                    /* Adapted level to accept transmission to high state */
-   int  Trans_Low ;                     /* Adapted level to accept transmission to low state */
-   int  Amp_Diff_Rel = AMP_DIFF_REL ;   /* Filter amplitudes, relative low to the last amplitude */
-   int  Amp_Diff_Mid = AMP_DIFF_MID ;   /* Filter amplitudes, relative low to the all counted amplitudes */
-   int  Amp_Diff_Min ;                  /* Filter amplitudes, with lower absolute differences*/
-   int  Amp_Max_Above ;                 /* A maximum has to be above this sample value */
-   int  Amp_Min_Below ;                 /* A minimum has to be below this sample value */
-   int  Rate_Amp_Def  = RATE_AMP_4  ;   /* Default gain for of the last amplitude based amplification of sample values */
-   int  Amp_Dpos_Bas  ;         /* Distances of base frequency amplitudes (samples), only for warning used momently */
-   int  Amp_Dpos_Max  ;
-   int  Amp_Dpos_Min  ;
-
-double  debug_time = 10000.00000 ; /* [s] start of debugging for sample value processing - standard value needed  */
-// double  debug_time = 10.00000 ; /* start time of your debug for sample processing - for low level testing only */
-
-  char  argP[cLPF] = "" ;
-double  speed = 1 ;  /* factor of recording or CPU speed to default speed */
-  uint  SHAc = 0 ;   /* Write not to bas, but to Transfile PC plus SHA-format (name included) */
-  uint  SHCc = 0 ;   /* Write not to bin, but to Transfile PC plus SHC-format (header included) */
-  uint  TAPw = 0 ;   /* Write not to raw, but to Emulator TAP-format (header included) */
-  uint  TAPc = 0 ;              /* Input not wav, from emulator tap format (raw byte)*/
-  uint  Qcnt = 0 ;              /* Quiet, minimal output */
- ulong  linewidth = 0 ;         /* Line number or leading spaces */
-ushort  devId = DEV_PC;         /* ID number of the device from witch was digitized the wave file */
-  uint  pcId = 0 ;              /* ID number of the pocket computer */
-ushort  pcgrpId = IDENT_UNKNOWN;/* Group ID number, categorisation of the pocket computer */
-  uint  ll_Img = cLL_IMG ;      /* Constant value for max. length of BASIC IMAGE lines */
-
 const uchar  ELSEid_E2 = 0x76 ;   /* PC-G token for ELSE */
 const char* REMstr = "REM " ;
 const uchar  REMidC = '\'' ;      /* PC-1600/G/E only */
-static uchar apostrophe = 0x22 ; /* old series other value */
 
 typedef struct {        /* variables, that used near global */
     FILE*  ptrFd ;      /* source file pointer */
@@ -454,6 +377,12 @@ typedef struct {        /* variables, that used near global */
     ulong  bgnSamples ; /* First byte of audio data */
     ulong  endSamples ; /* Last byte of audio data */
       int  pre_amp ;    /* pre-amplification for wave files with low sound level */
+   uchar*  samples ;    /* sample plane, all sample blocks from bgnSamples on converted to 8-bit values */
+   short*  raw ;        /* original sample values, kept until the pre-amplification is known */
+    ulong  nbSamples ;  /* Number of sample blocks in the plane, up to the end of file */
+    ulong  nbData ;     /* Number of sample blocks inside the audio data */
+     long  cursor ;     /* Index of the next sample block to read, used instead of ftell */
+    ulong  levels[8] ;  /* Number of samples with level greater 50% 25% 12% 6% 3% 2% 1% and below */
 
     ulong  bitLen ;     /* Wave sample blocks per SHARP bit all older series */
     ulong  bitLen1 ;    /* Wave sample blocks per E500 and newer SHARP bit1 */
@@ -468,6 +397,41 @@ typedef struct {        /* variables, that used near global */
     ulong  skip_bits ;  /* Number of bits skipped or if a gap then synced last time */
      bool  sync_bit ;   /* status flag, that SyncBit is running, no normal bit reading, no ampd_cnt */
 
+    ulong  base_freq1 ; /* Base frequencies of the PC groups, 0 if not searched for, see Base_FREQ1 */
+    ulong  base_freq2 ;
+    ulong  base_freq3 ;
+    ulong  base_freq_before ; /* base frequency of the last sync search */
+      int  stop_bit_max ;   /* Maximum of stop bits to expect after a bit for intermediate sync */
+      int  trans_high ;     /* Adapted level to accept transmission to high state */
+      int  trans_low ;      /* Adapted level to accept transmission to low state */
+      int  trans_high_def ; /* Default levels of the transmissions, adapted to the sound level */
+      int  trans_low_def ;
+      int  trans_high_15 ;  /* Levels of the transmissions for PC-1500 */
+      int  trans_low_15 ;
+      int  amp_diff_rel ;   /* Filter amplitudes, relative low to the last amplitude */
+      int  amp_diff_mid ;   /* Filter amplitudes, relative low to the all counted amplitudes */
+      int  amp_diff_min ;   /* Filter amplitudes, with lower absolute differences*/
+      int  amp_max_above ;  /* A maximum has to be above this sample value */
+      int  amp_min_below ;  /* A minimum has to be below this sample value */
+      int  rate_amp_def ;   /* Default gain for of the last amplitude based amplification of sample values */
+      int  amp_dpos_bas ;   /* Distances of base frequency amplitudes (samples), only for warning used momently */
+      int  amp_dpos_max ;
+      int  amp_dpos_min ;
+     bool  amp_dpos_err ;   /* status flag, that a dropout or glitch was reported */
+     long  amp_dpos_errpos ;/* sample of the last dropout or glitch */
+     bool  stop_bit_missed ;/* status flag, that a stop bit was missing */
+     long  stop_bit_mispos ;/* sample of the last missing stop bit */
+    ulong  miss_stop_bits ; /* Counter of bytes with missing stop bits */
+
+   ushort  pcgrp_id ;   /* Group ID number of the pocket computer, set from the file header */
+     uint  ll_img ;     /* Max. length of BASIC IMAGE lines */
+    uchar  apostrophe ; /* String delimiter, old series other value */
+    ulong  stored_byte ;    /* Byte read ahead by the BASIC line reader */
+    ulong  last_line_nb ;   /* Last BASIC line number */
+     bool  last_line_eot ;  /* status flag, that the last line was followed by an End of Transmission */
+     bool  warn_pc156m1 ;   /* status flag, that the PC-1600 Mode 1 warning is still to print */
+
+OptionInfo  opt ;       /* options of this conversion, copied at the start */
     ulong  type ;       /* Type BAS or IMG (BIN, DAT), RSV, ... */
     ulong  utf8 ;       /* convert special chars from UTF8 not, or transcription, ASC for serial, DOS */
 
@@ -1253,14 +1217,15 @@ int count_errors ( int error, FileInfo*  ptrFile)
 
 
 int WriteQuaterToTap (uchar  byte,
-                       FILE** ptrFd)
+                       FILE** ptrFd,
+                   FileInfo* ptrFile)
 {
       int  error ;
 
 	do {
 		error = fputc (0xF0 | byte, *ptrFd) ;
     	if (error == EOF) {
-        	printf ("%s: Can't write in the file\n", argP) ;
+        	printf ("%s: Can't write in the file\n", ptrFile->opt.argP) ;
         	error = ERR_NOK ;
         	break ;
     	}
@@ -1271,7 +1236,8 @@ int WriteQuaterToTap (uchar  byte,
 }
 
 int WriteByteToTap  ( uchar  byte,
-                        FILE** ptrFd)
+                        FILE** ptrFd,
+                    FileInfo* ptrFile)
 {
   uchar  msq, lsq ;
     int  error = ERR_NOK ;
@@ -1280,15 +1246,15 @@ int WriteByteToTap  ( uchar  byte,
             lsq = byte & 0x0F ;
             msq = (byte >> 4) & 0x0F ;
 
-            if (TAPw == 1) { /* ORDER_INV */
-                error = WriteQuaterToTap (lsq, ptrFd) ;
+            if (ptrFile->opt.TAPw == 1) { /* ORDER_INV */
+                error = WriteQuaterToTap (lsq, ptrFd, ptrFile) ;
                 if (error != ERR_OK) break ;
-                error = WriteQuaterToTap (msq, ptrFd) ;
+                error = WriteQuaterToTap (msq, ptrFd, ptrFile) ;
         	}
             else { /* not used at moment */
-                error = WriteQuaterToTap (msq, ptrFd) ;
+                error = WriteQuaterToTap (msq, ptrFd, ptrFile) ;
                 if (error != ERR_OK) break ;
-                error = WriteQuaterToTap (lsq, ptrFd) ;
+                error = WriteQuaterToTap (lsq, ptrFd, ptrFile) ;
             }
 
 	} while (0);
@@ -1297,16 +1263,17 @@ int WriteByteToTap  ( uchar  byte,
 
 
 int WriteByteToFile (uchar   byte,
-                      FILE** ptrFd)
+                      FILE** ptrFd,
+                  FileInfo* ptrFile)
 {
     int  error = ERR_OK ;
 
-    if (TAPw != 0 ) return ( WriteByteToTap(byte, ptrFd) );
+    if (ptrFile->opt.TAPw != 0 ) return ( WriteByteToTap(byte, ptrFd, ptrFile) );
 
     if (*ptrFd != NULL) {
         error = fputc (byte, *ptrFd) ;
         if (error == EOF) {
-            printf ("\n%s: Can't write in the file\n", argP) ;
+            printf ("\n%s: Can't write in the file\n", ptrFile->opt.argP) ;
             error = ERR_FILE ;
         }
         else
@@ -1316,7 +1283,8 @@ int WriteByteToFile (uchar   byte,
 }
 
 int WriteCharToFile (char   byte,
-                     FILE** ptrFd)
+                     FILE** ptrFd,
+                 FileInfo* ptrFile)
 {
     int  error ;
 
@@ -1324,7 +1292,7 @@ int WriteCharToFile (char   byte,
     if (*ptrFd != NULL) {
         error = fputc (byte, *ptrFd) ;
         if (error == EOF) {
-            printf ("\n%s: Can't write in the file\n", argP) ;
+            printf ("\n%s: Can't write in the file\n", ptrFile->opt.argP) ;
             error = ERR_FILE ;
         }
         else
@@ -1334,7 +1302,8 @@ int WriteCharToFile (char   byte,
 }
 
 int WriteStringToFile (char*  ptrStr,
-                       FILE**  ptrFd)
+                       FILE**  ptrFd,
+                   FileInfo*  ptrFile)
 {
     int  error ;
 
@@ -1342,7 +1311,7 @@ int WriteStringToFile (char*  ptrStr,
     if (*ptrFd != NULL) {
         error = fputs (ptrStr, *ptrFd) ;
         if (error == EOF) {
-            printf ("\n%s: Can't write in the file\n", argP) ;
+            printf ("\n%s: Can't write in the file\n", ptrFile->opt.argP) ;
             error = ERR_FILE ;
         }
         else
@@ -1354,7 +1323,8 @@ int WriteStringToFile (char*  ptrStr,
 
 int ReadStringFromFile (char*  ptrStr,
                         long  nb,
-                        FILE**  ptrFd)
+                        FILE**  ptrFd,
+                    FileInfo*  ptrFile)
 {
     int  ii ;
     int  inVal ;
@@ -1365,7 +1335,7 @@ int ReadStringFromFile (char*  ptrStr,
     for ( ii = 0 ; ii < nb ; ++ii  ) {
         inVal = fgetc (*ptrFd) ;
         if (inVal == EOF) {
-            printf ("\n%s:rstring - Can't read over End Of File\n", argP) ;
+            printf ("\n%s:rstring - Can't read over End Of File\n", ptrFile->opt.argP) ;
             error = ERR_FILE ;
             break ;
         }
@@ -1377,12 +1347,13 @@ int ReadStringFromFile (char*  ptrStr,
 
 
 int ReadLongFromFile (ulong*  ptrVal,
-                      FILE**  ptrFd)
+                      FILE**  ptrFd,
+                  FileInfo*  ptrFile)
 {
     char  str[10] ;
      int  error ;
 
-    error = ReadStringFromFile (str, 4, ptrFd) ;
+    error = ReadStringFromFile (str, 4, ptrFd, ptrFile) ;
     CvStringIToLong (str, ptrVal) ;
 
     return (error);
@@ -1390,12 +1361,13 @@ int ReadLongFromFile (ulong*  ptrVal,
 
 
 int ReadShortFromFile (uint*  ptrVal,
-                       FILE**  ptrFd)
+                       FILE**  ptrFd,
+                   FileInfo*  ptrFile)
 {
     char  str[10] ;
      int  error ;
 
-    error = ReadStringFromFile (str, 2, ptrFd) ;
+    error = ReadStringFromFile (str, 2, ptrFd, ptrFile) ;
     CvStringIToShort (str, ptrVal) ;
 
     return (error);
@@ -1413,97 +1385,97 @@ int ReadWavHead (ulong*  ptrFreq,
       int  error ;
 
     do {
-        error = ReadStringFromFile (str, 4, &ptrFile->ptrFd) ;
+        error = ReadStringFromFile (str, 4, &ptrFile->ptrFd, ptrFile) ;
         if (error != ERR_OK) break ;
         if (strcmp (str, "RIFF") != 0) {
-            printf ("\n%s: The contents of the file does not begin with 'RIFF'. Unsupported file!\n", argP) ;
+            printf ("\n%s: The contents of the file does not begin with 'RIFF'. Unsupported file!\n", ptrFile->opt.argP) ;
             error = ERR_FMT ;
             break ;
         }
         /* file length -8 (offset) */
-        error = ReadLongFromFile (&tmpL, &ptrFile->ptrFd) ;
+        error = ReadLongFromFile (&tmpL, &ptrFile->ptrFd, ptrFile) ;
         if (error != ERR_OK) break ;
 
-        error = ReadStringFromFile (str, 8, &ptrFile->ptrFd) ;
+        error = ReadStringFromFile (str, 8, &ptrFile->ptrFd, ptrFile) ;
         if (error != ERR_OK) break ;
         if (strcmp (str, "WAVEfmt ") != 0) { /* format chunk has to be the first */
-            printf ("\n%s: File header format isn't 'WAVEfmt'. This is not a supported format.\n", argP) ;
+            printf ("\n%s: File header format isn't 'WAVEfmt'. This is not a supported format.\n", ptrFile->opt.argP) ;
             error = ERR_FMT ;
             break ;
         }
         /* header length (offset) */
-        error = ReadLongFromFile (&chunkSize, &ptrFile->ptrFd) ;
+        error = ReadLongFromFile (&chunkSize, &ptrFile->ptrFd, ptrFile) ;
         if (error != ERR_OK) break ;
 
-        error = ReadShortFromFile (&tmpS, &ptrFile->ptrFd) ;
+        error = ReadShortFromFile (&tmpS, &ptrFile->ptrFd, ptrFile) ;
         if (error != ERR_OK) break ;
         formatTag = tmpS ;
         if (tmpS != 1 && tmpS != 0xFFFE ) { /* PCM or WAVE_FORMAT_EXTENSIBLE */
-            printf ("\n%s: Wave data format tag %d isn't pure PCM. Unsupported!\n", argP, tmpS) ;
+            printf ("\n%s: Wave data format tag %d isn't pure PCM. Unsupported!\n", ptrFile->opt.argP, tmpS) ;
             error = ERR_FMT ;
             break ;
         }
 
-        error = ReadShortFromFile (&tmpS, &ptrFile->ptrFd) ;
+        error = ReadShortFromFile (&tmpS, &ptrFile->ptrFd, ptrFile) ;
         if (error != ERR_OK) break ;
         channels = tmpS ;
         /* channels = 1 mono, 2 = stereo, data has to be in the first channel */
         if (tmpS != 1) {
-            if (Qcnt == 0) printf ("%s: Audio format has %d channels, not Mono\n", argP, channels) ;
+            if (ptrFile->opt.Qcnt == 0) printf ("%s: Audio format has %d channels, not Mono\n", ptrFile->opt.argP, channels) ;
             if (tmpS > 4) {
-                printf ("%s: To much audio channels are included.\n", argP) ;
+                printf ("%s: To much audio channels are included.\n", ptrFile->opt.argP) ;
                 error = ERR_FMT ;
                 break ;
             }
         }
         /* sample rate /s */
-        error = ReadLongFromFile (ptrFreq, &ptrFile->ptrFd) ;
+        error = ReadLongFromFile (ptrFreq, &ptrFile->ptrFd, ptrFile) ;
         if (error != ERR_OK) break ;
-        error = ReadLongFromFile (&tmpL, &ptrFile->ptrFd) ;
+        error = ReadLongFromFile (&tmpL, &ptrFile->ptrFd, ptrFile) ;
         if (error != ERR_OK) break ;            /* rate * frame size B/s */
 
-        error = ReadShortFromFile (&tmpS, &ptrFile->ptrFd) ;
+        error = ReadShortFromFile (&tmpS, &ptrFile->ptrFd, ptrFile) ;
         if (error != ERR_OK) break ;
         ptrFile->blockAlign = tmpS ;            /* blockAlign = Data block size of a sample block (bytes) */
         ptrFile->bytesPerP = tmpS / channels ;  /* byte length of a sample point */
         if (ptrFile->bytesPerP == 1) {
             /* 8_bit_wave */
-            error = ReadShortFromFile (&tmpS, &ptrFile->ptrFd) ;
+            error = ReadShortFromFile (&tmpS, &ptrFile->ptrFd, ptrFile) ;
             if (error != ERR_OK) break ;
             if (tmpS != 8) {
-                printf ("\n%s: Wave format error - %d isn't 8 bits/sample\n", argP, tmpS) ;
+                printf ("\n%s: Wave format error - %d isn't 8 bits/sample\n", ptrFile->opt.argP, tmpS) ;
                 error = ERR_FMT ;
                 break ;
             }
         }
         else if (ptrFile->bytesPerP <= 4) {     /* max. 32 bit allowed */
             /* 16_bit_wave and more */
-            error = ReadShortFromFile (&tmpS, &ptrFile->ptrFd) ;
+            error = ReadShortFromFile (&tmpS, &ptrFile->ptrFd, ptrFile) ;
             if (error != ERR_OK) break ;
             if (tmpS % 8 != 0) {
-                printf ("\n%s-Warning: Format has %d bits/sample value - experimentally.\n", argP, tmpS) ;
+                printf ("\n%s-Warning: Format has %d bits/sample value - experimentally.\n", ptrFile->opt.argP, tmpS) ;
                 // error = ERR_FMT ;
                 // break ;
             }
-            else if (Qcnt == 0 && (tmpS != 16  ||
-                     ptrFile->debug > 0) ) printf ("%s: Format has %d bits/sample value.\n", argP, tmpS) ;
+            else if (ptrFile->opt.Qcnt == 0 && (tmpS != 16  ||
+                     ptrFile->debug > 0) ) printf ("%s: Format has %d bits/sample value.\n", ptrFile->opt.argP, tmpS) ;
 
         }
         else {
-            printf ("\n%s: Format %d bytes/sample is unsupported.\n", argP, tmpS ) ;
+            printf ("\n%s: Format %d bytes/sample is unsupported.\n", ptrFile->opt.argP, tmpS ) ;
             error = ERR_FMT ;
             break ;
         }
         if (formatTag == 0xFFFE && chunkSize == 40 ) { /* WAVE_FORMAT_EXTENSIBLE */
             error = fseek (ptrFile->ptrFd, 8, SEEK_CUR) ;
             if (error != ERR_OK) {
-                printf ("\n%s:wavheadext - Can't seek the wave file\n", argP) ;
+                printf ("\n%s:wavheadext - Can't seek the wave file\n", ptrFile->opt.argP) ;
                 break ;
             }
-            error = ReadShortFromFile (&tmpS, &ptrFile->ptrFd) ;
+            error = ReadShortFromFile (&tmpS, &ptrFile->ptrFd, ptrFile) ;
             if (error != ERR_OK) break ;
             if (tmpS != 1 ) { /* PCM  */
-                printf ("\n%s: Wavex data format tag %d isn't non-float PCM. Unsupported!\n", argP, tmpS) ;
+                printf ("\n%s: Wavex data format tag %d isn't non-float PCM. Unsupported!\n", ptrFile->opt.argP, tmpS) ;
                 error = ERR_FMT ;
                 break ;
             }
@@ -1512,16 +1484,16 @@ int ReadWavHead (ulong*  ptrFreq,
         if (chunkSize > 0x10) { /* read additional bytes for 46 byte or longer headers or wavex */
             error = fseek (ptrFile->ptrFd, (long) chunkSize - 0x10, SEEK_CUR) ;
             if (error != ERR_OK) {
-                printf ("\n%s:wavhead44x - Can't seek the wave file\n", argP) ;
+                printf ("\n%s:wavhead44x - Can't seek the wave file\n", ptrFile->opt.argP) ;
                 break ;
             }
         }
-        error = ReadStringFromFile (str, 4, &ptrFile->ptrFd) ;
+        error = ReadStringFromFile (str, 4, &ptrFile->ptrFd, ptrFile) ;
         if (error != ERR_OK) break ;
 
         position = ftell( ptrFile->ptrFd ) ; /* Pos.0x28 usually */
             if (position <= 0) {
-                printf ("\n%s:wavhead search1 'data' - Can't ftell the wave file\n", argP) ;
+                printf ("\n%s:wavhead search1 'data' - Can't ftell the wave file\n", ptrFile->opt.argP) ;
                 error = ERR_FILE ;
                 break ;
         }
@@ -1529,18 +1501,18 @@ int ReadWavHead (ulong*  ptrFreq,
         if (strcmp (str, "data") != 0) { /* check always for wave header 46 byte from ffmpeg */
             error = fseek (ptrFile->ptrFd, -2, SEEK_CUR) ;
             if (error != ERR_OK) {
-                printf ("\n%s:wavhead46 - Can't seek the wave file\n", argP) ;
+                printf ("\n%s:wavhead46 - Can't seek the wave file\n", ptrFile->opt.argP) ;
                 break ;
             }
-            error = ReadStringFromFile (str, 4, &ptrFile->ptrFd) ;
+            error = ReadStringFromFile (str, 4, &ptrFile->ptrFd, ptrFile) ;
             if (error != ERR_OK) break ;
 
             if (strcmp (str, "data") != 0) {
-                error = ReadStringFromFile (str, 8, &ptrFile->ptrFd) ;
+                error = ReadStringFromFile (str, 8, &ptrFile->ptrFd, ptrFile) ;
                 if (error != ERR_OK) break ;
 
                 /* check for wave 46 + fact chunk = 58 byte header */
-                error = ReadStringFromFile (str, 4, &ptrFile->ptrFd) ;
+                error = ReadStringFromFile (str, 4, &ptrFile->ptrFd, ptrFile) ;
                 if (error != ERR_OK) break ;
 
                 while (strcmp (str, "data") != 0 && ii <7) { /* maximum chunks */
@@ -1548,13 +1520,13 @@ int ReadWavHead (ulong*  ptrFreq,
                     if (ii==0) {
                         error = fseek (ptrFile->ptrFd, position, SEEK_SET) ; /* rewind to first try*/
                         if (error != ERR_OK) {
-                            printf ("\n%s:wavhead search1 'data' - Can't seek the file\n", argP) ;
+                            printf ("\n%s:wavhead search1 'data' - Can't seek the file\n", ptrFile->opt.argP) ;
                             error = ERR_FILE ;
                             break ;
                         }
                     }
                     else {
-                        error = ReadLongFromFile (&tmpL, &ptrFile->ptrFd) ;
+                        error = ReadLongFromFile (&tmpL, &ptrFile->ptrFd, ptrFile) ;
                         if (error != ERR_OK) break ;
                         if (tmpL%2 > 0) ++tmpL; /* 0-byte follows for word boundary */
                         position += 4;
@@ -1567,11 +1539,11 @@ int ReadWavHead (ulong*  ptrFreq,
                         error = fseek (ptrFile->ptrFd, (long) tmpL, SEEK_CUR) ; /* rewind */
                         position += (long) tmpL;
                         if (error != ERR_OK) {
-                            printf ("\n%s:wavhead search 'data' - Can't seek the file\n", argP) ;
+                            printf ("\n%s:wavhead search 'data' - Can't seek the file\n", ptrFile->opt.argP) ;
                             error = ERR_FILE ;
                             break ;
                         }
-                        error = ReadStringFromFile (str, 4, &ptrFile->ptrFd) ;
+                        error = ReadStringFromFile (str, 4, &ptrFile->ptrFd, ptrFile) ;
                         position += 4;
                         if (error != ERR_OK) break ;
                     }
@@ -1581,18 +1553,18 @@ int ReadWavHead (ulong*  ptrFreq,
             }
         }
         if (error != ERR_OK || strcmp (str, "data") != 0) {
-            printf ("\n%s: Header %u after 'fmt ' isn't 'data'\n", argP, ii) ;
+            printf ("\n%s: Header %u after 'fmt ' isn't 'data'\n", ptrFile->opt.argP, ii) ;
             error = ERR_FMT ;
             break ;
         }
 
         /* length off audio data block */
-        error = ReadLongFromFile (&tmpL, &ptrFile->ptrFd) ;
+        error = ReadLongFromFile (&tmpL, &ptrFile->ptrFd, ptrFile) ;
         if (error != ERR_OK) break ;
 
         position = ftell( ptrFile->ptrFd ) ;
         if (position <= 0) {
-            printf ("\n%s:wavhead - Can't ftell the wave file\n", argP) ;
+            printf ("\n%s:wavhead - Can't ftell the wave file\n", ptrFile->opt.argP) ;
             error = ERR_FILE ;
             break ;
         }
@@ -1604,174 +1576,232 @@ int ReadWavHead (ulong*  ptrFreq,
     return (error);
 }
 
-/* returns the exact time stamp of a sample, usually the time AFTER a bit or byte        */
-/* this can be used, to correct signal errors with an audio editor, tested with Audacity */
+/* returns the position of the reader, the sample cursor or the file position of a tap file */
+long WavTell (FileInfo*  ptrFile)
+{
+    if (ptrFile->opt.TAPc > 0) return (ftell (ptrFile->ptrFd)) ;
+    return (ptrFile->cursor) ;
+}
 
-double WavTime (FileInfo*  ptrFile)
+/* sets the reader back to a position returned from WavTell */
+int WavSeek (FileInfo*  ptrFile, long  position)
 {
-long position = ftell( ptrFile->ptrFd ) ;
-        if (position <= 0) {
-            printf ("\n%s:wavtime - Can't ftell the wave file\n", argP) ;
-            exit ( ERR_FILE ) ;
+    if (ptrFile->opt.TAPc > 0) return (fseek (ptrFile->ptrFd, position, SEEK_SET)) ;
+    ptrFile->cursor = position ;
+    return (ERR_OK) ;
+}
+
+/* converts the original sample values to 8-bit values with the actual pre-amplification */
+void ConvertSamples (FileInfo*  ptrFile)
+{
+    const short*  raw = ptrFile->raw ;
+          uchar*  samples = ptrFile->samples ;
+           ulong  ii, nbSamples = ptrFile->nbSamples ;
+            long  val, amp = ptrFile->pre_amp ;
+             int  inVal, inValL ;
+
+    if (ptrFile->bytesPerP > 1) {                               /* 16_bit_wave and longer */
+        for (ii = 0 ; ii < nbSamples ; ++ii) {
+            val = raw[ii] ;
+            if (amp > 1) {                                      /* Amplification of 16-bit low level recordings */
+                val *= amp ;
+                if (val > 0x7FFF) val = 0x7FFF ;       /* clipping */
+                else if (val < -32768) val = -32768 ;  /* clipping */
+            }
+            inValL = (val & 0xFF) > 0x7F ;                      /* 16 bit L, compensate rounding errors */
+            inVal  = val >>8 & 0xFF ;
+            samples[ii] = (uchar) ((((inVal == 0x7F)? 0: inValL) + inVal + 0x80) & 0xFF) ; /* convert 16-bit-H to 8-bit-L */
+        }
+    }
+    else if (amp > 1) {                                         /* Amplification of 8-bit low level recordings */
+        for (ii = 0 ; ii < nbSamples ; ++ii) {
+            val = TRANS_MID + (raw[ii] - TRANS_MID) * amp ;
+            if (val > 0xFF) val = 0xFF ; /* clipping */
+            else if (val < 0 ) val = 0 ; /* clipping */
+            samples[ii] = (uchar) val ;
         }
-return (( position - ptrFile->blockAlign - (long) ptrFile->bgnSamples)/(float) (ptrFile->wav_freq * ptrFile->blockAlign)) ;
+    }
+    else {
+        for (ii = 0 ; ii < nbSamples ; ++ii) samples[ii] = (uchar) raw[ii] ;
+    }
 }
 
+/* releases the sample plane */
+void FreeSamples (FileInfo*  ptrFile)
+{
+    free (ptrFile->raw) ;
+    free (ptrFile->samples) ;
+    ptrFile->raw     = NULL ;
+    ptrFile->samples = NULL ;
+}
 
-int ReadSampleFromWav (int *ptrSampleVal,
-                       FileInfo*  ptrFile)
+/* reads all sample blocks of the wave file at once, only the first channel is kept,
+   converts them to 8-bit without pre-amplification and counts the sound levels */
+int LoadSamplesFromWav (FileInfo*  ptrFile)
 {
-     int  inVal, inValL ;
-    short val16 ;
-    long  val ;
-    uint  jj ;
+    uchar  *buffer = NULL, *ptrBlock, *ptrSample ;
+    short  *raw ;
+    uchar  level[256] ;
+    ulong  ii, jj, count, all_samples ;
+     long  size ;
+     uint  blockAlign = ptrFile->blockAlign, hi = ptrFile->bytesPerP - 1 ;
+      int  inVal, inValL ;
      int  error = ERR_OK ;
 
-    do {
-            inVal = fgetc (ptrFile->ptrFd) ;                         /* 8_bit_wave original implemented (uchar) */
-            if (inVal == EOF) {
-                if (Qcnt == 0) printf ("\nEnd of File\n") ;
-                error = ERR_EOF ;
-                break ;
-            }
-            if (ptrFile->bytesPerP > 1) {                            /* 16_bit_wave and longer */
-                for (jj = 1 ; jj < ptrFile->bytesPerP ; ++jj ) {
-                    inValL = inVal ;                                 /* 16 bit L */
-                    inVal = fgetc (ptrFile->ptrFd) ;                 /* 16 bit H, wave build with signed int */
-                    if (inVal == EOF) {
-                        if (Qcnt == 0) printf ("\nEnd of File\n") ;
-                        error = ERR_EOF ;
-                        break ;
-                    }
-                }
-                if (error != ERR_OK) break ;
+    /* quantisation of levels from axis absolute, index 7 for the lowest level */
+    for (ii = 0 ; ii < 256 ; ++ii) {
+        inVal = (ii > TRANS_MID) ? ii - TRANS_MID : TRANS_MID - ii ;
+        for (jj = 0 ; jj < 7 && inVal <= 0x3F ; ++jj) inVal <<=1 ;
+        level[ii] = (uchar) jj ;
+    }
+    for (jj = 0 ; jj < 8 ; ++jj) ptrFile->levels[jj] = 0 ;
+    all_samples = (ptrFile->endSamples - ptrFile->bgnSamples) / blockAlign ;
 
-                if (ptrFile->pre_amp > 1) {                         /* Amplification of 16-bit low level recordings */
-                    val16 = inVal<<8 | inValL ;
+    do {
+        error = fseek (ptrFile->ptrFd, 0, SEEK_END) ;
+        if (error == ERR_OK) size = ftell (ptrFile->ptrFd) ;
+        if (error != ERR_OK || size <= 0) {
+            printf ("\n%s:load - Can't seek the wave file\n", ptrFile->opt.argP) ;
+            error = ERR_FILE ;
+            break ;
+        }
+        ptrFile->nbSamples = 0 ;
+        if ((ulong) size > ptrFile->bgnSamples)
+            ptrFile->nbSamples = ((ulong) size - ptrFile->bgnSamples) / blockAlign ;
+        ptrFile->nbData = (ptrFile->endSamples + 1 - ptrFile->bgnSamples) / blockAlign ;
+
+        ptrFile->raw     = malloc (ptrFile->nbSamples * sizeof (short) + 1) ;
+        ptrFile->samples = malloc (ptrFile->nbSamples + 1) ;
+        buffer           = malloc (SAMPLES_READ * blockAlign) ;
+        if (ptrFile->raw == NULL || ptrFile->samples == NULL || buffer == NULL) {
+            printf ("\n%s:load - Not enough memory for the wave file\n", ptrFile->opt.argP) ;
+            error = ERR_MEM ;
+            break ;
+        }
 
-                    val = ptrFile->pre_amp * (long) val16 ;
-                    if (val > 0x7FFF) val = 0x7FFF ;       /* clipping */
-                    else if (val < -32768) val = -32768 ;  /* clipping */
+        error = fseek (ptrFile->ptrFd, (long) ptrFile->bgnSamples, SEEK_SET) ;
+        if (error != ERR_OK) {
+            printf ("\n%s:load - Can't seek the wave file\n", ptrFile->opt.argP) ;
+            error = ERR_FILE ;
+            break ;
+        }
 
-                    val16 = (short) val ;
-                    inValL = val16     & 0xFF ;
-                    inVal  = val16 >>8 & 0xFF ;
-                }
+        raw = ptrFile->raw ;
+        for (ii = 0 ; ii < ptrFile->nbSamples ; ii += count) {
+            count = ptrFile->nbSamples - ii ;
+            if (count > SAMPLES_READ) count = SAMPLES_READ ;
 
-                if (inValL > 0x7F) inValL = 1 ; else inValL = 0 ;  /* 16 bit L, compensate rounding errors */
-                inVal = (((inVal == 0x7F)? 0: inValL) + inVal + 0x80) & 0xFF ; /* convert 16-bit-H to 8-bit-L */
+            if (fread (buffer, blockAlign, count, ptrFile->ptrFd) != count) {
+                printf ("\n%s:load - Can't read the wave file\n", ptrFile->opt.argP) ;
+                error = ERR_FILE ;
+                break ;
             }
-            else if (ptrFile->pre_amp > 1) {                       /* Amplification of 8-bit low level recordings */
-                if ( inVal > TRANS_MID ) {
-                    inVal = TRANS_MID + (inVal - TRANS_MID) * ptrFile->pre_amp ;
-                    if (inVal > 0xFF) inVal = 0xFF ; /* clipping */
-                }
-                else if (inVal < TRANS_MID) {
-                    inVal = TRANS_MID - (TRANS_MID - inVal) * ptrFile->pre_amp ;
-                    if (inVal < 0 ) inVal = 0 ; /* clipping */
+            ptrBlock  = buffer ;
+            ptrSample = ptrFile->samples + ii ;
+            if (hi > 0) {                                       /* 16_bit_wave and longer, wave build with signed int */
+                for (jj = 0 ; jj < count ; ++jj, ptrBlock += blockAlign) {
+                    raw[ii + jj] = (short) (ptrBlock[hi] <<8 | ptrBlock[hi - 1]) ;
+                    inValL = ptrBlock[hi - 1] > 0x7F ;          /* 16 bit L, compensate rounding errors */
+                    inVal  = ptrBlock[hi] ;
+                    ptrSample[jj] = (uchar) ((((inVal == 0x7F)? 0: inValL) + inVal + 0x80) & 0xFF) ; /* convert 16-bit-H to 8-bit-L */
                 }
             }
-            if (ptrFile->blockAlign > ptrFile->bytesPerP) {        /* if not mono, then skip other channels */
-                /* read is much faster than fseek, fread would be faster than fgetc */
-                for (jj = ptrFile->bytesPerP ; jj < ptrFile->blockAlign ; ++jj ) {
-                    inValL = fgetc (ptrFile->ptrFd) ;
-                    if (inValL == EOF) {
-                        if (Qcnt == 0) printf ("\nEnd of File\n") ;
-                        error = ERR_EOF ;
-                        break ;
-                    }
-                }
-                if (error != ERR_OK) break ;
-                /*  Slow code
-                error = fseek (ptrFile->ptrFd, (long) (ptrFile->blockAlign - ptrFile->bytesPerP), SEEK_CUR) ;
-                if (error != ERR_OK) {
-                    printf ("\n%s:rsample - Can't seek the file\n", argP) ;
-                    error = ERR_FILE ;
-                    break ;
-                } */
+            else {                                              /* 8_bit_wave original implemented (uchar) */
+                for (jj = 0 ; jj < count ; ++jj, ptrBlock += blockAlign)
+                    raw[ii + jj] = ptrSample[jj] = ptrBlock[0] ;
             }
+            /* distribution of the sound level, used for the pre-amplification */
+            for (jj = 0 ; jj < count && ii + jj < all_samples ; ++jj)
+                ++ptrFile->levels[level[ptrSample[jj]]] ;
+        }
+        if (error != ERR_OK) break ;
+
+        ptrFile->cursor = 0 ;
+
     } while (0) ;
-    *ptrSampleVal = inVal ;
+
+    free (buffer) ;
+    if (error != ERR_OK) FreeSamples (ptrFile) ;
     return (error);
 }
 
+/* returns the exact time stamp of a sample, usually the time AFTER a bit or byte        */
+/* this can be used, to correct signal errors with an audio editor, tested with Audacity */
 
-int AnalyseSoundLevelOfWav (FileInfo*  ptrFile)
+double WavTime (FileInfo*  ptrFile)
 {
-        /*           nb of samples with level greater  */
-        /*                    50% 25% 12% 6% 3% 2% 1%  */
-         ulong  distrib[7] = { 0,  0,  0, 0, 0, 0, 0 } ;
-         ulong  ii, all_samples, clip_samples ;
-           uint level, jj, jmax ;
-           int  inVal ,
-                error = ERR_OK ;
+    return ((ptrFile->cursor - 1) / (double) ptrFile->wav_freq) ;
+}
 
-    all_samples = (ptrFile->endSamples - ptrFile->bgnSamples) / ptrFile->blockAlign ;
-    ptrFile->pre_amp = 1 ;
 
-    do {
-        for (ii = 0; ii < all_samples ; ++ii ) {
+int ReadSampleFromWav (int *ptrSampleVal,
+                       FileInfo*  ptrFile)
+{
+    long  cursor = ptrFile->cursor ;
 
-            error = ReadSampleFromWav (&inVal, ptrFile);
-            if (error != ERR_OK) break ;
+    if (cursor < 0) {                                       /* before the audio data */
+        *ptrSampleVal = TRANS_MID ;
+        ++ptrFile->cursor ;
+        return (ERR_OK) ;
+    }
+    if (cursor >= (long) ptrFile->nbSamples) {
+        if (ptrFile->opt.Qcnt == 0) printf ("\nEnd of File\n") ;
+        *ptrSampleVal = EOF ;
+        return (ERR_EOF) ;
+    }
+    /* sample values were converted to 8-bit and pre-amplified while loading */
+    *ptrSampleVal = ptrFile->samples[cursor] ;
+    ptrFile->cursor = cursor + 1 ;
 
-            if (inVal > TRANS_MID) level = inVal - TRANS_MID ;
-            else level = TRANS_MID - inVal ; /* level from axis absolute */
+    return (ERR_OK);
+}
 
-            /* quantisation of levels */
-            for (jj = 0; jj < 7 ; ++jj) {
-                if (level > 0x3F) {
-                        ++distrib[jj] ;
-                        break ;
-                }
-                else level <<=1 ;
-            }
-        }
-        clip_samples = all_samples /256 ; /* part of samples, that may be clipped */
-        ii = 0 ;
 
-        if (ptrFile->bytesPerP > 1 ) jmax = 6 ;
-        else jmax = 4 ; /* gain max. 16 with 8-bit */
+int AnalyseSoundLevelOfWav (FileInfo*  ptrFile)
+{
+         ulong  ii, all_samples, clip_samples ;
+           uint jj, jmax ;
 
-        /* Analyse the distribution of the sound level */
-        for (jj = 0; jj < jmax ; ++jj) {
-            ii += distrib[jj] ;
-            if (ii > clip_samples ) break ;
-            ptrFile->pre_amp <<=1 ;
-        }
-        if (Qcnt == 0 && ptrFile->pre_amp > 1)
-            printf ("Wave file was not normalized. %s pre-amplify with factor %i internally\n", argP, ptrFile->pre_amp);
+    /* the levels were counted while loading the samples */
+    all_samples = (ptrFile->endSamples - ptrFile->bgnSamples) / ptrFile->blockAlign ;
+    clip_samples = all_samples /256 ; /* part of samples, that may be clipped */
+    ptrFile->pre_amp = 1 ;
+    ii = 0 ;
 
-        error = fseek (ptrFile->ptrFd, ptrFile->bgnSamples, SEEK_SET) ; /* rewind */
-        if (error != ERR_OK) {
-            printf ("\n%s:analyse - Can't seek the file\n", argP) ;
-            error = ERR_FILE ;
-            break ;
-        }
+    if (ptrFile->bytesPerP > 1 ) jmax = 6 ;
+    else jmax = 4 ; /* gain max. 16 with 8-bit */
 
-    } while (0) ;
+    /* Analyse the distribution of the sound level */
+    for (jj = 0; jj < jmax ; ++jj) {
+        ii += ptrFile->levels[jj] ;
+        if (ii > clip_samples ) break ;
+        ptrFile->pre_amp <<=1 ;
+    }
+    if (ptrFile->opt.Qcnt == 0 && ptrFile->pre_amp > 1)
+        printf ("Wave file was not normalized. %s pre-amplify with factor %i internally\n", ptrFile->opt.argP, ptrFile->pre_amp);
+    if (ptrFile->pre_amp > 1) ConvertSamples (ptrFile) ;
 
-    return (error); /* result stored in ptrFile->pre_amp */
+    return (ERR_OK); /* result stored in ptrFile->pre_amp */
 }
 
 /* Detect wave amplitudes in sample value triples */
-int DetectAmpsFromVals (int* inVals, int* ptrAmpd_min, int* ptrAmpd_max, int* ptrLast_ampd, int* ptrDampd_min)
+int DetectAmpsFromVals (int* inVals, int* ptrAmpd_min, int* ptrAmpd_max, int* ptrLast_ampd, int* ptrDampd_min, FileInfo*  ptrFile)
 {
     int ampd = 0 ;
     int amp2 ; /* last difference Max-Min (sample value) is one filter criteria */
 
     if ( inVals[0] >= inVals[1] && inVals[1] <  inVals[2] ) { /* is a Min? */
-            amp2 = (*ptrAmpd_max - *ptrAmpd_min)/Amp_Diff_Rel ;
+            amp2 = (*ptrAmpd_max - *ptrAmpd_min)/ptrFile->amp_diff_rel ;
             if (amp2 < *ptrDampd_min ) amp2 = *ptrDampd_min ; /* filter false amps */
-            if (inVals[1] < Amp_Min_Below && inVals[1] < *ptrAmpd_max - amp2) {
+            if (inVals[1] < ptrFile->amp_min_below && inVals[1] < *ptrAmpd_max - amp2) {
                 if ( *ptrLast_ampd != -1 || inVals[1] < *ptrAmpd_min) *ptrAmpd_min = inVals[1] ; /* depress steps */
                 ampd = -1 ;
             } // end if: Min!
     } // end if: Min?
     else if ( inVals[0] <= inVals[1] && inVals[1] >  inVals[2] ) { /* is a Max? */
-            amp2 = (*ptrAmpd_max - *ptrAmpd_min)/Amp_Diff_Rel ;
+            amp2 = (*ptrAmpd_max - *ptrAmpd_min)/ptrFile->amp_diff_rel ;
             if (amp2 < *ptrDampd_min ) amp2 = *ptrDampd_min ; /* filter false amps */
-            if (inVals[1] > Amp_Max_Above && inVals[1] > *ptrAmpd_min + amp2) {
+            if (inVals[1] > ptrFile->amp_max_above && inVals[1] > *ptrAmpd_min + amp2) {
                 if (*ptrLast_ampd != 1 || inVals[1] > *ptrAmpd_max) *ptrAmpd_max = inVals[1] ; /* depress steps */
                 ampd = 1 ;
             } // end if: Max!
@@ -1785,40 +1815,29 @@ int DetectAmpsFromVals (int* inVals, int* ptrAmpd_min, int* ptrAmpd_max, int* pt
 int FindAmpsFromWav (int* inVals, int* ptrAmpd_min, int* ptrAmpd_max, int* ptrAmp, int* ptrApos, int* ptrDampd_min, FileInfo*  ptrFile)
 {
     long  position ;
-    long  tmp, tmpS ;
+    long  tmp ;
      int  ampd, ii ;
      int  error = ERR_OK ;
 
-    position = ftell( ptrFile->ptrFd ) ;
-    if (position <= 0) {
-            printf ("\n%s:famps - Can't ftell the wave file\n", argP) ;
-            error = ERR_FILE ;
-            return (error) ;
-    }
+    position = ptrFile->cursor ;
     /* One wave of freq of BIT_0 */
     ii = - ( (ptrFile->bitLen + 0) * BIT_1 / ( WAV_NB_BIT1 * BIT_0 )) ; /* relative position in samples from start of actual bit */
     *ptrApos = ii * 2 ; /* start value for position of last amp */
 
-    tmpS = (long) ptrFile->blockAlign * ii ;
     /* Rewind one wave of the frequency of BIT_0 */
-    if (position >= (long) ptrFile->bgnSamples - tmpS ) error = fseek (ptrFile->ptrFd, tmpS , SEEK_CUR) ;
-    if (error != ERR_OK) {
-            printf ("\n%s:famps - Can't seek the file: %ld\n", argP, position) ;
-            error = ERR_FILE ;
-            return (error) ;
-    }
+    if (position + ii >= 0) ptrFile->cursor += ii ;
 
-    *ptrAmpd_min = Trans_Low ;
-    *ptrAmpd_max = Trans_High ;
+    *ptrAmpd_min = ptrFile->trans_low ;
+    *ptrAmpd_max = ptrFile->trans_high ;
 
     error = ReadSampleFromWav (&inVals[0], ptrFile) ;
     if (error != ERR_OK) return (error) ;
     ++ii ;
 
-    if (inVals[0] > Trans_High) *ptrAmpd_max = inVals[0] ;
-    else                        *ptrAmpd_max = Trans_High ;
-    if (inVals[0] < Trans_Low)  *ptrAmpd_min = inVals[0] ;
-    else                        *ptrAmpd_min = Trans_Low ;
+    if (inVals[0] > ptrFile->trans_high) *ptrAmpd_max = inVals[0] ;
+    else                        *ptrAmpd_max = ptrFile->trans_high ;
+    if (inVals[0] < ptrFile->trans_low)  *ptrAmpd_min = inVals[0] ;
+    else                        *ptrAmpd_min = ptrFile->trans_low ;
 
     error = ReadSampleFromWav (&inVals[1], ptrFile) ;
     if (error != ERR_OK) return (error) ;
@@ -1833,7 +1852,7 @@ int FindAmpsFromWav (int* inVals, int* ptrAmpd_min, int* ptrAmpd_max, int* ptrAm
         if (error != ERR_OK) break ;
         ++ii ;
 
-        ampd = DetectAmpsFromVals (inVals, ptrAmpd_min, ptrAmpd_max, ptrAmp, ptrDampd_min) ;
+        ampd = DetectAmpsFromVals (inVals, ptrAmpd_min, ptrAmpd_max, ptrAmp, ptrDampd_min, ptrFile) ;
         if (ampd != 0 ) {
                 *ptrAmp = ampd ;
                 *ptrApos = ii ;
@@ -1845,25 +1864,16 @@ int FindAmpsFromWav (int* inVals, int* ptrAmpd_min, int* ptrAmpd_max, int* ptrAm
         inVals[0] = inVals[1] ;
         inVals[1] = inVals[2] ;
 
-        tmp = ftell( ptrFile->ptrFd ) ;
-        if (tmp <= 0) {
-            printf ("\n%s:famps - Can't ftell the wave file\n", argP) ;
-            error = ERR_FILE ;
-            break ;
-        }
+        tmp = ptrFile->cursor ;
 
     } while (position > tmp) ;
     if (error != ERR_OK) return (error) ;
 
-    error = fseek (ptrFile->ptrFd, position, SEEK_SET) ;
-    if (error != ERR_OK) {
-            printf ("\n%s:famps - Can't seek the file: %ld\n", argP, position) ;
-            error = ERR_FILE ;
-    }
+    ptrFile->cursor = position ;
     return (error) ;
 }
 /* The following algorithm improves the 1. classic algorithm for PC-12xx-14xx, not only to     */
-/* weight the fixed levels Trans_High and Trans_Low but also the difference to last amplitude. */
+/* weight the fixed levels ptrFile->trans_high and ptrFile->trans_low but also the difference to last amplitude. */
 /* It builds a transformed "asymmetric amplified" wavy line from the original curve*/
 /* This helps to push most misplaced amplitudes over the High/Low-axis */
 
@@ -1882,17 +1892,17 @@ void AmplifySampleValue (int* ptrInVal, int* ptrAmpd_min, int* ptrAmpd_max, int*
         amplic_base = *ptrAmpd_max ;
     }
     else                        /* other signal, starting */
-        amplic_base = (Trans_High + Trans_Low) /2 ;
+        amplic_base = (ptrFile->trans_high + ptrFile->trans_low) /2 ;
 
     /* The difference between the actual sample value and the last amplitude will amplified */
     /* but not furthermore, when the transmission limit was reached */
 
-    if   (   *ptrLast_ampd < 0 && *ptrInVal > Trans_High) {/* Min, more amplification not needed */
-        if (amplic_base < Trans_High) amplic_limit = Trans_High ; /* correct placed Min */
+    if   (   *ptrLast_ampd < 0 && *ptrInVal > ptrFile->trans_high) {/* Min, more amplification not needed */
+        if (amplic_base < ptrFile->trans_high) amplic_limit = ptrFile->trans_high ; /* correct placed Min */
         else amplic_limit = amplic_base ;                         /* false placed Min */
     }
-    else if (*ptrLast_ampd > 0 && *ptrInVal < Trans_Low) { /* Max, more amplification not needed */
-        if (amplic_base > Trans_Low)  amplic_limit = Trans_Low ; /* correct placed Max */
+    else if (*ptrLast_ampd > 0 && *ptrInVal < ptrFile->trans_low) { /* Max, more amplification not needed */
+        if (amplic_base > ptrFile->trans_low)  amplic_limit = ptrFile->trans_low ; /* correct placed Max */
         else amplic_limit = amplic_base ;                        /* false placed Max */
     }
     else  /* amplify the difference from actual sample value to the last amplitude */
@@ -1905,44 +1915,37 @@ void AmplifySampleValue (int* ptrInVal, int* ptrAmpd_min, int* ptrAmpd_max, int*
 
 int AmplitudesDistanceCheck (int ampd, int* dpos, FileInfo*  ptrFile)
 {
-    static bool amp_dpos_err = false ;
-    static long amp_dpos_errPos = 0 ;
-    long amp_dpos_errLast = amp_dpos_errPos ;
+    long amp_dpos_errLast = ptrFile->amp_dpos_errpos ;
     int error = ERR_OK ;
 
-    if (*dpos == 0) amp_dpos_err = false ;
+    if (*dpos == 0) ptrFile->amp_dpos_err = false ;
     else if (ptrFile->debug != 0 && ptrFile->status == STAT_OK && ptrFile->synching == 0 &&
              !ptrFile->sync_bit && !ptrFile->pause ){
-        if (*dpos > Amp_Dpos_Max ) {
-                if (!amp_dpos_err) {
-                    amp_dpos_err = true ;
-                    amp_dpos_errPos = ftell( ptrFile->ptrFd ) ;
-                    if (amp_dpos_errPos > amp_dpos_errLast ) {
+        if (*dpos > ptrFile->amp_dpos_max ) {
+                if (!ptrFile->amp_dpos_err) {
+                    ptrFile->amp_dpos_err = true ;
+                    ptrFile->amp_dpos_errpos = ptrFile->cursor ;
+                    if (ptrFile->amp_dpos_errpos > amp_dpos_errLast ) {
                         ++ ptrFile->wrn_cnt ;
-                        if (Qcnt == 0 && ptrFile->synching ==0)
+                        if (ptrFile->opt.Qcnt == 0 && ptrFile->synching ==0)
                             printf ("Dropout found at: %.5lf s\n", WavTime(ptrFile) );
                     }
                     error = ERR_DROP ;
                 }
         }
-        else if (*dpos < Amp_Dpos_Min && ampd != 0 ) {
-                if (!amp_dpos_err) {
-                    amp_dpos_err = true ;
-                    amp_dpos_errPos = ftell( ptrFile->ptrFd ) ;
-                    if (amp_dpos_errPos > amp_dpos_errLast ) {
+        else if (*dpos < ptrFile->amp_dpos_min && ampd != 0 ) {
+                if (!ptrFile->amp_dpos_err) {
+                    ptrFile->amp_dpos_err = true ;
+                    ptrFile->amp_dpos_errpos = ptrFile->cursor ;
+                    if (ptrFile->amp_dpos_errpos > amp_dpos_errLast ) {
                         ++ ptrFile->wrn_cnt ;
-                        if (Qcnt == 0 && ptrFile->synching ==0)
+                        if (ptrFile->opt.Qcnt == 0 && ptrFile->synching ==0)
                             printf ("Glitch found at: %.5lf s\n", WavTime(ptrFile) );
                     }
                     error = ERR_GLIT ;
                 }
         }
-        else amp_dpos_err = false ;
-
-        if (amp_dpos_errPos < 0) {
-            printf ("\n%s:ampdchk - Can't ftell the wave file\n", argP) ;
-            error = ERR_FILE ;
-        }
+        else ptrFile->amp_dpos_err = false ;
     }
     return (error);
 }
@@ -2022,14 +2025,10 @@ int ReadBitFromWav (ulong*  ptrTrans,
     *ptrTrans = 0 ;
     *ptrAmps  = 0 ;
 
-    position = ftell( ptrFile->ptrFd ) ;
-    if (position <= 0) {
-            printf ("\n%s:rbit - Can't ftell the wave file\n", argP) ;
-            return ( ERR_FILE ) ;
-    }
+    position = ptrFile->cursor ;
 
-    if ( (ulong) position + ptrFile->bitLen * ptrFile->blockAlign -1 > ptrFile->endSamples ) {
-        if (Qcnt == 0 && ptrFile->synching == 0) printf ("End of audio data reached: %lu, %.5lf s\n",
+    if ( position + (long) ptrFile->bitLen > (long) ptrFile->nbData ) {
+        if (ptrFile->opt.Qcnt == 0 && ptrFile->synching == 0) printf ("End of audio data reached: %lu, %.5lf s\n",
                                ptrFile->endSamples, WavTime(ptrFile) ) ; // Bgn. Text data
         error = ERR_EOF ;
     }
@@ -2039,8 +2038,8 @@ int ReadBitFromWav (ulong*  ptrTrans,
         /*  Modified algorithm will used with amplitude based amplification of sample values */
         if (ptrFile->rate_amp >= 0) {
 
-                if ( ptrFile->ampd_cnt > BIT_0 ) dampd_min = ptrFile->ampd_sum / ptrFile->ampd_cnt / Amp_Diff_Mid ;
-                if ( dampd_min < Amp_Diff_Min )  dampd_min = Amp_Diff_Min ;
+                if ( ptrFile->ampd_cnt > BIT_0 ) dampd_min = ptrFile->ampd_sum / ptrFile->ampd_cnt / ptrFile->amp_diff_mid ;
+                if ( dampd_min < ptrFile->amp_diff_min )  dampd_min = ptrFile->amp_diff_min ;
 
                 /*  Find last Max/Min-amplitude preceding this bit from wave */
                 error = FindAmpsFromWav (inVals, &ampd_min, &ampd_max, &last_ampd, &last_apos, &dampd_min, ptrFile) ;
@@ -2054,21 +2053,16 @@ int ReadBitFromWav (ulong*  ptrTrans,
         }
         else { /* set of first sign for original classic method */
             /* Rewind one sample point */
-            if ( (ulong) position >= ptrFile->bgnSamples + ptrFile->blockAlign ) {
-                    error = fseek (ptrFile->ptrFd, - ptrFile->blockAlign , SEEK_CUR) ;
-                    if (error != ERR_OK) {
-                        printf ("\n%s:rbit - Can't seek the file: %ld\n", argP, position) ;
-                        error = ERR_FILE ;
-                        return (error) ;
-                    }
+            if ( position > 0 ) {
+                    ptrFile->cursor -= 1 ;
                     error = ReadSampleFromWav (&inVal, ptrFile);
                     if (error != ERR_OK) return (error) ;
                 }
                 else inVal = 0xFF   ;   /* sign = original: 1, most common ptrFd will point to the first Max amplitude
                                         of a bit, but data and old Basic often other */
             }
-            if (inVal > Trans_High) sign = 1;
-            else if (inVal < Trans_Low) sign = -1;
+            if (inVal > ptrFile->trans_high) sign = 1;
+            else if (inVal < ptrFile->trans_low) sign = -1;
             else sign = 0;
 
         for ( ii = 0 ; ii < imax ; ++ii ) {
@@ -2081,7 +2075,7 @@ int ReadBitFromWav (ulong*  ptrTrans,
 
                 inVals[2] = inVal ;
                 /* check, if the sample value before was an amplitude */
-                ampd = DetectAmpsFromVals (inVals, &ampd_min, &ampd_max, &last_ampd, &dampd_min) ;
+                ampd = DetectAmpsFromVals (inVals, &ampd_min, &ampd_max, &last_ampd, &dampd_min, ptrFile) ;
 
                 if (ampd != 0 ) {
                     /* This is an additional 2. method to read bits, based on distance between amplitudes */
@@ -2146,7 +2140,7 @@ int ReadBitFromWav (ulong*  ptrTrans,
                 if (ptrFile->rate_amp > 0) AmplifySampleValue ( &inVal, &ampd_min, &ampd_max, &last_ampd, ptrFile) ;
 
             }
-            if ( ( (ptrFile->debug & 0x10000) > 0 ) && (Qcnt == 0) && WavTime(ptrFile) > debug_time ){
+            if ( ( (ptrFile->debug & 0x10000) > 0 ) && (ptrFile->opt.Qcnt == 0) && WavTime(ptrFile) > ptrFile->opt.debug_time ){
                 if (ptrFile->rate_amp > 0) {
 
                     if (ampd > 0 ) printf("^") ;
@@ -2157,7 +2151,7 @@ int ReadBitFromWav (ulong*  ptrTrans,
 
                 }
                 else printf("~%02X", inVal) ;
-                if (((ftell (ptrFile->ptrFd)- (long) ptrFile->bgnSamples)/ ptrFile->blockAlign) % 8 == 0 )
+                if ((ptrFile->cursor) % 8 == 0 )
                     printf("[%.5lf] ", WavTime(ptrFile)) ;
             }
 
@@ -2165,29 +2159,29 @@ int ReadBitFromWav (ulong*  ptrTrans,
                levels */
 
             if (sign > 0) {
-                if (inVal > Trans_High) {
+                if (inVal > ptrFile->trans_high) {
                     continue ;
                 }
-                if (inVal < Trans_Low) {
+                if (inVal < ptrFile->trans_low) {
                     sign = -1;
                     ++ *ptrTrans ;
                 }
             }
             else if (sign < 0) {
-                if (inVal < Trans_Low) {
+                if (inVal < ptrFile->trans_low) {
                     continue ;
                 }
-                if (inVal > Trans_High) {
+                if (inVal > ptrFile->trans_high) {
                     sign = 1;
                     ++ *ptrTrans ;
                 }
             }
             else {
-                if (inVal < Trans_Low) {
+                if (inVal < ptrFile->trans_low) {
                     sign = -1;
                     ++ *ptrTrans ;
                 }
-                if (inVal > Trans_High) {
+                if (inVal > ptrFile->trans_high) {
                     sign = 1;
                     ++ *ptrTrans ;
                 }
@@ -2207,13 +2201,13 @@ int ReadBitFromWav (ulong*  ptrTrans,
         else *ptrAmps  = *ptrTrans ; /* if the alternative method is non-applicable, return classic value */
     } // end if: No end of audio data
 
-    if ( ( (ptrFile->debug & 0x0001) > 0 ) && (Qcnt == 0) ) {
+    if ( ( (ptrFile->debug & 0x0001) > 0 ) && (ptrFile->opt.Qcnt == 0) ) {
         if (*ptrTrans == *ptrAmps) printf(" %lu", *ptrTrans) ;
         else printf(" %lu<%lu>", *ptrTrans, *ptrAmps) ;
     }
 
-    if ( ( (ptrFile->debug & 0x10000) > 0 ) && (Qcnt == 0) ) {
-        printf(" %ld: %3lu,  %.5lf s\n", (ftell (ptrFile->ptrFd)- (long) ptrFile->bgnSamples)/ ptrFile->blockAlign, *ptrTrans ,
+    if ( ( (ptrFile->debug & 0x10000) > 0 ) && (ptrFile->opt.Qcnt == 0) ) {
+        printf(" %ld: %3lu,  %.5lf s\n", ptrFile->cursor, *ptrTrans ,
                    WavTime(ptrFile)) ;
     }
     return (error);
@@ -2237,35 +2231,26 @@ int ReadBitFromEWav (ulong*  ptrAmpL1,
     trans = 0 ;
     *ptrAmpL1 = *ptrAmpL2 = 0 ;
 
-    position = ftell( ptrFile->ptrFd ) ;
-    if (position <= 0) {
-            printf ("\n%s:rbit - Can't ftell the wave file\n", argP) ;
-            return ( ERR_FILE ) ;
-    }
+    position = ptrFile->cursor ;
 
-    if ( (ulong) position + ptrFile->bitLen * ptrFile->blockAlign -1 > ptrFile->endSamples ) {
-        if (Qcnt == 0 && ptrFile->synching == 0) printf ("End of audio data reached: %lu, %.5lf s\n", ptrFile->endSamples, WavTime(ptrFile) ) ; // Bgn. Text data
+    if ( position + (long) ptrFile->bitLen > (long) ptrFile->nbData ) {
+        if (ptrFile->opt.Qcnt == 0 && ptrFile->synching == 0) printf ("End of audio data reached: %lu, %.5lf s\n", ptrFile->endSamples, WavTime(ptrFile) ) ; // Bgn. Text data
         error = ERR_EOF ;
     }
     else {
         error = ERR_OK ;
 
         /* Rewind two sample points */
-            if ( (ulong) position >= ptrFile->bgnSamples + ptrFile->blockAlign ) {
-                    error = fseek (ptrFile->ptrFd, - (long) ( ptrFile->blockAlign * 2 ) , SEEK_CUR) ;
-                    if (error != ERR_OK) {
-                        printf ("\n%s:rbit - Can't seek the file: %ld\n", argP, position) ;
-                        error = ERR_FILE ;
-                        return (error) ;
-                    }
+            if ( position > 0 ) {
+                    ptrFile->cursor -= 2 ;
                     error = ReadSampleFromWav (&inVal, ptrFile);
                     if (error != ERR_OK) return (error) ;
                 }
                 else inVal = TRANS_MID ;
 
             /* set of first sign */
-            if (inVal > Trans_High) sign = 1;
-            else if (inVal < Trans_Low) sign = -1;
+            if (inVal > ptrFile->trans_high) sign = 1;
+            else if (inVal < ptrFile->trans_low) sign = -1;
             else sign = 0;
 
         for ( ii = 0 ; ii < imax ; ++ii ) {
@@ -2273,10 +2258,10 @@ int ReadBitFromEWav (ulong*  ptrAmpL1,
             error = ReadSampleFromWav (&inVal, ptrFile);
             if (error != ERR_OK) break ;
 
-            if ( ( (ptrFile->debug & 0x10000) > 0 ) && (Qcnt == 0) && WavTime(ptrFile) > debug_time ){
+            if ( ( (ptrFile->debug & 0x10000) > 0 ) && (ptrFile->opt.Qcnt == 0) && WavTime(ptrFile) > ptrFile->opt.debug_time ){
 
                 printf("~%02X", inVal) ;
-                if (((ftell (ptrFile->ptrFd)- (long) ptrFile->bgnSamples)/ ptrFile->blockAlign) % 8 == 0 )
+                if ((ptrFile->cursor) % 8 == 0 )
                     printf("[%.5lf] ", WavTime(ptrFile)) ;
             }
             isTrans = false ;
@@ -2284,32 +2269,32 @@ int ReadBitFromEWav (ulong*  ptrAmpL1,
                levels */
 
             if (sign > 0) {
-                if (inVal > Trans_High) {
+                if (inVal > ptrFile->trans_high) {
                     continue ;
                 }
-                if (inVal < Trans_Low) {
+                if (inVal < ptrFile->trans_low) {
                     sign = -1;
                     isTrans = true ;
                     ++ trans ;
                 }
             }
             else if (sign < 0) {
-                if (inVal < Trans_Low) {
+                if (inVal < ptrFile->trans_low) {
                     continue ;
                 }
-                if (inVal > Trans_High) {
+                if (inVal > ptrFile->trans_high) {
                     sign = 1;
                     isTrans = true ;
                     ++ trans ;
                 }
             }
             else {
-                if (inVal < Trans_Low) {
+                if (inVal < ptrFile->trans_low) {
                     sign = -1;
                     isTrans = true ;
                     ++ trans ;
                 }
-                if (inVal > Trans_High) {
+                if (inVal > ptrFile->trans_high) {
                     sign = 1;
                     isTrans = true ;
                     ++ trans ;
@@ -2331,12 +2316,12 @@ int ReadBitFromEWav (ulong*  ptrAmpL1,
 
     } // end if: No end of audio data
 
-    if ( ( (ptrFile->debug & 0x0001) > 0 ) && (Qcnt == 0) ) {
+    if ( ( (ptrFile->debug & 0x0001) > 0 ) && (ptrFile->opt.Qcnt == 0) ) {
         printf(" %lu/%lu", *ptrAmpL1, *ptrAmpL2) ;
     }
 
-    if ( ( (ptrFile->debug & 0x10000) > 0 ) && (Qcnt == 0) ) {
-        printf(" %ld: %3lu/%3lu,  %.5lf s\n", (ftell (ptrFile->ptrFd)- (long) ptrFile->bgnSamples)/ ptrFile->blockAlign,
+    if ( ( (ptrFile->debug & 0x10000) > 0 ) && (ptrFile->opt.Qcnt == 0) ) {
+        printf(" %ld: %3lu/%3lu,  %.5lf s\n", ptrFile->cursor,
                *ptrAmpL1, *ptrAmpL2, WavTime(ptrFile)) ;
     }
     return (error);
@@ -2353,7 +2338,7 @@ int SyncStartBitFromEWav (FileInfo*  ptrFile)
 
     ptrFile->sync_bit = true ;
 
-    if ( ( (ptrFile->debug & 0x10001) > 0 ) && (Qcnt == 0) ) {
+    if ( ( (ptrFile->debug & 0x10001) > 0 ) && (ptrFile->opt.Qcnt == 0) ) {
             printf(" *s(");
             if ( (ptrFile->debug & 0x10000) > 0 ) printf("\n");
     }
@@ -2364,21 +2349,13 @@ int SyncStartBitFromEWav (FileInfo*  ptrFile)
         if ( jj > 0) tmp = ptrFile->bitLen1 << 1 ;
         else         tmp = ptrFile->bitLen  ;
 
-        error = fseek (ptrFile->ptrFd, -tmp * (long) ptrFile->blockAlign, SEEK_CUR) ;
-        if (error != ERR_OK) {
-            printf ("\n%s:syncE - Can't seek the file\n", argP) ;
-            return ( ERR_FILE ) ;
-        }
+        ptrFile->cursor -= tmp ;
 
         ii = -1 ;
         /* adjust the position in the wave file to left between last sync and the start bit */
         do {
             ++ii ;
-            position = ftell( ptrFile->ptrFd ) ;
-            if (position <= 0) {
-                printf ("\n%s:syncE - Can't ftell the wave file\n", argP) ;
-                return ( ERR_FILE ) ;
-            }
+            position = ptrFile->cursor ;
 
             error = ReadBitFromEWav ( &ampL1, &ampL2, ptrFile);
             if (error != ERR_OK) break ;
@@ -2394,14 +2371,10 @@ int SyncStartBitFromEWav (FileInfo*  ptrFile)
         error = ERR_SYNC ;
     else {
         /* Rewind to the begin of the StartBit */
-        error = fseek (ptrFile->ptrFd, position, SEEK_SET) ; /*rewind to start position */
-        if (error != ERR_OK) {
-            printf ("\n%s:syncE - Can't seek the file: %ld\n", argP, position) ;
-            error = ERR_FILE ;
-        }
+        ptrFile->cursor = position ; /*rewind to start position */
 
     }
-    if ( ( (ptrFile->debug & 0x10001) > 0 ) && (Qcnt == 0) ) {
+    if ( ( (ptrFile->debug & 0x10001) > 0 ) && (ptrFile->opt.Qcnt == 0) ) {
             printf(")s ");
             if ( (ptrFile->debug & 0x10000) > 0 ) printf("\n");
     }
@@ -2428,26 +2401,18 @@ int SyncBitFromWav (int  sign,          /* sync 1 to high bit or -1 to low or 0
 
     ptrFile->sync_bit = true ;
 
-    if ( ( (ptrFile->debug & 0x10001) > 0 ) && (Qcnt == 0) ) {
+    if ( ( (ptrFile->debug & 0x10001) > 0 ) && (ptrFile->opt.Qcnt == 0) ) {
             if (sign > 0 ) printf(" +s("); else if (sign < 0 ) printf(" -s("); else printf(" *s(");
             if ( (ptrFile->debug & 0x10000) > 0 ) printf("\n");
     }
-    if ( ( (ptrFile->debug & 0x0002) > 0 ) && (Qcnt == 0) && (sign != 0 ) )
+    if ( ( (ptrFile->debug & 0x0002) > 0 ) && (ptrFile->opt.Qcnt == 0) && (sign != 0 ) )
         printf(" %lu -> ", *ptrTrans);
 
-    position = ftell( ptrFile->ptrFd ) ;
-    if (position <= 0) {
-            printf ("\n%s:sync - Can't ftell the wave file\n", argP) ;
-            return ( ERR_FILE ) ;
-    }
+    position = ptrFile->cursor ;
     if ( sign == 0) {
             /* Sync StartBit to Bit_mid,  Rewind a half bit */
             tmp = ptrFile->bitLen/2  ;
-            error = fseek (ptrFile->ptrFd, tmp * (long) ptrFile->blockAlign, SEEK_CUR) ;
-            if (error != ERR_OK) {
-                printf ("\n%s:sync - Can't seek the file\n", argP) ;
-                return ( ERR_FILE ) ;
-            }
+            ptrFile->cursor += tmp ;
     }
 
     /* first search for BIT_1 or BIT_0 exactly, if not successful then accept one or two transition less */
@@ -2462,12 +2427,7 @@ int SyncBitFromWav (int  sign,          /* sync 1 to high bit or -1 to low or 0
                 tmp = - ptrFile->bitLen - ii ;
 
             /* check for that not coming outside bgnSamples and endSamples is done one higher level */
-            error = fseek (ptrFile->ptrFd, tmp * (long) ptrFile->blockAlign, SEEK_CUR) ;
-            if (error != ERR_OK) {
-                printf ("\n%s:sync - Can't seek the file\n", argP) ;
-                error = ERR_FILE ;
-                break ;
-            }
+            ptrFile->cursor += tmp ;
             error = ReadBitFromWav (ptrTrans, ptrAmps, ptrFile);
             if (error != ERR_OK) break ;
 
@@ -2515,26 +2475,21 @@ int SyncBitFromWav (int  sign,          /* sync 1 to high bit or -1 to low or 0
            ) {
             /* no sync found */
             *ptrLimit = 0 ;
-            error = fseek (ptrFile->ptrFd, position, SEEK_SET) ; /*rewind to start position */
-            if (error != ERR_OK) {
-                printf ("\n%s:sync - Can't seek the file: %ld\n", argP, position) ;
-                error = ERR_FILE ;
-                break ;
-            }
+            ptrFile->cursor = position ; /*rewind to start position */
             ++jj ;
         }
         else {
             *ptrLimit = ii ; /* steps left + right needed for syncing */
             if (jj > 1 && ptrFile->synching == 0 && sign != 0 ) {
                 if ( *ptrTrans > BIT_0 + 2 && *ptrTrans < BIT_1 - 2 ) {
-                    if (Qcnt == 0)
+                    if (ptrFile->opt.Qcnt == 0)
                         printf ("Signal synchronisation error: %lu transitions before %.5lf s\n", *ptrTrans, WavTime(ptrFile));
                     error = count_errors( ERR_SYNC, ptrFile );
                     if (error != ERR_OK) break ;
                 }
                 else if (*ptrTrans > BIT_0 + 1 && *ptrTrans < BIT_1 - 1 ){
                     ++ ptrFile->wrn_cnt ;
-                    if (Qcnt == 0) {
+                    if (ptrFile->opt.Qcnt == 0) {
                         if ((ptrFile->debug & (0x400 | 0x800) ) != 0)
                             printf ("Poorly synchronised signal: %lu trans. before %.5lf s\n", *ptrTrans, WavTime(ptrFile));
                         else if ((ptrFile->debug & 0x40 ) != 0) printf ("!");
@@ -2550,18 +2505,14 @@ int SyncBitFromWav (int  sign,          /* sync 1 to high bit or -1 to low or 0
             /* Rewind to the begin of the StartBit */
             tmp = -( ptrFile->bitLen /2 ) ;
             /* adjust the position in the wave file to left between last sync and the start bit */
-            error = fseek (ptrFile->ptrFd, tmp * (long) ptrFile->blockAlign, SEEK_CUR) ;
-            if (error != ERR_OK) {
-                printf ("\n%s:sync - Can't seek the file\n", argP) ;
-                return ( ERR_FILE ) ;
-            }
+            ptrFile->cursor += tmp ;
     }
 
-    if ( ( (ptrFile->debug & 0x0002) > 0 ) && (Qcnt == 0) ) {
+    if ( ( (ptrFile->debug & 0x0002) > 0 ) && (ptrFile->opt.Qcnt == 0) ) {
             printf("%lu samples -> ", tmp + ptrFile->bitLen);
             printf("%lu\n", *ptrTrans);
     }
-    if ( ( (ptrFile->debug & 0x10001) > 0 ) && (Qcnt == 0) ) {
+    if ( ( (ptrFile->debug & 0x10001) > 0 ) && (ptrFile->opt.Qcnt == 0) ) {
             printf(")s ");
             if ( (ptrFile->debug & 0x10000) > 0 ) printf("\n");
     }
@@ -2580,7 +2531,7 @@ int ReadBitFieldFromEWav (ulong  nbBits,
     ulong  ampL1, ampL2, bitLen ;
       int  error ;
 
-    if ( ( (ptrFile->debug & 0x0004) > 0 ) && (Qcnt == 0)  && (ptrFile->synching == 0) )
+    if ( ( (ptrFile->debug & 0x0004) > 0 ) && (ptrFile->opt.Qcnt == 0)  && (ptrFile->synching == 0) )
         printf (" Bits") ;
 
     for ( ii = 0 ; ii < nbBits ; ++ii ) {
@@ -2600,11 +2551,11 @@ int ReadBitFieldFromEWav (ulong  nbBits,
         else
             ptrBits[ii] = 1;     /* Bit a 1 */
 
-        if ( ( (ptrFile->debug & 0x0004) > 0 ) && (Qcnt == 0) )
+        if ( ( (ptrFile->debug & 0x0004) > 0 ) && (ptrFile->opt.Qcnt == 0) )
             printf (" %d", ptrBits[ii]) ;
     } // next ii
 
-    if ( ( (ptrFile->debug & 0x0004) > 0 ) && (Qcnt == 0)  && (ptrFile->synching == 0) )
+    if ( ( (ptrFile->debug & 0x0004) > 0 ) && (ptrFile->opt.Qcnt == 0)  && (ptrFile->synching == 0) )
         printf ("\n") ;
 
     return (error);
@@ -2626,11 +2577,11 @@ int ReadBitFieldFromWav (ulong  nbBits,
      bool  isPc15, isPc121, isStart, isStop, isSkip ;
       int  error ;
 
-    if ( ( (ptrFile->debug & 0x0004) > 0 ) && (Qcnt == 0)  && (ptrFile->synching == 0) )
+    if ( ( (ptrFile->debug & 0x0004) > 0 ) && (ptrFile->opt.Qcnt == 0)  && (ptrFile->synching == 0) )
         printf (" Bits") ;
 
-    isPc15  = ptrFile->base_freq == Base_FREQ2 || pcgrpId == IDENT_PC1500 ;
-    isPc121 = ptrFile->base_freq == Base_FREQ1 && pcgrpId == IDENT_PC1211 ; /* last skip bit not with bit length, sync start bit */
+    isPc15  = ptrFile->base_freq == ptrFile->base_freq2 || ptrFile->pcgrp_id == IDENT_PC1500 ;
+    isPc121 = ptrFile->base_freq == ptrFile->base_freq1 && ptrFile->pcgrp_id == IDENT_PC1211 ; /* last skip bit not with bit length, sync start bit */
     isSkip  = (nbBits == 1 ) ;
     isStart = (nbBits == 6 ) ; /* in case of some transmission errors ReadQuater does not read the start bit */
     if ( isStart && ptrFile->skip_bits > 0 ) {
@@ -2648,11 +2599,7 @@ int ReadBitFieldFromWav (ulong  nbBits,
         error = ReadBitFromWav (&trans, &amps, ptrFile);
         if (error != ERR_OK) break ;
 
-        position = ftell( ptrFile->ptrFd ) ;
-        if (position <= 0) {
-            printf ("\n%s:rbits - Can't ftell the wave file\n", argP) ;
-            return ( ERR_FILE ) ;
-        }
+        position = ptrFile->cursor ;
 
         /* weight values from different calculation methods */
         // New controlled by ReadBitParameterAdj
@@ -2686,16 +2633,12 @@ int ReadBitFieldFromWav (ulong  nbBits,
                 if (error != ERR_OK) break ;
 
                 if (limit == 0) {
-                    printf ("\n%s: ERROR: Synchro %lu Hz bit1 lost at %.5lf s after %lu transitions/b\n", argP, ptrFile->freq, WavTime(ptrFile), trans) ;
+                    printf ("\n%s: ERROR: Synchro %lu Hz bit1 lost at %.5lf s after %lu transitions/b\n", ptrFile->opt.argP, ptrFile->freq, WavTime(ptrFile), trans) ;
                     // error = ERR_NSYNC ;
                     // break ;
                     trans = atrans ;
                     error = count_errors( ERR_NSYNC, ptrFile );
-                    error = fseek (ptrFile->ptrFd, position, SEEK_SET) ; /*rewind to last position */
-                    if (error != ERR_OK) {
-                        printf ("\n%s:rbits - Can't seek the file: %ld\n", argP, position) ;
-                        error = ERR_FILE ;
-                    }
+                    ptrFile->cursor = position ; /*rewind to last position */
                 }
                 else if ( jj  > 0 ) {
                     printf ("Synchro Stopbit1, %i bits lost before %.5lf s\n", jj , WavTime(ptrFile)) ;
@@ -2725,16 +2668,12 @@ int ReadBitFieldFromWav (ulong  nbBits,
 
                 if (limit == 0) {
                     printf ("\n%s: ERROR: Synchro %lu Hz bit0 lost at %.5lf s after %lu transitions/b\n",
-                            argP, ptrFile->freq, WavTime(ptrFile), trans) ;
+                            ptrFile->opt.argP, ptrFile->freq, WavTime(ptrFile), trans) ;
                     // error = ERR_NSYNC ;
                     // break ;
                     trans = atrans ;
                     error = count_errors( ERR_NSYNC, ptrFile );
-                    error = fseek (ptrFile->ptrFd, position, SEEK_SET) ; /*rewind to last position */
-                    if (error != ERR_OK) {
-                        printf ("\n%s:rbits - Can't seek the file: %ld\n", argP, position) ;
-                        error = ERR_FILE ;
-                    }
+                    ptrFile->cursor = position ; /*rewind to last position */
                 }
                 else if ( jj  > 0 ) {
                     printf ("Synchro Startbit0, %i bits lost before %.5lf s\n", jj , WavTime(ptrFile)) ;
@@ -2749,19 +2688,14 @@ int ReadBitFieldFromWav (ulong  nbBits,
                     error = ReadBitFromWav (&trans, &amps, ptrFile);    /* read bit after the assumed gap */
                         if (error != ERR_OK) break ;
 
-                    error = fseek (ptrFile->ptrFd, position, SEEK_SET) ; /*rewind to last position */
-                    if (error != ERR_OK) {
-                        printf ("\n%s:rbits - Can't seek the file: %ld\n", argP, position) ;
-                        error = ERR_FILE ;
-                        break ;
-                    }
+                    ptrFile->cursor = position ; /*rewind to last position */
                 }   /* try again after one bit length, to test if it's only a one bit gap or more */
                     if ( trans < BIT_0 - 2 && amps < BIT_0 - 2) { /* if the bit after also low trans */
-                        if (Qcnt == 0 ) {
+                        if (ptrFile->opt.Qcnt == 0 ) {
                             if (ptrFile->debug >0)
                                 printf ("\n%s: Synchronisation %lu Hz ended at %.5lf s after %lu transitions/bit\n",
-                                argP, ptrFile->freq, WavTime(ptrFile), trans) ;
-                            else printf ("\n%s: Synchronous transmission ended at wave time %.5lf sec\n", argP, WavTime(ptrFile)) ;
+                                ptrFile->opt.argP, ptrFile->freq, WavTime(ptrFile), trans) ;
+                            else printf ("\n%s: Synchronous transmission ended at wave time %.5lf sec\n", ptrFile->opt.argP, WavTime(ptrFile)) ;
                         }
                         error = ERR_NSYNC ;
                         break ;
@@ -2783,10 +2717,10 @@ int ReadBitFieldFromWav (ulong  nbBits,
         else
             ptrBits[ii] = 0;     /* Bit a 0 */
 
-        if ( ( (ptrFile->debug & 0x0004) > 0 ) && (Qcnt == 0) )
+        if ( ( (ptrFile->debug & 0x0004) > 0 ) && (ptrFile->opt.Qcnt == 0) )
             printf (" %d", ptrBits[ii]) ;
     } // next ii
-    if ( ( (ptrFile->debug & 0x0004) > 0 ) && (Qcnt == 0)  && (ptrFile->synching == 0) )
+    if ( ( (ptrFile->debug & 0x0004) > 0 ) && (ptrFile->opt.Qcnt == 0)  && (ptrFile->synching == 0) )
         printf ("\n") ;
 
     return (error);
@@ -2803,19 +2737,15 @@ int SkipBitsFromWav (ulong*  ptrNb,
      long  position ;
       int  error ;
 
-    position = ftell( ptrFile->ptrFd );
-    if (position <= 0) {
-            printf ("\n%s:skip - Can't ftell the wave file\n", argP) ;
-            return ( ERR_FILE ) ;
-    }
+    position = ptrFile->cursor ;
 
-    if ( ( (ptrFile->debug & 0x10001) > 0 ) && (Qcnt == 0) ) {
+    if ( ( (ptrFile->debug & 0x10001) > 0 ) && (ptrFile->opt.Qcnt == 0) ) {
             printf("...");
             if ( (ptrFile->debug & 0x10000) > 0 ) printf("\n");
     }
 
     do {
-        max_ii = ptrFile->synching ? SYNC_BIT_MAX : Stop_Bit_Max ;
+        max_ii = ptrFile->synching ? SYNC_BIT_MAX : ptrFile->stop_bit_max ;
         *ptrNb = 0 ;
         ii = 0 ;
         do {                        // Skip sync bits or stop bits
@@ -2829,12 +2759,7 @@ int SkipBitsFromWav (ulong*  ptrNb,
 
         if ( bit > 0 ) {
             /* max_ii read, new long synch required */
-            error = fseek (ptrFile->ptrFd, position, SEEK_SET) ;
-            if (error != ERR_OK) {
-                printf ("\n%s:skip - Can't seek the file: %ld\n", argP, position) ;
-                error = ERR_FILE ;
-                break ;
-            }
+            ptrFile->cursor = position ;
             /* Restart moved to a higher level, no recursion */
             /* return FindFreqAndSyncFromWav( ptrFile ); */
             *ptrNb = ii ;
@@ -2842,16 +2767,11 @@ int SkipBitsFromWav (ulong*  ptrNb,
         }
         /* else  Rewind before the beginning of a start bit or where sync was lost */
         --ii ;
-        error = fseek (ptrFile->ptrFd, - (long) (ptrFile->bitLen * ptrFile->blockAlign), SEEK_CUR) ;
-        if (error != ERR_OK) {
-            printf ("\n%s:skip - Can't seek the file: %ld\n", argP, position) ;
-            error = ERR_FILE ;
-            break ;
-        }
+        ptrFile->cursor -= ptrFile->bitLen ;
 
         ptrFile->skip_bits = ii ;
         *ptrNb = ii ;
-        if ( ( (ii > 0) && ((ptrFile->debug & 0x0008) > 0 ) ) && (Qcnt == 0) )
+        if ( ( (ii > 0) && ((ptrFile->debug & 0x0008) > 0 ) ) && (ptrFile->opt.Qcnt == 0) )
             printf (" Skip %d\n", ii) ;
 
      /*  An accurate determination of the rate and frequency of the recording would be realizable here
@@ -2871,10 +2791,10 @@ ulong bitLen ;
     bitLen = (( ptrFile->wav_freq * WAV_NB_BIT1 * 2) / ptrFile->freq + 1)/2 ; // with rounding
 
     /* Calculate the minimum number of samples between to amps, time filter  */
-    Amp_Dpos_Bas = ( ptrFile->wav_freq / ptrFile->freq + 1)/2 ; // with rounding
-    Amp_Dpos_Max = ( ptrFile->wav_freq * AMP_DPOS_MAXB / ptrFile->freq + 1)/2 ; // more than Bit_0
-    Amp_Dpos_Min = ( ptrFile->wav_freq / ptrFile->freq + 1)/4 ;// half of Bit_1
-    if (Amp_Dpos_Min > 1) --Amp_Dpos_Min ;
+    ptrFile->amp_dpos_bas = ( ptrFile->wav_freq / ptrFile->freq + 1)/2 ; // with rounding
+    ptrFile->amp_dpos_max = ( ptrFile->wav_freq * AMP_DPOS_MAXB / ptrFile->freq + 1)/2 ; // more than Bit_0
+    ptrFile->amp_dpos_min = ( ptrFile->wav_freq / ptrFile->freq + 1)/4 ;// half of Bit_1
+    if (ptrFile->amp_dpos_min > 1) --ptrFile->amp_dpos_min ;
 
     return ( bitLen ) ;
 }
@@ -2896,36 +2816,32 @@ int FindSyncFromWav (ulong*  ptrNb,
     do {
         *ptrNb = 0  ;
         Tol = 1 ;
-        if (devId == DEV_EMU) Tol += 2; /* Emulator needs more speed tolerance */
+        if (ptrFile->opt.devId == DEV_EMU) Tol += 2; /* Emulator needs more speed tolerance */
 
         /* Calculate the number of WAV samples for one bit of the pocket file */
         ptrFile->bitLen = BitLen (ptrFile) ;
 
-        position = ftell( ptrFile->ptrFd ) ;
-        if (position <= 0) {
-            printf ("\n%s:fsync - Can't ftell the wave file\n", argP) ;
-            return ( ERR_FILE ) ;
-        }
-        if ( (ulong) position + ptrFile->bitLen * ptrFile->blockAlign -1 > ptrFile->endSamples ) {
-            if (Qcnt == 0 || ptrFile->debug != 0) printf ("%s:Found no (new) Sync - End of audio data reached\n", argP) ;
+        position = ptrFile->cursor ;
+        if ( position + (long) ptrFile->bitLen > (long) ptrFile->nbData ) {
+            if (ptrFile->opt.Qcnt == 0 || ptrFile->debug != 0) printf ("%s:Found no (new) Sync - End of audio data reached\n", ptrFile->opt.argP) ;
             return ( ERR_EOF ) ;
         }
 
-        if ( ( (ptrFile->debug & 0x0100) > 0 ) && (Qcnt == 0) ) printf ("Searching frequency %lu, transitions: ", ptrFile->freq ) ;
-        else if (ptrFile->debug != 0 && Qcnt == 0 ) printf ("\nTrying to synchronise %lu Hz ", ptrFile->freq);
+        if ( ( (ptrFile->debug & 0x0100) > 0 ) && (ptrFile->opt.Qcnt == 0) ) printf ("Searching frequency %lu, transitions: ", ptrFile->freq ) ;
+        else if (ptrFile->debug != 0 && ptrFile->opt.Qcnt == 0 ) printf ("\nTrying to synchronise %lu Hz ", ptrFile->freq);
         ii = 0; /* how often tried to sync */
         do {
             cntBit_1 = 0 ;
             do { /* frequency and bitLen calculation */
                 ++ii ;
                 bitLen_before = ptrFile->bitLen ;
-                MinPosSync = ptrFile->bgnSamples + (bitLen_before + 1) * ptrFile->blockAlign * 3/2 ; // SyncBit can shift +-1/2 bitLen
+                MinPosSync = (bitLen_before + 1) * 3/2 ; // SyncBit can shift +-1/2 bitLen
 
                 do { /* Skip low freq and silence before the lead in */
                     error = ReadBitFromWav (&trans, &amps, ptrFile);
                     if (error != ERR_OK) break ;
 
-                    if ( ( (ptrFile->debug & 0x0100) > 0 ) && (Qcnt == 0) )
+                    if ( ( (ptrFile->debug & 0x0100) > 0 ) && (ptrFile->opt.Qcnt == 0) )
                         printf ("-%lu", trans) ;
 
                 } while (trans < ( BIT_MID ) ) ; // ( old version: BIT_MID / 2)
@@ -2933,23 +2849,19 @@ int FindSyncFromWav (ulong*  ptrNb,
 
                 /* Try to sync one bit or read next */
                 if (trans < BIT_1) {
-                    position = ftell( ptrFile->ptrFd ) ;
-                    if (position <= 0) {
-                        printf ("\n%s:fsync - Can't ftell the wave file\n", argP) ;
-                        return ( ERR_FILE ) ;
-                    }
+                    position = ptrFile->cursor ;
                     if (position >= MinPosSync) { /* not at begin of file */
                         limit = bitLen_before ;
                         error = SyncBitFromWav (1, &trans, &amps, &limit, ptrFile);
                         if (error != ERR_OK) break ;
-                        if ( ( (ptrFile->debug & 0x0100) > 0 ) && (Qcnt == 0) )
+                        if ( ( (ptrFile->debug & 0x0100) > 0 ) && (ptrFile->opt.Qcnt == 0) )
                             printf ("~%lu", trans) ;
                    }
                     else limit = 0 ;
                     if (limit == 0 ) { /* no sync found to BIT_1 */
                         error = ReadBitFromWav (&trans, &amps, ptrFile); /* try next */
                         if (error != ERR_OK) break ;
-                        if ( ( (ptrFile->debug & 0x0100) > 0 ) && (Qcnt == 0) )
+                        if ( ( (ptrFile->debug & 0x0100) > 0 ) && (ptrFile->opt.Qcnt == 0) )
                             printf (".%lu", trans) ;
                         break ;
                     }
@@ -2965,7 +2877,7 @@ int FindSyncFromWav (ulong*  ptrNb,
                     error = ReadBitFromWav (&trans, &amps, ptrFile);
                     if (error != ERR_OK) break ;
 
-                    if ( ( (ptrFile->debug & 0x0100) > 0 ) && (Qcnt == 0) )
+                    if ( ( (ptrFile->debug & 0x0100) > 0 ) && (ptrFile->opt.Qcnt == 0) )
                         printf ("+%lu", trans) ;
 
                         /* mean value can used for speed correction of ptrFile->bitLen */
@@ -2997,7 +2909,7 @@ int FindSyncFromWav (ulong*  ptrNb,
                       cntBit_1 < ptrFile->synching * SYNC_FRAC_1 ) ; /* part of accepted BIT_1 from all bits of block */
 
             if (error != ERR_OK) break ;
-            if (Qcnt == 0 && ptrFile->debug != 0) printf ("."); /* block accepted */
+            if (ptrFile->opt.Qcnt == 0 && ptrFile->debug != 0) printf ("."); /* block accepted */
 
         } while ((( trans != BIT_1  && trans != BIT_1 + 1 ) /* last bit was 1x High Bit found */
                  || cntBit_1 < ptrFile->synching * SYNC_FRAC_1 )
@@ -3025,22 +2937,22 @@ void ReadBitParamAdjust (FileInfo*  ptrFile)
 {
 ulong trans_diff2 ;
 
-    if ( pcgrpId == IDENT_PC1211 ) {
+    if ( ptrFile->pcgrp_id == IDENT_PC1211 ) {
         if (ptrFile->rate_amp != RATE_AMP_OFF ) {
             if  ( (ptrFile->debug & NO_RATE_AMP) == 0 ) {
-                if (devId == DEV_CAS)
-                        Rate_Amp_Def = RATE_AMP_12_MAX ;
+                if (ptrFile->opt.devId == DEV_CAS)
+                        ptrFile->rate_amp_def = RATE_AMP_12_MAX ;
                 else if (ptrFile->ampd_cnt > BIT_0 ) {
                     if ( ptrFile->ampd_sum / ptrFile->ampd_cnt > RATE_AMP_12_ABV )
-                        Rate_Amp_Def = RATE_AMP_12_MAX ;
+                        ptrFile->rate_amp_def = RATE_AMP_12_MAX ;
                     else
-                        Rate_Amp_Def = RATE_AMP_12 ;
+                        ptrFile->rate_amp_def = RATE_AMP_12 ;
                 }
                 else
-                    Rate_Amp_Def = RATE_AMP_12 ;
+                    ptrFile->rate_amp_def = RATE_AMP_12 ;
             }
-            else    Rate_Amp_Def = 0 ;
-            ptrFile->rate_amp = Rate_Amp_Def ;
+            else    ptrFile->rate_amp_def = 0 ;
+            ptrFile->rate_amp = ptrFile->rate_amp_def ;
             ptrFile->amp_weight = AMP_WEIGHT_LOW ;
         }
         if ( ptrFile->ampd_cnt > BIT_0 && (ptrFile->debug & TRANS_OLD) == 0 ) {
@@ -3049,27 +2961,27 @@ ulong trans_diff2 ;
                 if (ptrFile->bytesPerP == 1 && trans_diff2 < (uint) ptrFile->pre_amp)
                     trans_diff2 = (uint) ptrFile->pre_amp ;  /* 8 bit */
 
-                Trans_High = Trans_High_def = TRANS_MID + trans_diff2 ;
-                Trans_Low  = Trans_Low_def  = TRANS_MID - trans_diff2 ;
+                ptrFile->trans_high = ptrFile->trans_high_def = TRANS_MID + trans_diff2 ;
+                ptrFile->trans_low  = ptrFile->trans_low_def  = TRANS_MID - trans_diff2 ;
         }
-        Amp_Diff_Mid = AMP_DIFF_MID_121 ;
+        ptrFile->amp_diff_mid = AMP_DIFF_MID_121 ;
     }  // End if IDENT_PC1211
 
-    else if ( pcgrpId == IDENT_PC1500 ) {
+    else if ( ptrFile->pcgrp_id == IDENT_PC1500 ) {
 
         if ( ptrFile->rate_amp != RATE_AMP_OFF) {
             if  ( (ptrFile->debug & NO_RATE_AMP) == 0 ) {
                 if ( ptrFile->ampd_cnt > BIT_0 ) {
                     if ( ptrFile->ampd_sum / ptrFile->ampd_cnt > RATE_AMP_15_ABV )
-                        Rate_Amp_Def = RATE_AMP_15_MAX ;
+                        ptrFile->rate_amp_def = RATE_AMP_15_MAX ;
                     else
-                        Rate_Amp_Def = RATE_AMP_15 ;
+                        ptrFile->rate_amp_def = RATE_AMP_15 ;
                 }
                 else
-                    Rate_Amp_Def = RATE_AMP_15 ;
+                    ptrFile->rate_amp_def = RATE_AMP_15 ;
             }
-            else    Rate_Amp_Def = 0 ;
-            ptrFile->rate_amp = Rate_Amp_Def ;
+            else    ptrFile->rate_amp_def = 0 ;
+            ptrFile->rate_amp = ptrFile->rate_amp_def ;
         }
 
         if ( ptrFile->ampd_cnt > BIT_0 && (ptrFile->debug & TRANS_OLD) == 0 ) {
@@ -3080,38 +2992,38 @@ ulong trans_diff2 ;
             if (ptrFile->bytesPerP == 1 && trans_diff2 < (uint) ptrFile->pre_amp)
                 trans_diff2 = (uint) ptrFile->pre_amp ;  /* 8 bit */
 
-            Trans_High = Trans_High_15 = TRANS_MID + trans_diff2 ;
-            Trans_Low  = Trans_Low_15  = TRANS_MID - trans_diff2 ;
+            ptrFile->trans_high = ptrFile->trans_high_15 = TRANS_MID + trans_diff2 ;
+            ptrFile->trans_low  = ptrFile->trans_low_15  = TRANS_MID - trans_diff2 ;
 
             if ( trans_diff2 < 4) trans_diff2 = 4 ;
-            Amp_Max_Above = TRANS_MID + trans_diff2 ;
-            Amp_Min_Below = TRANS_MID - trans_diff2 ;
+            ptrFile->amp_max_above = TRANS_MID + trans_diff2 ;
+            ptrFile->amp_min_below = TRANS_MID - trans_diff2 ;
 
         }
-        if (devId == DEV_CAS) Amp_Diff_Mid = AMP_DIFF_CAS_15 ;
-        else Amp_Diff_Mid = AMP_DIFF_MID_15 ;
+        if (ptrFile->opt.devId == DEV_CAS) ptrFile->amp_diff_mid = AMP_DIFF_CAS_15 ;
+        else ptrFile->amp_diff_mid = AMP_DIFF_MID_15 ;
     }  // End if IDENT_PC1500
 
-    else if (ptrFile->base_freq == Base_FREQ1 && Base_FREQ1 > 0) { /* PC-1245-1475 */
+    else if (ptrFile->base_freq == ptrFile->base_freq1 && ptrFile->base_freq1 > 0) { /* PC-1245-1475 */
         if (ptrFile->rate_amp != RATE_AMP_OFF ) {
             if  ( (ptrFile->debug & NO_RATE_AMP) == 0 ) {
-                if (devId == DEV_CAS)
-                    Rate_Amp_Def = RATE_AMP_4_CAS ;
+                if (ptrFile->opt.devId == DEV_CAS)
+                    ptrFile->rate_amp_def = RATE_AMP_4_CAS ;
                 else
-                    Rate_Amp_Def = RATE_AMP_4 ;
+                    ptrFile->rate_amp_def = RATE_AMP_4 ;
                 if ( ptrFile->ampd_cnt > BIT_0 ) {
                     if ( ptrFile->ampd_sum / ptrFile->ampd_cnt < RATE_AMP_4_BLW )
-                        Rate_Amp_Def = RATE_AMP_4_MIN ;
+                        ptrFile->rate_amp_def = RATE_AMP_4_MIN ;
                 }
-                if (devId == DEV_AIR)
-                    Rate_Amp_Def = RATE_AMP_4_AIR ;
+                if (ptrFile->opt.devId == DEV_AIR)
+                    ptrFile->rate_amp_def = RATE_AMP_4_AIR ;
             }
-            else    Rate_Amp_Def = 0 ;
-            ptrFile->rate_amp = Rate_Amp_Def ;
+            else    ptrFile->rate_amp_def = 0 ;
+            ptrFile->rate_amp = ptrFile->rate_amp_def ;
         }
-        if (devId == DEV_AIR) { /* wave was recorded with microphone from buzzer */
-            Amp_Diff_Mid = AMP_DIFF_MID/2 ;
-            Amp_Diff_Rel = AMP_DIFF_REL/2 ;
+        if (ptrFile->opt.devId == DEV_AIR) { /* wave was recorded with microphone from buzzer */
+            ptrFile->amp_diff_mid = AMP_DIFF_MID/2 ;
+            ptrFile->amp_diff_rel = AMP_DIFF_REL/2 ;
 
             if ( (ptrFile->debug & TRANS_OLD) == 0 ) {
                 if ( ptrFile->ampd_cnt > BIT_0 ) {
@@ -3124,21 +3036,21 @@ ulong trans_diff2 ;
                 if (ptrFile->bytesPerP == 1 && trans_diff2 < (uint) ptrFile->pre_amp)
                     trans_diff2 = (uint) ptrFile->pre_amp ;  /* 8 bit */
 
-                Trans_High = TRANS_MID + trans_diff2 ;
-                Trans_Low  = TRANS_MID - trans_diff2 ;
+                ptrFile->trans_high = TRANS_MID + trans_diff2 ;
+                ptrFile->trans_low  = TRANS_MID - trans_diff2 ;
             }
             trans_diff2 = 4 ;
-            Amp_Max_Above = TRANS_MID + trans_diff2 ;
-            Amp_Min_Below = TRANS_MID - trans_diff2 ;
+            ptrFile->amp_max_above = TRANS_MID + trans_diff2 ;
+            ptrFile->amp_min_below = TRANS_MID - trans_diff2 ;
         }
-        else if (devId == DEV_EMU) { /* wave from emulator with system sound */
-            Amp_Diff_Mid = AMP_DIFF_MID*2 ;
-            Amp_Diff_Rel = AMP_DIFF_REL*2 ;
-            ptrFile->rate_amp = Rate_Amp_Def = RATE_AMP_4_CAS ;
+        else if (ptrFile->opt.devId == DEV_EMU) { /* wave from emulator with system sound */
+            ptrFile->amp_diff_mid = AMP_DIFF_MID*2 ;
+            ptrFile->amp_diff_rel = AMP_DIFF_REL*2 ;
+            ptrFile->rate_amp = ptrFile->rate_amp_def = RATE_AMP_4_CAS ;
         }
     }  // End if PC-1245-1475
 
-    else if (ptrFile->base_freq == Base_FREQ3 && Base_FREQ3 > 0) { /* PC-E/G-series */
+    else if (ptrFile->base_freq == ptrFile->base_freq3 && ptrFile->base_freq3 > 0) { /* PC-E/G-series */
 
         /* for better intermediate sync only, NOT byte reading */
         if ( ptrFile->ampd_cnt > BIT_0 && (ptrFile->debug & TRANS_OLD) == 0 ) {
@@ -3149,29 +3061,29 @@ ulong trans_diff2 ;
             if (ptrFile->bytesPerP == 1 && trans_diff2 < (uint) ptrFile->pre_amp)
                 trans_diff2 = (uint) ptrFile->pre_amp ;  /* 8 bit */
 
-            Trans_High = Trans_High_def = TRANS_MID + trans_diff2 ;
-            Trans_Low  = Trans_High_def = TRANS_MID - trans_diff2 ;
+            ptrFile->trans_high = ptrFile->trans_high_def = TRANS_MID + trans_diff2 ;
+            ptrFile->trans_low  = ptrFile->trans_high_def = TRANS_MID - trans_diff2 ;
 
             if ( trans_diff2 < 4) trans_diff2 = 4 ;
-            Amp_Max_Above = TRANS_MID + trans_diff2 ;
-            Amp_Min_Below = TRANS_MID - trans_diff2 ;
+            ptrFile->amp_max_above = TRANS_MID + trans_diff2 ;
+            ptrFile->amp_min_below = TRANS_MID - trans_diff2 ;
         }
     }   // End if PC-1600, E, G
 
 
-    if ( AMP_DIFF_MIN < Trans_High - Trans_Low) Amp_Diff_Min = Trans_High - Trans_Low ;
-    else Amp_Diff_Min = AMP_DIFF_MIN ;          /* depending from signal form */
+    if ( AMP_DIFF_MIN < ptrFile->trans_high - ptrFile->trans_low) ptrFile->amp_diff_min = ptrFile->trans_high - ptrFile->trans_low ;
+    else ptrFile->amp_diff_min = AMP_DIFF_MIN ;          /* depending from signal form */
 
-    if ( Qcnt == 0 && ptrFile->debug !=0 && ( ptrFile->base_freq != Base_FREQ3 || pcgrpId != GRP_E ) && ptrFile->synching ==0 ) {
+    if ( ptrFile->opt.Qcnt == 0 && ptrFile->debug !=0 && ( ptrFile->base_freq != ptrFile->base_freq3 || ptrFile->pcgrp_id != GRP_E ) && ptrFile->synching ==0 ) {
                     printf ("\nNew detection parameters: Trigger H/L: %02X/%02X, ",
-                            Trans_High, Trans_Low );
+                            ptrFile->trans_high, ptrFile->trans_low );
                     if ( ptrFile->rate_amp < 0) printf ("amplitudes detection: OFF\n");
                     else if ( ptrFile->rate_amp == 0) printf ("amplitudes based gain: %d\n", ptrFile->rate_amp );
                     else printf ("amplitudes based gain: ON(%d/%i)\n", ptrFile->rate_amp, RATE_SCALE );
 
                     if ( ptrFile->rate_amp >= 0)
                         printf ("Amplitudes maxima > %02X, minima < %02X,\nAmplitudes differences (dec) min: %d, relative to main: 1/%d, to last: 1/%d\n",
-                            Amp_Max_Above, Amp_Min_Below, Amp_Diff_Min, Amp_Diff_Mid, Amp_Diff_Rel );
+                            ptrFile->amp_max_above, ptrFile->amp_min_below, ptrFile->amp_diff_min, ptrFile->amp_diff_mid, ptrFile->amp_diff_rel );
 
                     printf ("\n" );
     }
@@ -3179,16 +3091,14 @@ ulong trans_diff2 ;
 
 int FindFreqAndSyncFromWav (FileInfo*  ptrFile)
 {
-static  ulong   base_freq_before = 0 ;
-
         ulong   freq_before ;
-        ulong   length ;
-         long   position ;
+        ulong   length, nbData ;
+         long   bgnWindow, endWindow ;
        double   cspeed ;
           int   error, synching, longs, shorts ;
           char  bit[1] ;
 
-    if (TAPc > 0) {
+    if (ptrFile->opt.TAPc > 0) {
             ptrFile->count = 0;
             return (ERR_OK);
     }
@@ -3203,104 +3113,105 @@ static  ulong   base_freq_before = 0 ;
         ptrFile->ampd_sum = 0 ;
     }
 
-    position = ftell( ptrFile->ptrFd ) ;
-    if (position <= 0) {
-            printf ("\n%s:freq - Can't ftell the wave file\n", argP) ;
-            return ( ERR_FILE ) ;
-    }
+    /* The first search tries all base frequencies in the same window of the wave, so the earliest sync is */
+    /* found and a false frequency does not read the whole wave, later searches use the known frequency     */
+    bgnWindow = (freq_before == 0) ? ptrFile->cursor : 0 ;
+    nbData = ptrFile->nbData ;
+
     do {
+        do {
+            endWindow = bgnWindow + (long) (SYNC_WINDOW * ptrFile->wav_freq) ;
+            if (freq_before == 0 && endWindow < (long) nbData) ptrFile->nbData = endWindow ;
 
-        if ((freq_before == 0 || ptrFile->base_freq == Base_FREQ1) &&
-             Base_FREQ1 > 0 && ptrFile->wav_freq >= (Base_FREQ1 * 2)) {
+            if ((freq_before == 0 || ptrFile->base_freq == ptrFile->base_freq1) &&
+                 ptrFile->base_freq1 > 0 && ptrFile->wav_freq >= (ptrFile->base_freq1 * 2)) {
 
-            /* Search the Synchro for the 4000 Hz frequency */
-            if (freq_before == 0 ||  base_freq_before != Base_FREQ1 ) {
-                    ptrFile->freq = ptrFile->base_freq = Base_FREQ1 ;
+                /* Search the Synchro for the 4000 Hz frequency */
+                if (freq_before == 0 ||  ptrFile->base_freq_before != ptrFile->base_freq1 ) {
+                        ptrFile->freq = ptrFile->base_freq = ptrFile->base_freq1 ;
 
-                    if (ptrFile->base_freq * FRQ_AMPS <= ptrFile->wav_freq && (ptrFile->debug & TRANS_OLD) == 0)
-                         ptrFile->rate_amp = Rate_Amp_Def ;
-                    else ptrFile->rate_amp = RATE_AMP_OFF ; /* amplitudes detection and amplification off */
+                        if (ptrFile->base_freq * FRQ_AMPS <= ptrFile->wav_freq && (ptrFile->debug & TRANS_OLD) == 0)
+                             ptrFile->rate_amp = ptrFile->rate_amp_def ;
+                        else ptrFile->rate_amp = RATE_AMP_OFF ; /* amplitudes detection and amplification off */
 
-                    Amp_Max_Above = AMP_MAX_ABOVE ;         /* this series has more problems with DC-shifted signal*/
-                    Amp_Min_Below = AMP_MIN_BELOW ;
+                        ptrFile->amp_max_above = AMP_MAX_ABOVE ;         /* this series has more problems with DC-shifted signal*/
+                        ptrFile->amp_min_below = AMP_MIN_BELOW ;
 
-                    Trans_High = Trans_High_def ;           /* Higher sample value accept transition to high */
-                    Trans_Low  = Trans_Low_def ;            /* Lower sample value accept transition to high */
-            }
-            ReadBitParamAdjust( ptrFile ) ;                 /* special settings for PC 121x hardware */
-
-            error = FindSyncFromWav (&length, ptrFile) ;
-            if (error > ERR_OK) break ;                     /* ERR_NSYNC/EOF/NOK from end of audio data */
-            if ( length == 0 || error < ERR_OK) {
-                error = fseek (ptrFile->ptrFd, ptrFile->bgnSamples, SEEK_SET) ; /* rewind to start of audio data */
-                if (error != ERR_OK) {
-                    printf ("\n%s:freq - Can't seek the file, rewind from: %ld\n", argP, position) ;
-                    error = ERR_FILE ;
-                    break ;
+                        ptrFile->trans_high = ptrFile->trans_high_def ;           /* Higher sample value accept transition to high */
+                        ptrFile->trans_low  = ptrFile->trans_low_def ;            /* Lower sample value accept transition to high */
+                }
+                ReadBitParamAdjust( ptrFile ) ;                 /* special settings for PC 121x hardware */
+
+                error = FindSyncFromWav (&length, ptrFile) ;
+                if (error > ERR_OK) break ;                     /* ERR_NSYNC/EOF/NOK from end of audio data */
+                if ( length == 0 || error < ERR_OK) {
+                    ptrFile->cursor = bgnWindow ; /* rewind to start of window */
+                    error = ERR_OK ;
                 }
             }
-        }
-        else length = 0 ;
+            else length = 0 ;
 
-        if ( length == 0 && (freq_before == 0 || ptrFile->base_freq == Base_FREQ2 ) && Base_FREQ2 > 0) {
+            if ( length == 0 && (freq_before == 0 || ptrFile->base_freq == ptrFile->base_freq2 ) && ptrFile->base_freq2 > 0) {
 
-            /* Search the Synchro for the 2500 Hz frequency */
-            if (freq_before == 0 ||  base_freq_before != Base_FREQ2 ) {
-                ptrFile->freq = ptrFile->base_freq = Base_FREQ2 ;
+                /* Search the Synchro for the 2500 Hz frequency */
+                if (freq_before == 0 ||  ptrFile->base_freq_before != ptrFile->base_freq2 ) {
+                    ptrFile->freq = ptrFile->base_freq = ptrFile->base_freq2 ;
 
-                if (ptrFile->base_freq * FRQ_AMPS <= ptrFile->wav_freq && (ptrFile->debug & TRANS_OLD) == 0)
-                     ptrFile->rate_amp = RATE_AMP_15 ;
-                else ptrFile->rate_amp = RATE_AMP_OFF ;
+                    if (ptrFile->base_freq * FRQ_AMPS <= ptrFile->wav_freq && (ptrFile->debug & TRANS_OLD) == 0)
+                         ptrFile->rate_amp = RATE_AMP_15 ;
+                    else ptrFile->rate_amp = RATE_AMP_OFF ;
 
-                Amp_Max_Above = AMP_MAX_ABV_15 ; /* problematic curve because of base frequency switching to low frequency signal */
-                Amp_Min_Below = AMP_MIN_BLW_15 ; /* first time */
+                    ptrFile->amp_max_above = AMP_MAX_ABV_15 ; /* problematic curve because of base frequency switching to low frequency signal */
+                    ptrFile->amp_min_below = AMP_MIN_BLW_15 ; /* first time */
 
-                Trans_High = Trans_High_15 ;
-                Trans_Low  = Trans_Low_15 ;
-            }
-            ReadBitParamAdjust( ptrFile ) ;  /* special settings for PC 1500 hardware */
-
-            error = FindSyncFromWav (&length, ptrFile) ;
-            if (error > ERR_OK ) break ; /* ERR_NSYNC/EOF/NOK from end of audio data */
-            if ( length == 0 || error < ERR_OK) {
-                error = fseek (ptrFile->ptrFd, ptrFile->bgnSamples, SEEK_SET) ; /* rewind */
-                if (error != ERR_OK) {
-                    printf ("\n%s:freq - Can't seek the file, rewind from: %ld\n", argP, position) ;
-                    error = ERR_FILE ;
-                    break ;
+                    ptrFile->trans_high = ptrFile->trans_high_15 ;
+                    ptrFile->trans_low  = ptrFile->trans_low_15 ;
+                }
+                ReadBitParamAdjust( ptrFile ) ;  /* special settings for PC 1500 hardware */
+
+                error = FindSyncFromWav (&length, ptrFile) ;
+                if (error > ERR_OK ) break ; /* ERR_NSYNC/EOF/NOK from end of audio data */
+                if ( length == 0 || error < ERR_OK) {
+                    ptrFile->cursor = bgnWindow ; /* rewind */
+                    error = ERR_OK ;
                 }
             }
-        }
-        if (length == 0 && (freq_before == 0 || ptrFile->base_freq == Base_FREQ3 ) && Base_FREQ3 > 0) {
+            if (length == 0 && (freq_before == 0 || ptrFile->base_freq == ptrFile->base_freq3 ) && ptrFile->base_freq3 > 0) {
 
-            /* Search the Synchro for the frequency of PC-1600 and PC-E/G-Series */
-            if (freq_before == 0 ||  base_freq_before != Base_FREQ3 ) {
-                ptrFile->freq = ptrFile->base_freq = Base_FREQ3 ;
+                /* Search the Synchro for the frequency of PC-1600 and PC-E/G-Series */
+                if (freq_before == 0 ||  ptrFile->base_freq_before != ptrFile->base_freq3 ) {
+                    ptrFile->freq = ptrFile->base_freq = ptrFile->base_freq3 ;
 
-                if (ptrFile->base_freq * FRQ_AMPS <= ptrFile->wav_freq && (ptrFile->debug & TRANS_OLD) == 0)
-                    ptrFile->rate_amp = Rate_Amp_Def ;
-                else ptrFile->rate_amp = RATE_AMP_OFF ;
+                    if (ptrFile->base_freq * FRQ_AMPS <= ptrFile->wav_freq && (ptrFile->debug & TRANS_OLD) == 0)
+                        ptrFile->rate_amp = ptrFile->rate_amp_def ;
+                    else ptrFile->rate_amp = RATE_AMP_OFF ;
 
-                Amp_Max_Above = AMP_MAX_ABOVE ;
-                Amp_Min_Below = AMP_MIN_BELOW ;
+                    ptrFile->amp_max_above = AMP_MAX_ABOVE ;
+                    ptrFile->amp_min_below = AMP_MIN_BELOW ;
 
-                Trans_High = TRANS_HIGH_E ;
-                Trans_Low  = TRANS_LOW_E  ;
-            }
-            ReadBitParamAdjust( ptrFile ) ;
+                    ptrFile->trans_high = TRANS_HIGH_E ;
+                    ptrFile->trans_low  = TRANS_LOW_E  ;
+                }
+                ReadBitParamAdjust( ptrFile ) ;
 
-            error = FindSyncFromWav (&length, ptrFile) ;
-            if ( length == 0 || error < ERR_OK) {
-                error = fseek (ptrFile->ptrFd, ptrFile->bgnSamples, SEEK_SET) ; /* rewind */
-                if (error != ERR_OK) {
-                    printf ("\n%s:freq - Can't seek the file, rewind from: %ld\n", argP, position) ;
-                    error = ERR_FILE ;
-                    break ;
+                error = FindSyncFromWav (&length, ptrFile) ;
+                if ( length == 0 || error < ERR_OK) {
+                    ptrFile->cursor = bgnWindow ; /* rewind */
+                    error = ERR_OK ;
                 }
             }
-        }
 
-        if (Qcnt == 0 && ptrFile->total > 0) {
+            if (error > ERR_OK || length > 0 || ptrFile->nbData == nbData) break ;
+
+            /* no sync in this window, try the next */
+            ptrFile->nbData = nbData ;
+            bgnWindow = endWindow - (long) (SYNC_OVERLAP * ptrFile->wav_freq) ;
+            ptrFile->cursor = bgnWindow ;
+        } while (1) ;
+        ptrFile->nbData = nbData ;
+        if (error > ERR_OK) break ;
+
+        if (ptrFile->opt.Qcnt == 0 && ptrFile->total > 0) {
             /* for data variable blocks the byte counter because of checksums can be manipulated */
             if (ptrFile->debug !=0 ) printf ("\n") ;
             if ( ptrFile->ident != IDENT_NEW_DAT && ptrFile->ident != IDENT_PC121_DAT &&
@@ -3312,23 +3223,23 @@ static  ulong   base_freq_before = 0 ;
             ptrFile->synching = 0;
 
             length = (length * 80 + ptrFile->freq / 2) / ptrFile->freq ;
-            if (Qcnt == 0)  {
+            if (ptrFile->opt.Qcnt == 0)  {
                 if (ptrFile->debug !=0 ) printf ("\n") ;
                 printf ("Synchronisation %ld Hz with a length of %ld.%ld sec found up to %.5lf s\n",
                             ptrFile->freq, length / 10, length % 10, WavTime(ptrFile));
                 cspeed = (double) ptrFile->freq / ptrFile->base_freq ;
-                if ( 0.97 > cspeed || cspeed > 1.03 ) printf ("Setting of --cspeed=%.3lf is recommended for this device.\n", cspeed * speed) ;
+                if ( 0.97 > cspeed || cspeed > 1.03 ) printf ("Setting of --cspeed=%.3lf is recommended for this device.\n", cspeed * ptrFile->opt.speed) ;
                 if (ptrFile->debug !=0 ) {
                     printf ("Bit length %lu samples, trigger: %02X/%02X (8bit), ",
-                            ptrFile->bitLen, Trans_High, Trans_Low );
+                            ptrFile->bitLen, ptrFile->trans_high, ptrFile->trans_low );
                     if ( ptrFile->rate_amp < 0) printf ("amplitudes detection: OFF\n");
                     else if ( ptrFile->rate_amp == 0) printf ("amplitudes based gain: %d\n", ptrFile->rate_amp );
                     else printf ("amplitudes based gain: ON(%d/%i)\n", ptrFile->rate_amp, RATE_SCALE );
-                    if ( ptrFile->base_freq == Base_FREQ3)
+                    if ( ptrFile->base_freq == ptrFile->base_freq3)
                         printf ("(for first synchronisation), start length based reading now, sync bits: ") ;
                 }
             }
-            if ( ptrFile->base_freq == Base_FREQ3 ) {
+            if ( ptrFile->base_freq == ptrFile->base_freq3 ) {
             /* switch to bit reading method of PC-1600, E/G-series series now */
 
             /*  BASE_FREQ3 3000/1200 Hz (0/1), 2 transmissions/bit with variable length (1T) 1A 1T 1A (1T),
@@ -3360,13 +3271,13 @@ static  ulong   base_freq_before = 0 ;
                     } while ( bit[0] == 0 && error == ERR_OK) ;
                     if (error != ERR_OK) break ;
 
-                    if (Qcnt == 0 && ptrFile->debug !=0 ) printf ("(%i=%i)\n", longs, shorts) ;
+                    if (ptrFile->opt.Qcnt == 0 && ptrFile->debug !=0 ) printf ("(%i=%i)\n", longs, shorts) ;
                     if ((synching  > 1 && (longs != SYNC_E_HEAD || shorts != SYNC_E_HEAD )) ||
                         (synching == 1 && (longs != SYNC_E_DATA || shorts != SYNC_E_DATA ))  ) {
 
-                        printf ("\n%s: Illegal start bit synchronisation at %.5lf s\n", argP, WavTime(ptrFile));
+                        printf ("\n%s: Illegal start bit synchronisation at %.5lf s\n", ptrFile->opt.argP, WavTime(ptrFile));
                         if (synching > 1 && (longs == SYNC_E_DATA || shorts == SYNC_E_DATA )) {
-                                printf ("\n%s: File header not found. File starts with a data block.\n", argP);
+                                printf ("\n%s: File header not found. File starts with a data block.\n", ptrFile->opt.argP);
                                 error = ERR_FMT;
                         }
                         else ++ ptrFile->wrn_cnt ;
@@ -3374,11 +3285,11 @@ static  ulong   base_freq_before = 0 ;
             }
         }
         else {
-            if (Qcnt == 0 || ptrFile->debug != 0) {
+            if (ptrFile->opt.Qcnt == 0 || ptrFile->debug != 0) {
                 if (WavTime(ptrFile) < 10000)
-                    printf ("%s: None synchronisation found from %.5lf s\n", argP, WavTime(ptrFile));
+                    printf ("%s: None synchronisation found from %.5lf s\n", ptrFile->opt.argP, WavTime(ptrFile));
                 else
-                    printf ("%s: None synchronisation found\n", argP);
+                    printf ("%s: None synchronisation found\n", ptrFile->opt.argP);
             }
             // ptrFile->freq = 0 ; no more, because next synchronisation has to be frequency specific /
             error = ERR_NSYNC ;
@@ -3388,7 +3299,7 @@ static  ulong   base_freq_before = 0 ;
 
     } while (0) ;
 
-    base_freq_before = ptrFile->base_freq ;
+    ptrFile->base_freq_before = ptrFile->base_freq ;
 
     return (error);
 }
@@ -3405,7 +3316,7 @@ int ReadQuaterFromTap ( ulong*  ptrQuat,
     do {
         inVal = fgetc (ptrFile->ptrFd) ;
         if (inVal == EOF) {
-            if (Qcnt == 0 && ptrFile->debug!=0) printf ("\nEnd of File\n") ;
+            if (ptrFile->opt.Qcnt == 0 && ptrFile->debug!=0) printf ("\nEnd of File\n") ;
             error = ERR_EOF ;
             break ;
         }
@@ -3428,17 +3339,14 @@ int ReadQuaterFromWav (ulong*  ptrQuat,
                        ulong*  ptrNb,
                        FileInfo*  ptrFile)
 {
-    static bool StopBitMissed = false ;
-    static long StopBitMisPos = -1 ;
-
     ulong  code ;
      char  bit[6] ;
      uint  ii ;
       int  error ;
 
-    if (TAPc > 0) return (ReadQuaterFromTap (ptrQuat, ptrFile));
+    if (ptrFile->opt.TAPc > 0) return (ReadQuaterFromTap (ptrQuat, ptrFile));
 
-    if ( ( (ptrFile->debug & 0x10001) > 0 ) && (Qcnt == 0) ) {
+    if ( ( (ptrFile->debug & 0x10001) > 0 ) && (ptrFile->opt.Qcnt == 0) ) {
             printf(" q{");
             if ( (ptrFile->debug & 0x10000) > 0 ) printf("\n");
     }
@@ -3446,8 +3354,8 @@ int ReadQuaterFromWav (ulong*  ptrQuat,
     do {
         *ptrQuat = UNREAD ;
         /* corrects some transmission errors when the first stop bit is combined stop-start-bit */
-        if (StopBitMissed && StopBitMisPos == ftell( ptrFile->ptrFd ) ) {
-            if (Qcnt == 0) printf ("Start bit skipped because stop bit error in nibble before %.5lf s\n", WavTime(ptrFile));
+        if (ptrFile->stop_bit_missed && ptrFile->stop_bit_mispos == ptrFile->cursor ) {
+            if (ptrFile->opt.Qcnt == 0) printf ("Start bit skipped because stop bit error in nibble before %.5lf s\n", WavTime(ptrFile));
             bit[0]= 0 ;
             error = ReadBitFieldFromWav (5, &bit[1], ptrFile) ;
         }
@@ -3455,11 +3363,11 @@ int ReadQuaterFromWav (ulong*  ptrQuat,
         else {
             error = ReadBitFieldFromWav (6, bit, ptrFile) ;
         }
-        StopBitMissed = false ;
+        ptrFile->stop_bit_missed = false ;
         if (error != ERR_OK) break ;
 
         if (bit[0] != 0 ) {
-            if (Qcnt == 0) printf ("Start bit expected in nibble before %.5lf s\n", WavTime(ptrFile));
+            if (ptrFile->opt.Qcnt == 0) printf ("Start bit expected in nibble before %.5lf s\n", WavTime(ptrFile));
             error = count_errors( ERR_SYNC, ptrFile );
             if (error != ERR_OK) break ;
 
@@ -3480,22 +3388,18 @@ int ReadQuaterFromWav (ulong*  ptrQuat,
         }
         *ptrQuat = code ;
 
-        if ( ( (ptrFile->debug & 0x0010) > 0 ) && (Qcnt == 0) && code < UNREAD )
+        if ( ( (ptrFile->debug & 0x0010) > 0 ) && (ptrFile->opt.Qcnt == 0) && code < UNREAD )
             printf(" %1X", (uint) code);
 
         if (code >= UNREAD) { /* Should never appear */
-            if (Qcnt == 0 ) printf ("Incomplete nibble before %.5lf s\n", WavTime(ptrFile));
+            if (ptrFile->opt.Qcnt == 0 ) printf ("Incomplete nibble before %.5lf s\n", WavTime(ptrFile));
         }
         /* Read one mandatory stop bit to stay synchronously after some bit errors */
         /* from hardware, such as combined start/stop bit */
         else if (bit[5] != 1 ) {
-            if (Qcnt == 0) printf ("Stop bit missed in nibble before %.5lf s\n", WavTime(ptrFile));
-            StopBitMissed = true ;
-            StopBitMisPos = ftell( ptrFile->ptrFd ) ;
-            if (StopBitMisPos <= 0) {
-                printf ("\n%s:readq - Can't ftell the wave file\n", argP) ;
-                return ( ERR_FILE ) ;
-            }
+            if (ptrFile->opt.Qcnt == 0) printf ("Stop bit missed in nibble before %.5lf s\n", WavTime(ptrFile));
+            ptrFile->stop_bit_missed = true ;
+            ptrFile->stop_bit_mispos = ptrFile->cursor ;
             error = count_errors( ERR_SYNC, ptrFile );
             if (error != ERR_OK) break ;
         }
@@ -3507,7 +3411,7 @@ int ReadQuaterFromWav (ulong*  ptrQuat,
 
     } while (0) ;
 
-    if ( ( (ptrFile->debug & 0x10001) > 0 ) && (Qcnt == 0) ) {
+    if ( ( (ptrFile->debug & 0x10001) > 0 ) && (ptrFile->opt.Qcnt == 0) ) {
             printf("}q ");
     }
 
@@ -3521,12 +3425,13 @@ int SwapByte (ulong byte)
 }
 
 int WriteByteToDatFile (uchar  byte,
-                      FILE**  ptrFd)
+                      FILE**  ptrFd,
+                  FileInfo*  ptrFile)
 {
     int  error ;
 
-    if (SHCc == 0) error = WriteByteToFile (byte, ptrFd) ;
-    else error = WriteByteToFile ( SwapByte(byte),ptrFd) ;
+    if (ptrFile->opt.SHCc == 0) error = WriteByteToFile (byte, ptrFd, ptrFile) ;
+    else error = WriteByteToFile ( SwapByte(byte),ptrFd, ptrFile) ;
 
     return (error);
 }
@@ -3543,7 +3448,7 @@ int ReadByteFromTap (   ulong  order,
     *ptrByte = UNREAD ;
 
     do {
-        if (ptrFile->base_freq == Base_FREQ2 && Base_FREQ2 > 0 ) { /* PC-1500 */
+        if (ptrFile->base_freq == ptrFile->base_freq2 && ptrFile->base_freq2 > 0 ) { /* PC-1500 */
 
             if (order == ORDER_INV) {
                 error = ReadQuaterFromTap (&lsq, ptrFile) ;
@@ -3562,7 +3467,7 @@ int ReadByteFromTap (   ulong  order,
             inVal = fgetc (ptrFile->ptrFd) ;
 
             if (inVal == EOF) {
-                if (Qcnt == 0 && ptrFile->debug!=0) printf ("\nEnd of File\n") ;
+                if (ptrFile->opt.Qcnt == 0 && ptrFile->debug!=0) printf ("\nEnd of File\n") ;
                 error = ERR_EOF ;
                 break ;
             }
@@ -3587,7 +3492,7 @@ int ReadByteFromEWav (  ulong*  ptrByte,
      char  bit[10] ;
       int  ii, error ;
 
-    if (TAPc > 0) return (ReadByteFromTap (ORDER_E, ptrByte, ptrFile)) ;
+    if (ptrFile->opt.TAPc > 0) return (ReadByteFromTap (ORDER_E, ptrByte, ptrFile)) ;
 
     do {
         *ptrByte = 0 ;
@@ -3599,7 +3504,7 @@ int ReadByteFromEWav (  ulong*  ptrByte,
         }
 
         if (bit[0] != 1 ) {
-            if (Qcnt == 0) printf ("Start bit expected in byte before %.5lf s\n", WavTime(ptrFile));
+            if (ptrFile->opt.Qcnt == 0) printf ("Start bit expected in byte before %.5lf s\n", WavTime(ptrFile));
             error = count_errors( ERR_SYNC, ptrFile );
             if (error != ERR_OK) break ;
         }
@@ -3610,7 +3515,7 @@ int ReadByteFromEWav (  ulong*  ptrByte,
         }
         *ptrByte = code ;
 
-        if ( ( (ptrFile->debug & 0x0020) > 0 ) && (Qcnt == 0) )
+        if ( ( (ptrFile->debug & 0x0020) > 0 ) && (ptrFile->opt.Qcnt == 0) )
             printf(" %02X", (uchar) *ptrByte);
 
     } while (0) ;
@@ -3623,12 +3528,11 @@ int ReadByteFromWav (ulong  order,
                      ulong*  ptrByte,
                      FileInfo*  ptrFile)
 {
-    static ulong MissStopBitsCnt = 0 ;
     ulong  msq, lsq ;
     ulong  nbStopBits ; /* additional stop bits was read for error compensation */
       int  error ;
 
-    if (TAPc > 0) return (ReadByteFromTap (order, ptrByte, ptrFile)) ;
+    if (ptrFile->opt.TAPc > 0) return (ReadByteFromTap (order, ptrByte, ptrFile)) ;
 
     if (order == ORDER_E) return (ReadByteFromEWav ( ptrByte, ptrFile)) ;
 
@@ -3669,24 +3573,24 @@ int ReadByteFromWav (ulong  order,
         if (error != ERR_OK) break ;
 
         if ( nbStopBits < 1 ) { /* first stop bit was separate read and has number 0 */
-            if (Qcnt == 0 && ptrFile->debug != 0)
+            if (ptrFile->opt.Qcnt == 0 && ptrFile->debug != 0)
                 printf ("More stop bits for a byte expected before %.5lf s\n", WavTime(ptrFile));
 
-            if (ptrFile->err_last == ERR_ORD) ++MissStopBitsCnt ;
+            if (ptrFile->err_last == ERR_ORD) ++ptrFile->miss_stop_bits ;
             error = count_errors( ERR_ORD, ptrFile );
             if (error != ERR_OK) break ;
 
-            if (MissStopBitsCnt > CNT_ERR_ORD) { /* for NEW_series most likely nibbles are shifted between bytes */
+            if (ptrFile->miss_stop_bits > CNT_ERR_ORD) { /* for NEW_series most likely nibbles are shifted between bytes */
                 printf ("Trying to shift a nibble to the next byte, minimum one nibble [%1x] lost.\n", (uchar) msq );
                 msq = lsq ;
                 error = ReadQuaterFromWav (&lsq, &nbStopBits, ptrFile) ;
                 *ptrByte = (msq << 4) + lsq ;
-                MissStopBitsCnt = 0 ;
+                ptrFile->miss_stop_bits = 0 ;
                 if (error != ERR_OK) break ;
             }
         }
 
-        if ( ( (ptrFile->debug & 0x0020) > 0 ) && (Qcnt == 0) && *ptrByte < UNREAD )
+        if ( ( (ptrFile->debug & 0x0020) > 0 ) && (ptrFile->opt.Qcnt == 0) && *ptrByte < UNREAD )
             printf(" %02X", (uchar) *ptrByte);
 
     } while (0) ;
@@ -3706,16 +3610,16 @@ int ReadByteTraceFromWav (ulong  order,
 
         if (ptrFile->writing ) ++ ptrFile->total ;
 
-        if ( ( (ptrFile->debug & 0x20000) != 0 ) && (Qcnt == 0) )
+        if ( ( (ptrFile->debug & 0x20000) != 0 ) && (ptrFile->opt.Qcnt == 0) )
                 printf(" %lu:", ptrFile->count);
 
-        if ( ( (ptrFile->debug & 0x0400) > 0 ) && (Qcnt == 0) ) {
+        if ( ( (ptrFile->debug & 0x0400) > 0 ) && (ptrFile->opt.Qcnt == 0) ) {
             if ( *ptrByte > 32 && *ptrByte < 128 )
                     printf("%ld: %3lu [%02X]  %c  %.5f s\n", ptrFile->total, *ptrByte, (uchar) *ptrByte, (uchar) *ptrByte, WavTime(ptrFile) ) ;
             else
                     printf("%ld: %3lu [%02X]     %.5f s\n", ptrFile->total, *ptrByte, (uchar) *ptrByte, WavTime(ptrFile) ) ;
         }
-        else if ( (ptrFile->debug & 0x0040) > 0 && Qcnt == 0 ) {
+        else if ( (ptrFile->debug & 0x0040) > 0 && ptrFile->opt.Qcnt == 0 ) {
                 printf(" %02X", (uchar) *ptrByte);
                 if ( (ptrFile->debug & 0xC0) == 0x40 && ptrFile->writing && ptrFile->total %0x100 == 0 ) printf("\n");
         }
@@ -3792,10 +3696,10 @@ int ReadByteSumFromWav (ulong  order,
                 if (sum != ptrFile->sum) {
                     if ((ptrFile->debug & IGN_ERR_SUM) == 0 ) error = ERR_SUM ;
                     else error = count_errors( ERR_SUM, ptrFile) ;
-                    if (Qcnt == 0) printf(" ERROR %d, Block end: %ld, %.4f s\n", ERR_SUM, ptrFile->total,
+                    if (ptrFile->opt.Qcnt == 0) printf(" ERROR %d, Block end: %ld, %.4f s\n", ERR_SUM, ptrFile->total,
                                             WavTime(ptrFile) ) ;
                 }
-                if ( ( (ptrFile->debug & 0x0040) > 0 ) && (Qcnt == 0) )
+                if ( ( (ptrFile->debug & 0x0040) > 0 ) && (ptrFile->opt.Qcnt == 0) )
                     printf(" (%04X=%04X)", (uint) sum, (uint) ptrFile->sum);
                 if (error != ERR_OK) break ;
                 ptrFile->sum = 0 ;
@@ -3810,17 +3714,17 @@ int ReadByteSumFromWav (ulong  order,
             CheckSum (order, ptrByte, ptrFile);
             if ( (ptrFile->count % BLK_OLD_SUM) == 0) {
                 error = ReadByteFromWav (order, &sum, ptrFile);
-                if ( error < ERR_OK && ( (ptrFile->debug & 0x0040) > 0 ) && (Qcnt == 0) )
+                if ( error < ERR_OK && ( (ptrFile->debug & 0x0040) > 0 ) && (ptrFile->opt.Qcnt == 0) )
                     printf(" EOF:"); // End of File, error because of no sync
 
                 if (sum != ptrFile->sum) {
                     if ((ptrFile->debug & IGN_ERR_SUM) == 0 ) error = ERR_SUM ;
                     else error = count_errors( ERR_SUM, ptrFile) ;
-                    if (Qcnt == 0) printf(" ERROR %d, Block end: %ld, %.4f s\n", ERR_SUM, ptrFile->total,
+                    if (ptrFile->opt.Qcnt == 0) printf(" ERROR %d, Block end: %ld, %.4f s\n", ERR_SUM, ptrFile->total,
                                             WavTime(ptrFile) ) ;
                 }
 
-                if ( ( (ptrFile->debug & 0x0040) > 0 ) && (Qcnt == 0) )
+                if ( ( (ptrFile->debug & 0x0040) > 0 ) && (ptrFile->opt.Qcnt == 0) )
                     printf(" (%02X=%02X)", (uchar) sum, (uchar) ptrFile->sum);
                 if (error != ERR_OK) break ;
 
@@ -3838,17 +3742,17 @@ int ReadByteSumFromWav (ulong  order,
             CheckSum (order, ptrByte, ptrFile);
             if ( (ptrFile->count % BLK_OLD_SUM) == 0) {
                 error = ReadByteFromWav (ORDER_STD, &sum, ptrFile);
-                if ( ( (ptrFile->debug & 0x0040) > 0 ) && (Qcnt == 0) ) {
+                if ( ( (ptrFile->debug & 0x0040) > 0 ) && (ptrFile->opt.Qcnt == 0) ) {
                     if (error == ERR_EOF )  printf(" EOF:"); // End of File,
                     if (error == ERR_NSYNC) printf(" EOB:"); // End of Block, error because of NewSync
                 }
                 if (sum != ptrFile->sum) {
                     if ((ptrFile->debug & IGN_ERR_SUM) == 0 ) error = ERR_SUM ;
                     else error = count_errors( ERR_SUM, ptrFile) ;
-                    if (Qcnt == 0) printf(" ERROR %d, Block end: %ld, %.4f s\n", ERR_SUM, ptrFile->total,
+                    if (ptrFile->opt.Qcnt == 0) printf(" ERROR %d, Block end: %ld, %.4f s\n", ERR_SUM, ptrFile->total,
                                             WavTime(ptrFile) ) ;
                 }
-                if ( ( (ptrFile->debug & 0x0040) > 0 ) && (Qcnt == 0) )
+                if ( ( (ptrFile->debug & 0x0040) > 0 ) && (ptrFile->opt.Qcnt == 0) )
                     printf(" (%02X=%02X)", (uchar) sum, (uchar) ptrFile->sum);
                 // if (error != ERR_OK) break ;
                 ptrFile->sum = 0 ;
@@ -3867,18 +3771,18 @@ int ReadByteSumFromWav (ulong  order,
 
                 /* if 0xFF follows a end of line it could be a checksum 0xFF or a BAS_NEW_EOF */
                 if ( ptrFile->check_end && sum == BAS_NEW_EOF){          /*check_end set before line end from ReadLine */
-                    position = ftell( ptrFile->ptrFd ) ;                 /*save position in source file */
-                    if (position <= 0) {
-                        printf ("\n%s:ByteSum - Can't ftell the wave file\n", argP) ;
+                    position = WavTell (ptrFile) ;                 /*save position in source file */
+                    if (position < 0) {
+                        printf ("\n%s:ByteSum - Can't ftell the wave file\n", ptrFile->opt.argP) ;
                         return ( ERR_FILE ) ;
                     }
                     /* if the second byte is also BAS_NEW_EOF, then end of transmission, else its a merged programs mark*/
                     error = ReadByteFromWav (ORDER_STD, &sumH, ptrFile);
                     if (error != ERR_OK) break ;
 
-                    error = fseek (ptrFile->ptrFd, position, SEEK_SET) ; /*rewind to position before last byte read */
+                    error = WavSeek (ptrFile, position) ; /*rewind to position before last byte read */
                     if (error != ERR_OK) {
-                        printf ("\n%s:ByteSum - Can't seek the file: %ld\n", argP, position) ;
+                        printf ("\n%s:ByteSum - Can't seek the file: %ld\n", ptrFile->opt.argP, position) ;
                         error = ERR_FILE ;
                         break ;
                     }
@@ -3888,16 +3792,16 @@ int ReadByteSumFromWav (ulong  order,
                     if (sum != ptrFile->sum) {
                         if ((ptrFile->debug & IGN_ERR_SUM) == 0) error = ERR_SUM ;
                         else error = count_errors( ERR_SUM, ptrFile) ;
-                        if (Qcnt == 0) printf(" ERROR %d, Block end: %ld, %.4f s\n", ERR_SUM,
+                        if (ptrFile->opt.Qcnt == 0) printf(" ERROR %d, Block end: %ld, %.4f s\n", ERR_SUM,
                                                             ptrFile->total, WavTime(ptrFile) ) ;
                     }
-                    if ( ( (ptrFile->debug & 0x0040) > 0 ) && (Qcnt == 0) )
+                    if ( ( (ptrFile->debug & 0x0040) > 0 ) && (ptrFile->opt.Qcnt == 0) )
                         printf(" (%02X=%02X)", (uchar) sum, (uchar) ptrFile->sum);
                     if (error != ERR_OK) break ;
 
                     ptrFile->sum = 0 ;
                 }
-                else if ( ( (ptrFile->debug & 0x0040) > 0 ) && (Qcnt == 0) )
+                else if ( ( (ptrFile->debug & 0x0040) > 0 ) && (ptrFile->opt.Qcnt == 0) )
                         printf(" EOF1:(%02X)", (uchar) sum);   /* if this first of both EOF marks was read instead a checksum,
                         this has to considered by ReadLine */
 
@@ -3928,10 +3832,10 @@ int ReadByteSumFromWav (ulong  order,
                 if (sum != ptrFile->sum) {
                     if ((ptrFile->debug & IGN_ERR_SUM) == 0 ) error = ERR_SUM ;
                     else error = count_errors( ERR_SUM, ptrFile) ;
-                    if (Qcnt == 0) printf(" ERROR %d, Block end: %ld, %.4f s\n", ERR_SUM, ptrFile->total,
+                    if (ptrFile->opt.Qcnt == 0) printf(" ERROR %d, Block end: %ld, %.4f s\n", ERR_SUM, ptrFile->total,
                                             WavTime(ptrFile) ) ;
                 }
-                if ( ( (ptrFile->debug & 0x0040) > 0 ) && (Qcnt == 0) )
+                if ( ( (ptrFile->debug & 0x0040) > 0 ) && (ptrFile->opt.Qcnt == 0) )
                     printf(" (%04X=%04X)", (uint) sum, (uint) ptrFile->sum);
                 if (error != ERR_OK) break ;
 
@@ -3944,7 +3848,7 @@ int ReadByteSumFromWav (ulong  order,
             break ;
 
         default :
-            printf ("\n%s:RBSum: Unknown Ident\n", argP) ;
+            printf ("\n%s:RBSum: Unknown Ident\n", ptrFile->opt.argP) ;
             error = ERR_FMT;
             break ;
         }
@@ -3960,62 +3864,62 @@ int PrintSaveIdFromWav (FileInfo*  ptrFile)
     int error = ERR_OK ;
     ulong code = ptrFile->ident ;
 
-    if (Qcnt == 0) printf ("Wave format   : 0x%02X -> ", (uchar) code) ;
+    if (ptrFile->opt.Qcnt == 0) printf ("Wave format   : 0x%02X -> ", (uchar) code) ;
 
     if (code == IDENT_PC1211)
-        {if (Qcnt == 0) printf ("Basic, PC-121x\n") ; pcgrpId = IDENT_PC1211 ;}
+        {if (ptrFile->opt.Qcnt == 0) printf ("Basic, PC-121x\n") ; ptrFile->pcgrp_id = IDENT_PC1211 ;}
     else if (code == IDENT_PC121_DAT)
-        {if (Qcnt == 0) printf ("Data, PC-121x\n") ; pcgrpId = IDENT_PC1211 ;}
+        {if (ptrFile->opt.Qcnt == 0) printf ("Data, PC-121x\n") ; ptrFile->pcgrp_id = IDENT_PC1211 ;}
     else if (code == IDENT_PC15_BAS)
-        {if (Qcnt == 0) printf ("Basic, PC-1500\n") ; pcgrpId = IDENT_PC1500 ;}
+        {if (ptrFile->opt.Qcnt == 0) printf ("Basic, PC-1500\n") ; ptrFile->pcgrp_id = IDENT_PC1500 ;}
     else if (code == IDENT_PC15_BIN)
-        {if (Qcnt == 0) printf ("Binary, PC-1500\n") ; pcgrpId = IDENT_PC1500 ;}
+        {if (ptrFile->opt.Qcnt == 0) printf ("Binary, PC-1500\n") ; ptrFile->pcgrp_id = IDENT_PC1500 ;}
     else if (code == IDENT_PC15_RSV)
-        {if (Qcnt == 0) printf ("Reserve Data, PC-1500\n") ; pcgrpId = IDENT_PC1500 ;}
+        {if (ptrFile->opt.Qcnt == 0) printf ("Reserve Data, PC-1500\n") ; ptrFile->pcgrp_id = IDENT_PC1500 ;}
     else if (code == IDENT_PC15_DAT)
-        {if (Qcnt == 0) printf ("DATA, PC-1500\n") ; pcgrpId = IDENT_PC1500 ;}
+        {if (ptrFile->opt.Qcnt == 0) printf ("DATA, PC-1500\n") ; ptrFile->pcgrp_id = IDENT_PC1500 ;}
     else if (code == IDENT_NEW_BAS)
-        {if (Qcnt == 0) printf ("Basic, New\n") ; pcgrpId = GRP_NEW ;}
+        {if (ptrFile->opt.Qcnt == 0) printf ("Basic, New\n") ; ptrFile->pcgrp_id = GRP_NEW ;}
     else if (code == IDENT_NEW_PAS)
-        {if (Qcnt == 0) printf ("Basic with password, New\n") ; pcgrpId = GRP_NEW ;}
+        {if (ptrFile->opt.Qcnt == 0) printf ("Basic with password, New\n") ; ptrFile->pcgrp_id = GRP_NEW ;}
     else if (code == IDENT_EXT_BAS)
-        {if (Qcnt == 0) printf ("Basic, Extended\n") ;
-         if ( pcgrpId != GRP_E ) pcgrpId = GRP_EXT ;
+        {if (ptrFile->opt.Qcnt == 0) printf ("Basic, Extended\n") ;
+         if ( ptrFile->pcgrp_id != GRP_E ) ptrFile->pcgrp_id = GRP_EXT ;
         }
     else if (code == IDENT_EXT_PAS)
-        {if (Qcnt == 0) printf ("Basic with password, Extended\n") ; pcgrpId = GRP_EXT ;}
+        {if (ptrFile->opt.Qcnt == 0) printf ("Basic with password, Extended\n") ; ptrFile->pcgrp_id = GRP_EXT ;}
     else if (code == IDENT_NEW_DAT)
-        {if (Qcnt == 0) printf ("Data, New\n") ; pcgrpId = GRP_NEW ;}
+        {if (ptrFile->opt.Qcnt == 0) printf ("Data, New\n") ; ptrFile->pcgrp_id = GRP_NEW ;}
     else if (code == IDENT_OLD_DAT)
-        {if (Qcnt == 0) printf ("Data, Old\n") ; pcgrpId = GRP_OLD ;}
+        {if (ptrFile->opt.Qcnt == 0) printf ("Data, Old\n") ; ptrFile->pcgrp_id = GRP_OLD ;}
     else if (code == IDENT_NEW_BIN)
-        {if (Qcnt == 0) printf ("Binary, New\n") ; pcgrpId = GRP_NEW ;}
+        {if (ptrFile->opt.Qcnt == 0) printf ("Binary, New\n") ; ptrFile->pcgrp_id = GRP_NEW ;}
     else if (code == IDENT_OLD_BAS)
-        {if (Qcnt == 0) printf ("Basic, Old\n") ; pcgrpId = GRP_OLD ;}
+        {if (ptrFile->opt.Qcnt == 0) printf ("Basic, Old\n") ; ptrFile->pcgrp_id = GRP_OLD ;}
     else if (code == IDENT_OLD_PAS)
-        {if (Qcnt == 0) printf ("Basic with password, Old\n") ; pcgrpId = GRP_OLD ;}
+        {if (ptrFile->opt.Qcnt == 0) printf ("Basic with password, Old\n") ; ptrFile->pcgrp_id = GRP_OLD ;}
     else if (code == IDENT_OLD_BIN)
-        {if (Qcnt == 0) printf ("Binary, Old\n") ; pcgrpId = GRP_OLD ;}
+        {if (ptrFile->opt.Qcnt == 0) printf ("Binary, Old\n") ; ptrFile->pcgrp_id = GRP_OLD ;}
     else if (code == IDENT_E_BAS)
-        {if (Qcnt == 0) printf ("Basic Image, PC-E/G/16\n") ; if ( pcgrpId != GRP_G && pcgrpId != GRP_16 ) pcgrpId = GRP_E ;
-         if (pcgrpId != GRP_16) ll_Img = 255 ;
+        {if (ptrFile->opt.Qcnt == 0) printf ("Basic Image, PC-E/G/16\n") ; if ( ptrFile->pcgrp_id != GRP_G && ptrFile->pcgrp_id != GRP_16 ) ptrFile->pcgrp_id = GRP_E ;
+         if (ptrFile->pcgrp_id != GRP_16) ptrFile->ll_img = 255 ;
         }
     else if (code == IDENT_E_BIN)
-        {if (Qcnt == 0) printf ("Binary, PC-E/G/16\n") ;  if ( pcgrpId != GRP_G && pcgrpId != GRP_16 ) pcgrpId = GRP_E ;
+        {if (ptrFile->opt.Qcnt == 0) printf ("Binary, PC-E/G/16\n") ;  if ( ptrFile->pcgrp_id != GRP_G && ptrFile->pcgrp_id != GRP_16 ) ptrFile->pcgrp_id = GRP_E ;
         }
     else if (code == IDENT_E_ASC)
-        {if (Qcnt == 0) printf ("ASCII data or source file, PC-E/G/16\n") ;
-         if ( pcgrpId != GRP_G && pcgrpId != GRP_16 ) pcgrpId = GRP_E ;
+        {if (ptrFile->opt.Qcnt == 0) printf ("ASCII data or source file, PC-E/G/16\n") ;
+         if ( ptrFile->pcgrp_id != GRP_G && ptrFile->pcgrp_id != GRP_16 ) ptrFile->pcgrp_id = GRP_E ;
         }
     else if (code == IDENT_PC16_CAS &&
-             ptrFile->base_freq == Base_FREQ3 && Base_FREQ3 > 0)
-        {if (Qcnt == 0) printf ("ASCII data from PRINT# or IMG from SAVE CAS: PC-1600\n") ;
-         pcgrpId = GRP_16 ;
+             ptrFile->base_freq == ptrFile->base_freq3 && ptrFile->base_freq3 > 0)
+        {if (ptrFile->opt.Qcnt == 0) printf ("ASCII data from PRINT# or IMG from SAVE CAS: PC-1600\n") ;
+         ptrFile->pcgrp_id = GRP_16 ;
         }
     else if (code == IDENT_PC16_DAT)
         {
-        if (Qcnt == 0) printf ("Binary DATA format of PC-1600, (PC-1500 compatible)\n") ;
-         pcgrpId = GRP_16 ;
+        if (ptrFile->opt.Qcnt == 0) printf ("Binary DATA format of PC-1600, (PC-1500 compatible)\n") ;
+         ptrFile->pcgrp_id = GRP_16 ;
         }
     else {
         printf ("Unknown!\n") ;
@@ -4036,13 +3940,13 @@ int ReadSaveIdFromWav (FileInfo* ptrFile,
 
     do {
         ptrFile->ident = IDENT_UNKNOWN ;
-        if (ptrFile->base_freq == Base_FREQ2 && Base_FREQ2 > 0) {
+        if (ptrFile->base_freq == ptrFile->base_freq2 && ptrFile->base_freq2 > 0) {
             /* Ident for 2500 Hz, 4 bits */
             error = ReadQuaterFromWav (&code, &nbStopBits, ptrFile) ;
             if (error != ERR_OK) break ;
 
             if (ptrFile->writing == true) { /* RAW and TAP format, SHC-format unknown */
-                error = WriteQuaterToTap (code, ptrFd) ; /* tap format */
+                error = WriteQuaterToTap (code, ptrFd, ptrFile) ; /* tap format */
                 if (error != ERR_OK) break ;
                 ++ ptrFile->total ;
             }
@@ -4056,13 +3960,13 @@ int ReadSaveIdFromWav (FileInfo* ptrFile,
 
                     error = ReadByteSumFromWav (ORDER_INV, &tmpL, ptrFile); /* 0x10...0x17 */
                     if ((int)tmpL != ii ) {
-                            printf("\n%s: Error in file header, position %i := %lu\n", argP, ii - 15, tmpL) ;
+                            printf("\n%s: Error in file header, position %i := %lu\n", ptrFile->opt.argP, ii - 15, tmpL) ;
                             count_errors( ERR_SUM, ptrFile) ;
                     }
                     if (error != ERR_OK) break ;
 
                     if (ptrFile->writing == true) { /* RAW format */
-                        error = WriteByteToFile (tmpL, ptrFd) ;
+                        error = WriteByteToFile (tmpL, ptrFd, ptrFile) ;
                         if (error != ERR_OK) break ;
                     }
                 }
@@ -4072,7 +3976,7 @@ int ReadSaveIdFromWav (FileInfo* ptrFile,
                 if (error != ERR_OK) break ;
 
                 if (ptrFile->writing == true) { /* RAW format */
-                    error = WriteByteToFile (tmpL, ptrFd) ;
+                    error = WriteByteToFile (tmpL, ptrFd, ptrFile) ;
                     if (error != ERR_OK) break ;
                 }
 
@@ -4081,7 +3985,7 @@ int ReadSaveIdFromWav (FileInfo* ptrFile,
             else break ;
         }
 
-        else if (ptrFile->base_freq == Base_FREQ1 && Base_FREQ1 > 0) {
+        else if (ptrFile->base_freq == ptrFile->base_freq1 && ptrFile->base_freq1 > 0) {
             /* Ident for 4000 Hz, 8 bits */
             error = ReadQuaterFromWav (&code, &nbStopBits, ptrFile) ;
             if (error != ERR_OK || !( code == 7 || code == 2 || code == 8 )) break ;
@@ -4091,7 +3995,7 @@ int ReadSaveIdFromWav (FileInfo* ptrFile,
 
             code = (code << 4) + codeLow ;
         }
-        else if (ptrFile->base_freq == Base_FREQ3 && Base_FREQ3 > 0) {
+        else if (ptrFile->base_freq == ptrFile->base_freq3 && ptrFile->base_freq3 > 0) {
 
             ptrFile->sum = 0 ;
             ptrFile->block_len = BLK_E_HEAD ;
@@ -4112,6 +4016,29 @@ int ReadSaveIdFromWav (FileInfo* ptrFile,
 }
 
 
+/* Check, if the ident read at the current base frequency is one of the PC group sending with it */
+bool IsIdentOfFreq (FileInfo* ptrFile)
+{
+    ulong code = ptrFile->ident ;
+
+    if (ptrFile->base_freq == ptrFile->base_freq2 && ptrFile->base_freq2 > 0)
+        return ( code == IDENT_PC15_BAS || code == IDENT_PC15_BIN ||
+                 code == IDENT_PC15_RSV || code == IDENT_PC15_DAT ) ;
+
+    if (ptrFile->base_freq == ptrFile->base_freq3 && ptrFile->base_freq3 > 0)
+        return ( code == IDENT_E_BAS    || code == IDENT_E_BIN    ||
+                 code == IDENT_E_ASC    || code == IDENT_PC16_CAS ||
+                 code == IDENT_PC16_DAT ) ;
+
+    return ( code == IDENT_PC1211  || code == IDENT_PC121_DAT ||
+             code == IDENT_OLD_BAS || code == IDENT_OLD_PAS   ||
+             code == IDENT_OLD_DAT || code == IDENT_OLD_BIN   ||
+             code == IDENT_NEW_BAS || code == IDENT_NEW_PAS   ||
+             code == IDENT_EXT_BAS || code == IDENT_EXT_PAS   ||
+             code == IDENT_NEW_DAT || code == IDENT_NEW_BIN ) ;
+}
+
+
 int ReadSaveIdFromTap (FileInfo* ptrFile,
                           FILE** ptrFd)
 {
@@ -4126,11 +4053,11 @@ int ReadSaveIdFromTap (FileInfo* ptrFile,
         if (error != ERR_OK) break ;
                                             /* force Id also with false -p*/
         if((code & 0x0F) == IDENT_PC1500)   /* Ident for 2500 Hz, 4 bits */
-            ptrFile->base_freq = Base_FREQ2 = BASE_FREQ2 ;
+            ptrFile->base_freq = ptrFile->base_freq2 = BASE_FREQ2 ;
         else if(code < IDENT_PC1500)        /* Ident for 3000 Hz, 8 bits */
-            ptrFile->base_freq = Base_FREQ3 = BASE_FREQ3 ;
+            ptrFile->base_freq = ptrFile->base_freq3 = BASE_FREQ3 ;
         else {                              /* Ident for 4000 Hz, 8 bits */
-            ptrFile->base_freq = Base_FREQ1 = BASE_FREQ1 ;
+            ptrFile->base_freq = ptrFile->base_freq1 = BASE_FREQ1 ;
             codeH = (code >> 4) & 0x0F ;
             if ( codeH != 7 && codeH != 2 && codeH != 8 ) return (ERR_FMT) ;
             ptrFile->ident = code ;
@@ -4139,7 +4066,7 @@ int ReadSaveIdFromTap (FileInfo* ptrFile,
 
             error = fseek (ptrFile->ptrFd, -1, SEEK_CUR) ;
             if (error != ERR_OK) {
-                printf ("\n%s:rId - Can't seek the file\n", argP) ;
+                printf ("\n%s:rId - Can't seek the file\n", ptrFile->opt.argP) ;
                 error = ERR_FILE ;
                 break ;
             }
@@ -4182,7 +4109,7 @@ int ReadSaveNameOrPassFromWav (char*  ptrName,
             for ( ii = 25 ; ii < 34 ; ++ii ) {
                 error = ReadByteSumFromWav (ORDER_INV, &byte, ptrFile);
                 if ((int)byte > 0 ) {
-                        printf("\n%s: Unexpected byte %lu in file name header, position %i\n", argP, byte, ii + 1) ;
+                        printf("\n%s: Unexpected byte %lu in file name header, position %i\n", ptrFile->opt.argP, byte, ii + 1) ;
                         count_errors( ERR_FMT, ptrFile) ;
                 }
                 if (error != ERR_OK) break ;
@@ -4228,7 +4155,7 @@ int ReadSaveNameOrPassFromWav (char*  ptrName,
                     if (ii >= 0x0E)
                          strcat (ptrName, CodeE437[byte]) ;
                     else {
-                        printf("\n%s: Unexpected byte %lu in file name header, position %i\n", argP, byte, ii + 1) ;
+                        printf("\n%s: Unexpected byte %lu in file name header, position %i\n", ptrFile->opt.argP, byte, ii + 1) ;
                         count_errors( ERR_FMT, ptrFile) ;
                     }
                 }
@@ -4240,7 +4167,7 @@ int ReadSaveNameOrPassFromWav (char*  ptrName,
 
             error = ReadByteSumFromWav (ORDER_E, &byte, ptrFile);
                 if ( !( (int)byte == 0x0D || ((int)byte == 0x00 && (ident == IDENT_PC16_CAS || ident == IDENT_E_ASC)) )) {
-                        printf("\n%s: Unexpected byte %lu in file name header, position %i\n", argP, byte, ii + 1) ;
+                        printf("\n%s: Unexpected byte %lu in file name header, position %i\n", ptrFile->opt.argP, byte, ii + 1) ;
                         count_errors( ERR_FMT, ptrFile) ;
                 }
 
@@ -4254,7 +4181,7 @@ int ReadSaveNameOrPassFromWav (char*  ptrName,
             for ( ii = 0 ; ii < 8 ; ++ii ) { /* +1 byte checksum */
                 error = ReadByteSumFromWav (ORDER_INV, &byte, ptrFile);
                 if (ptrFile->writing == true) { /* SHC format */
-                    error = WriteByteToDatFile (byte, ptrFd) ;
+                    error = WriteByteToDatFile (byte, ptrFd, ptrFile) ;
                     if (error != ERR_OK) break ;
                 }
 
@@ -4282,14 +4209,14 @@ int ReadSaveNameOrPassFromWav (char*  ptrName,
                         break ;
 
                     default :
-                        printf ("\n%s:RName: Unknown Ident\n", argP) ;
+                        printf ("\n%s:RName: Unknown Ident\n", ptrFile->opt.argP) ;
                         error = ERR_FMT ;
                         break ;
                     } // end switch default
                 }
             }
             if ((int)byte != 0xF5 || ii < 7 ) {
-                    printf("\n%s: Unexpected byte %lu in file name header, position %i\n", argP, byte, ii + 1 ) ;
+                    printf("\n%s: Unexpected byte %lu in file name header, position %i\n", ptrFile->opt.argP, byte, ii + 1 ) ;
                     count_errors( ERR_FMT, ptrFile) ;
             }
             if (error != ERR_OK) break ;
@@ -4332,9 +4259,9 @@ int ReadHeadFromEWav (ulong*  ptrSize,
             for ( ii = 0x19 ; ii < 0x1D ; ++ii ) { /* Date+Time PC-1600: Mon Day Hour Min */
                 error = ReadByteSumFromWav (ORDER_E, &byte, ptrFile);
                 if ((int)byte != 0x00 ) {
-                    if (pcgrpId != GRP_16 ) {
-                        pcgrpId  = GRP_16 ;
-                        if (Qcnt ==0) printf("\n%s: PC-1600 detected\n", argP) ;
+                    if (ptrFile->pcgrp_id != GRP_16 ) {
+                        ptrFile->pcgrp_id  = GRP_16 ;
+                        if (ptrFile->opt.Qcnt ==0) printf("\n%s: PC-1600 detected\n", ptrFile->opt.argP) ;
                     }
                 }
                 if (error != ERR_OK) break ;
@@ -4344,20 +4271,20 @@ int ReadHeadFromEWav (ulong*  ptrSize,
             /* Mode 2 */
             if (ptrFile->ident == IDENT_E_BAS) {
                     if (tmpL[6] == 0x02) {
-                        if (Qcnt ==0) printf(" ReSerVe data from 1600-Series, mode 2 ID %lu \n", tmpL[6]) ; // 0x2
+                        if (ptrFile->opt.Qcnt ==0) printf(" ReSerVe data from 1600-Series, mode 2 ID %lu \n", tmpL[6]) ; // 0x2
                         ident = IDENT_PC16_RSV ;
-                        pcgrpId = GRP_16 ;
+                        ptrFile->pcgrp_id = GRP_16 ;
                         ptrFile->type = TYPE_RSV ;
                     }
                     else { //if (tmpL[6] == 0x01)
-                        if (Qcnt ==0 && ptrFile->debug != 0)
+                        if (ptrFile->opt.Qcnt ==0 && ptrFile->debug != 0)
                                      printf(" BASIC image from E/G/1600-Series, mode 2 ID %lu\n", tmpL[6]) ; //0x1
                     }
             }
 
             /* PC-1600 Mode 2 (PC-1500) file format */
             if ((ptrFile->ident == IDENT_E_ASC || ptrFile->ident == IDENT_PC16_CAS)
-                && Qcnt==0 && ptrFile->debug != 0) {
+                && ptrFile->opt.Qcnt==0 && ptrFile->debug != 0) {
                     if (tmpL[6] > 0 ) printf(" Data mode 2 ID %lu from E/G-Series\n", tmpL[6]) ; // E:0x4 G-BAS:0x01
                     else printf(" Ascii Data or source file from G/1600-Series\n") ;
             }
@@ -4379,7 +4306,7 @@ int ReadHeadFromEWav (ulong*  ptrSize,
             for ( ii = 0x20 ; ii < BLK_E_HEAD ; ++ii ) { /* 16 bytes */
                 error = ReadByteSumFromWav (ORDER_E, &byte, ptrFile);
                 if ((int)byte != 0x00 ) {
-                        printf("\n%s: Unexpected byte %lu in file name header, position %i\n", argP, byte, ii + 1) ;
+                        printf("\n%s: Unexpected byte %lu in file name header, position %i\n", ptrFile->opt.argP, byte, ii + 1) ;
                         count_errors( ERR_FMT, ptrFile) ;
                 }
                 if (error != ERR_OK) break ;
@@ -4400,9 +4327,9 @@ int ReadHeadFromEWav (ulong*  ptrSize,
                  ptrFile->ident == IDENT_PC16_BAS ||
                  ptrFile->ident == IDENT_PC16_CAS ) { /* check if PRINT# CAS: data or SAVE CAS: binary image */
 
-                position = ftell( ptrFile->ptrFd ) ; /* position after start bit of block */
-                if (position <= 0) {
-                    printf ("\n%s:rHeadBin - Can't ftell the wave file\n", argP) ;
+                position = WavTell (ptrFile) ; /* position after start bit of block */
+                if (position < 0) {
+                    printf ("\n%s:rHeadBin - Can't ftell the wave file\n", ptrFile->opt.argP) ;
                     error = ERR_FILE ;
                     break ;
                 }
@@ -4412,31 +4339,31 @@ int ReadHeadFromEWav (ulong*  ptrSize,
 
                 if (ptrFile->ident == IDENT_PC16_CAS) {
                     if ((int)byte == 0xFF ) {
-                        if (Qcnt ==0) printf("\n%s: PC-1600 SAVE CAS: image detected, IMG will be written\n", argP) ;
-                        if (Qcnt ==0) printf  ("%s: Better to use ASCII mode of SAVE CAS: with ',A' or CSAVE\n", argP) ;
+                        if (ptrFile->opt.Qcnt ==0) printf("\n%s: PC-1600 SAVE CAS: image detected, IMG will be written\n", ptrFile->opt.argP) ;
+                        if (ptrFile->opt.Qcnt ==0) printf  ("%s: Better to use ASCII mode of SAVE CAS: with ',A' or CSAVE\n", ptrFile->opt.argP) ;
                         ident = IDENT_PC16_IMG ;
                     }
-                    else if ((int)byte != 0xFF && pcgrpId == GRP_16 ) {
-                        if (Qcnt ==0) printf("\n%s: PC-1600 PRINT # CAS: detected\n", argP) ;
+                    else if ((int)byte != 0xFF && ptrFile->pcgrp_id == GRP_16 ) {
+                        if (ptrFile->opt.Qcnt ==0) printf("\n%s: PC-1600 PRINT # CAS: detected\n", ptrFile->opt.argP) ;
                     }
                 }
-                else if ((int)byte != 0xFF && pcgrpId != GRP_16 ) {
-                        pcgrpId = GRP_16 ;
-                        if (Qcnt ==0) printf("\n%s: PC-1600 detected\n", argP) ;
+                else if ((int)byte != 0xFF && ptrFile->pcgrp_id != GRP_16 ) {
+                        ptrFile->pcgrp_id = GRP_16 ;
+                        if (ptrFile->opt.Qcnt ==0) printf("\n%s: PC-1600 detected\n", ptrFile->opt.argP) ;
                 }
-                else if ((int)byte == 0xFF && pcgrpId == GRP_16 ) {
-                        pcgrpId = GRP_E ;
-                        if (Qcnt ==0) printf("\n%s: PC-E/G detected - check parameter\n", argP) ;
+                else if ((int)byte == 0xFF && ptrFile->pcgrp_id == GRP_16 ) {
+                        ptrFile->pcgrp_id = GRP_E ;
+                        if (ptrFile->opt.Qcnt ==0) printf("\n%s: PC-E/G detected - check parameter\n", ptrFile->opt.argP) ;
                 }
                 /* Rewind to the beginning of the block data */
-                error = fseek (ptrFile->ptrFd, position, SEEK_SET) ;
+                error = WavSeek (ptrFile, position) ;
                     if (error != ERR_OK) {
-                        printf ("\n%s:rHeadBin - Can't seek the wave file\n", argP) ;
+                        printf ("\n%s:rHeadBin - Can't seek the wave file\n", ptrFile->opt.argP) ;
                         error = ERR_FILE ;
                         break ;
                     }
             }
-            if (pcgrpId == GRP_16 && ident != IDENT_PC16_IMG) {
+            if (ptrFile->pcgrp_id == GRP_16 && ident != IDENT_PC16_IMG) {
                 if (ident == IDENT_E_BAS) ident = IDENT_PC16_BAS ;
             }
             else if (ptrFile->ident == IDENT_E_BAS || ident == IDENT_PC16_IMG ) {
@@ -4445,7 +4372,7 @@ int ReadHeadFromEWav (ulong*  ptrSize,
 
                 error = ReadByteSumFromWav (ORDER_E, &byte, ptrFile);
                 if ((int)byte != 0xFF ) {
-                        printf("\n%s: Unexpected byte %lu in 2. file header, position %i\n", argP, byte, 1) ;
+                        printf("\n%s: Unexpected byte %lu in 2. file header, position %i\n", ptrFile->opt.argP, byte, 1) ;
                         count_errors( ERR_FMT, ptrFile) ;
                 }
                 if (error != ERR_OK) break ;
@@ -4456,30 +4383,30 @@ int ReadHeadFromEWav (ulong*  ptrSize,
                 }
                 if (error != ERR_OK) break ;
 
-                if ((int) tmpL[0] == 16 && pcgrpId == GRP_16 ) {
-                    pcgrpId = GRP_16 ;
-                    if (Qcnt == 0) printf("%s: PC-1600 Image from SAVE CAS: detected\n", argP) ;
+                if ((int) tmpL[0] == 16 && ptrFile->pcgrp_id == GRP_16 ) {
+                    ptrFile->pcgrp_id = GRP_16 ;
+                    if (ptrFile->opt.Qcnt == 0) printf("%s: PC-1600 Image from SAVE CAS: detected\n", ptrFile->opt.argP) ;
                 }
-                if ((int) tmpL[1] == 3 && pcgrpId == GRP_E ) {
-                    pcgrpId = GRP_G ;
-                    if (Qcnt == 0) printf("%s: PC group G detected\n", argP) ;
+                if ((int) tmpL[1] == 3 && ptrFile->pcgrp_id == GRP_E ) {
+                    ptrFile->pcgrp_id = GRP_G ;
+                    if (ptrFile->opt.Qcnt == 0) printf("%s: PC group G detected\n", ptrFile->opt.argP) ;
                 }
-                else if ((int) tmpL[1] == 0 && pcgrpId == GRP_G ) {
-                    pcgrpId = GRP_E ;
-                    if (Qcnt == 0) printf("\n%s: PC group E500 detected - check parameter\n", argP) ;
+                else if ((int) tmpL[1] == 0 && ptrFile->pcgrp_id == GRP_G ) {
+                    ptrFile->pcgrp_id = GRP_E ;
+                    if (ptrFile->opt.Qcnt == 0) printf("\n%s: PC group E500 detected - check parameter\n", ptrFile->opt.argP) ;
                 }
                 else if ((int) tmpL[1] == 8 ) {
-                    if (Qcnt == 0) printf("\n%s: BASIC Image from Text Modus of E-Series\n", argP) ;
+                    if (ptrFile->opt.Qcnt == 0) printf("\n%s: BASIC Image from Text Modus of E-Series\n", ptrFile->opt.argP) ;
                 }
 
-                if (pcgrpId == GRP_E) {
+                if (ptrFile->pcgrp_id == GRP_E) {
                     for ( ii = 3 ; ii < 9 ; ++ii ) {
                         error = ReadByteSumFromWav (ORDER_E, &tmpL[ii], ptrFile);
                         if (error != ERR_OK) break ;
                     }
                     if (error != ERR_OK) break ;
                     if ((int) tmpL[3] != '4' ) {
-                        printf("\n%s: Unexpected byte %lu in 2. file header, position %i\n", argP, tmpL[3], 5 ) ;
+                        printf("\n%s: Unexpected byte %lu in 2. file header, position %i\n", ptrFile->opt.argP, tmpL[3], 5 ) ;
                         count_errors( ERR_FMT, ptrFile) ;
                     }
 
@@ -4488,7 +4415,7 @@ int ReadHeadFromEWav (ulong*  ptrSize,
                     haddr = (haddr << 8) + tmpL[6] ;
 
                 }
-                if (pcgrpId == GRP_16) {
+                if (ptrFile->pcgrp_id == GRP_16) {
                     for ( ii = 6 ; ii < 9 ; ++ii ) {
                         error = ReadByteSumFromWav (ORDER_E, &tmpL[ii], ptrFile);
                         if (error != ERR_OK) break ;
@@ -4500,7 +4427,7 @@ int ReadHeadFromEWav (ulong*  ptrSize,
                     haddr = (haddr << 8) + tmpL[6] ;
 
                 }
-                /* else { // if (pcgrpId == GRP_G)
+                /* else { // if (ptrFile->pcgrp_id == GRP_G)
                 } */
                 for ( ii = 0 ; ii < 8 ; ++ii ) {
                     error = ReadByteSumFromWav (ORDER_E, &byte, ptrFile);
@@ -4512,20 +4439,20 @@ int ReadHeadFromEWav (ulong*  ptrSize,
                 }
                 if (error != ERR_OK) break ;
 
-                if (Qcnt == 0 && tmpS[0] != 0) printf ("Password      : %s\n", tmpS) ;
+                if (ptrFile->opt.Qcnt == 0 && tmpS[0] != 0) printf ("Password      : %s\n", tmpS) ;
 
-                if (pcgrpId == GRP_E) {
+                if (ptrFile->pcgrp_id == GRP_E) {
                     error = ReadByteSumFromWav (ORDER_E, &byte, ptrFile);
                     if ((int)byte != 0x0D ) {
-                        printf("\n%s: Unexpected byte %lu in 2. file header, position %i\n", argP, byte, ii + 11) ;
+                        printf("\n%s: Unexpected byte %lu in 2. file header, position %i\n", ptrFile->opt.argP, byte, ii + 11) ;
                         count_errors( ERR_FMT, ptrFile) ;
                     }
                     if (error != ERR_OK) break ;
                 }
-                else if (pcgrpId == GRP_16) {
+                else if (ptrFile->pcgrp_id == GRP_16) {
                     error = ReadByteSumFromWav (ORDER_E, &byte, ptrFile);
                     if ((int)byte != 0x0F ) {
-                        printf("\n%s: Unexpected byte %lu in 2. file header, position %i\n", argP, byte, ii + 8) ;
+                        printf("\n%s: Unexpected byte %lu in 2. file header, position %i\n", ptrFile->opt.argP, byte, ii + 8) ;
                         count_errors( ERR_FMT, ptrFile) ;
                     }
                     if (error != ERR_OK) break ;
@@ -4534,7 +4461,7 @@ int ReadHeadFromEWav (ulong*  ptrSize,
 
             if ( ptrFile->ident != IDENT_E_ASC && ptrFile->ident != IDENT_PC16_CAS) {
 
-                if (Qcnt == 0) {
+                if (ptrFile->opt.Qcnt == 0) {
                     if (ptrFile->ident == IDENT_E_BIN ) {
                         if (eaddr != 0xFFFFFF) printf (" Entry address : 0x%06X\n", (uint) eaddr);
                         printf (" Image start address : 0x%06X\n", (uint) addr);
@@ -4584,13 +4511,13 @@ int ReadHeadFrom15Wav (ulong*  ptrSize,
 
         if ( ptrFile->ident == IDENT_PC15_BIN || ptrFile->ident == IDENT_PC15_RSV ) {
             ++length ;                  /* not for IDENT_PC15_BAS (IDENT_PC15_DAT) */
-            if (Qcnt == 0) {
+            if (ptrFile->opt.Qcnt == 0) {
                 printf (" Start address : 0x%04X\n", (uint) addr);
                 printf (" End   address : 0x%04X, Binary image size : %lu bytes\n", (uint) (addr + length - 1), length);
                 if (eaddr != 0xFFFF) printf (" Entry address : 0x%04X\n", (uint) eaddr);
             }
         }
-        else if (ptrFile->ident == IDENT_PC15_BAS && Qcnt == 0)
+        else if (ptrFile->ident == IDENT_PC15_BAS && ptrFile->opt.Qcnt == 0)
                 printf (" BASIC image size : %lu bytes with an end mark.\n", length + 1);
         *ptrSize = length ;
 
@@ -4618,7 +4545,7 @@ int ReadHeadFromBinWav (ulong*  ptrSize,
             error = ReadByteSumFromWav (ORDER_INV, &tmpL[ii], ptrFile);
             if (error != ERR_OK) break ;
             if (ptrFile->writing == true) { /* SHC format */
-                error = WriteByteToDatFile (tmpL[ii], ptrFd) ;
+                error = WriteByteToDatFile (tmpL[ii], ptrFd, ptrFile) ;
                 if (error != ERR_OK) break ;
             }
         }
@@ -4633,7 +4560,7 @@ int ReadHeadFromBinWav (ulong*  ptrSize,
         /* Checksum read by ReadByteSum automatically */
         ++length ;
 
-        if (Qcnt == 0) {
+        if (ptrFile->opt.Qcnt == 0) {
                 printf (" Start address : 0x%04X\n", (uint) addr);
                 printf (" End   address : 0x%04X, Binary image size : %lu bytes\n", (uint) (addr + length - 1), length);
         }
@@ -4790,7 +4717,8 @@ int ConvertByteToBas (char*  ptrText,
                       ulong  byte,
                       ulong  graph,
                       ulong  CodeId,
-                       bool  instring)
+                       bool  instring,
+                  FileInfo*  ptrFile)
 {
     ulong  tmp ;
     char  tmpC[10] ;
@@ -4818,7 +4746,7 @@ int ConvertByteToBas (char*  ptrText,
         if (  tmp > 0x1F && tmp < 0x80 )
             strncat (ptrText, ptrCode, maxlen) ;
 
-        else if ( pcgrpId == GRP_E || pcgrpId == GRP_G || pcId == 1600 ) { // No conversion
+        else if ( ptrFile->pcgrp_id == GRP_E || ptrFile->pcgrp_id == GRP_G || ptrFile->opt.pcId == 1600 ) { // No conversion
             tmpC[0] = byte ;
             tmpC[1] = 0 ;
             strncat (ptrText, tmpC, maxlen) ;
@@ -4954,11 +4882,6 @@ int ReadLineFromBasWav (ulong  order,
                        ulong*  ptrLen,
                     FileInfo*  ptrFile)
 {
- static ulong StoredByte = UNREAD ;
- static ulong LastLineNb = 0 ;
- static bool  LastLineEot = false ;
- static bool  WarnPC156M1 = true ;
-
      uint  ii ;
     ulong  byte ;
     ulong  byte2, byte3 ;
@@ -4978,14 +4901,14 @@ int ReadLineFromBasWav (ulong  order,
     char** CodeC = CodeNew ;
     char** CodeT = CodeExt ;
     /* Switch code tab between extended new BASIC and PC-E series */
-    if ( pcgrpId == GRP_E || pcgrpId == GRP_G) {
-        if (ptrFile->count == 0) return (ERR_EOT); // && pcgrpId == GRP_G
+    if ( ptrFile->pcgrp_id == GRP_E || ptrFile->pcgrp_id == GRP_G) {
+        if (ptrFile->count == 0) return (ERR_EOT); // && ptrFile->pcgrp_id == GRP_G
         CodeC = CodeE437 ;
         CodeT = CodeE2 ;
     }
-    if ( pcId == 1600 && ptrFile->ident == IDENT_PC15_BAS) ident = IDENT_PC16_BAS ; /* switch token tab and line model */
+    if ( ptrFile->opt.pcId == 1600 && ptrFile->ident == IDENT_PC15_BAS) ident = IDENT_PC16_BAS ; /* switch token tab and line model */
 
-    if ( pcgrpId == GRP_16 ) {
+    if ( ptrFile->pcgrp_id == GRP_16 ) {
         if (ptrFile->count == 0 && ptrFile->total != 0 ) return (ERR_EOT);
     }
 
@@ -4998,15 +4921,15 @@ int ReadLineFromBasWav (ulong  order,
              (ptrFile->ident == IDENT_OLD_PAS) ) ptrFile->status = STAT_EOT ; /* possible EOF */
 
         ptrFile->check_end = false ; /* no end of file mark should follow the next byte instead a possible sum */
-        if (LastLineEot) {
+        if (ptrFile->last_line_eot) {
             /* seldom: first BAS_NEW_EOF mark was read at the end of last line instead of a checksum */
             byte = BAS_NEW_EOF ;
             CheckSum (order, &byte, ptrFile) ;
-            LastLineEot = false ;
+            ptrFile->last_line_eot = false ;
         }
-        else if (StoredByte != UNREAD) { /* used for the byte read after a merge mark */
-            byte = StoredByte ;
-            StoredByte = UNREAD ;
+        else if (ptrFile->stored_byte != UNREAD) { /* used for the byte read after a merge mark */
+            byte = ptrFile->stored_byte ;
+            ptrFile->stored_byte = UNREAD ;
         }
         else /* read first byte of line */
             error = ReadByteSumFromWav (order, &byte, ptrFile);
@@ -5033,7 +4956,7 @@ int ReadLineFromBasWav (ulong  order,
                       size - 1 < ptrFile->total ) {    /* EOF or MERGE?,-1 because of check for double EOF */
                   if (ptrFile->count % BLK_OLD > 0) {  /* Last checksum has not read by ReadByteSum before */
 
-                    if ( ( (ptrFile->debug & 0x0040) > 0 ) && (Qcnt == 0) ) printf(" EOF:(");
+                    if ( ( (ptrFile->debug & 0x0040) > 0 ) && (ptrFile->opt.Qcnt == 0) ) printf(" EOF:(");
 
                     ptrFile->writing = false ;
                     error = ReadByteTraceFromWav (order, &sumH, ptrFile);
@@ -5053,7 +4976,7 @@ int ReadLineFromBasWav (ulong  order,
                         /* Images with double EOF survive editing in the PC-1500 until the next NEW */
                         ptrFile->sum += sumH ;
                         ++ ptrFile->wrn_cnt ;
-                        if (Qcnt == 0) printf ("\nDouble end of file found, maybe Bas2img used before\n" );
+                        if (ptrFile->opt.Qcnt == 0) printf ("\nDouble end of file found, maybe Bas2img used before\n" );
 
                             error = ReadByteFromWav (order, &sumH, ptrFile);
                             if (error != ERR_OK ) {
@@ -5065,7 +4988,7 @@ int ReadLineFromBasWav (ulong  order,
                                 break ;
                             }
                             else error = ERR_EOT ;
-                            if ( ( (ptrFile->debug & 0x0040) > 0 ) && (Qcnt == 0) )
+                            if ( ( (ptrFile->debug & 0x0040) > 0 ) && (ptrFile->opt.Qcnt == 0) )
                                     printf("%02X", (uint) sumH ) ;
                     }
 
@@ -5078,9 +5001,9 @@ int ReadLineFromBasWav (ulong  order,
                     if (sum != ptrFile->sum) {
                         if ((ptrFile->debug & IGN_ERR_SUM) == 0 ) error = ERR_SUM ;
                         else count_errors( ERR_SUM, ptrFile) ;
-                        if (Qcnt == 0) printf(" ERROR %d found: %ld\n", ERR_SUM, ptrFile->total ) ;
+                        if (ptrFile->opt.Qcnt == 0) printf(" ERROR %d found: %ld\n", ERR_SUM, ptrFile->total ) ;
                     }
-                    if ( ( (ptrFile->debug & 0x0040) > 0 ) && (Qcnt == 0) )
+                    if ( ( (ptrFile->debug & 0x0040) > 0 ) && (ptrFile->opt.Qcnt == 0) )
                         printf("%02X=%04X)", (uint) sum & 0xFF, (uint) ptrFile->sum);
 
                     if (error <= ERR_OK ) error = ERR_EOT ;
@@ -5089,20 +5012,20 @@ int ReadLineFromBasWav (ulong  order,
                 }
                 else if ( ptrFile->ident != IDENT_E_BAS && ptrFile->count != 0 ) {
                     /* In IDENT_15_BAS, IDENT_PC16_BAS between merged programs is an EOF mark */
-                    LastLineNb = 0 ;
+                    ptrFile->last_line_nb = 0 ;
                     if (ptrFile->type == TYPE_IMG ) {
                         if (strlen (ptrText) < (cLL - 1)) ptrText[length++] = (char) byte ;
                         else error = ERR_MEM ;
                     }
                     else {
                         tmpL = MERGE_MARK ;
-                        if ( linewidth > 5 )
-                             sprintf(ptrText, "%*ld ", (int) linewidth, tmpL);
+                        if ( ptrFile->opt.linewidth > 5 )
+                             sprintf(ptrText, "%*ld ", (int) ptrFile->opt.linewidth, tmpL);
                         else sprintf(ptrText, "%ld ", tmpL);
 
                         if (strlen (ptrText) < (cLL - 2)) (void) strncat (ptrText, "\r\n", 2) ;
                         else error = ERR_MEM ;
-                        if ( ( (ptrFile->debug & 0x0080) > 0 ) && (Qcnt == 0) ) printf(" %s", ptrText);
+                        if ( ( (ptrFile->debug & 0x0080) > 0 ) && (ptrFile->opt.Qcnt == 0) ) printf(" %s", ptrText);
                     }
                     *ptrLen  = length ;
                     break;  /* next line */
@@ -5134,28 +5057,28 @@ int ReadLineFromBasWav (ulong  order,
                 if (sum != ptrFile->sum_before) {
                     if ((ptrFile->debug & IGN_ERR_SUM) == 0 ) error = ERR_SUM ;
                     else count_errors( ERR_SUM, ptrFile) ;
-                    if (Qcnt == 0) printf(" ERROR %d at EOF: %ld\n", ERR_SUM, ptrFile->total ) ;
+                    if (ptrFile->opt.Qcnt == 0) printf(" ERROR %d at EOF: %ld\n", ERR_SUM, ptrFile->total ) ;
                 }
-                if ( ( (ptrFile->debug & 0x0040) > 0 ) && (Qcnt == 0) )
+                if ( ( (ptrFile->debug & 0x0040) > 0 ) && (ptrFile->opt.Qcnt == 0) )
                     printf(" EOF:(%02X=%02X)", (uchar) sum, (uchar) ptrFile->sum_before);
                 break;
             }
             else if (byte == BAS_NEW_EOF) { /* merged program blocks */
-                StoredByte = byte2 ;
-                LastLineNb = 0 ;
+                ptrFile->stored_byte = byte2 ;
+                ptrFile->last_line_nb = 0 ;
                 if (ptrFile->type == TYPE_IMG ) {
                     if (strlen (ptrText) < (cLL - 1)) ptrText[length++] = (char) byte ;
                     else error = ERR_MEM ;
                 }
                 else {
                     tmpL = MERGE_MARK ;
-                    if ( linewidth > 5 )
-                         sprintf(ptrText, "%*ld ", (int) linewidth, tmpL);
+                    if ( ptrFile->opt.linewidth > 5 )
+                         sprintf(ptrText, "%*ld ", (int) ptrFile->opt.linewidth, tmpL);
                     else sprintf(ptrText, "%ld ", tmpL);
 
                     if (strlen (ptrText) < (cLL - 2)) (void) strncat (ptrText, "\r\n", 2) ;
                     else error = ERR_MEM ;
-                    if ( ( (ptrFile->debug & 0x0080) > 0 ) && (Qcnt == 0) ) printf(" %s", ptrText);
+                    if ( ( (ptrFile->debug & 0x0080) > 0 ) && (ptrFile->opt.Qcnt == 0) ) printf(" %s", ptrText);
                 }
                 *ptrLen  = length ;
                 break; /* next line */
@@ -5168,16 +5091,16 @@ int ReadLineFromBasWav (ulong  order,
             ptrText[length++] = (char) byte2 ;
         }
         else {
-            if (linewidth > 0) sprintf(tmpC, "%*ld ", (int) linewidth, tmpL);
+            if (ptrFile->opt.linewidth > 0) sprintf(tmpC, "%*ld ", (int) ptrFile->opt.linewidth, tmpL);
             else sprintf(tmpC, "%ld ", tmpL);
             strcat (ptrText, tmpC) ;
         }
-        if (tmpL <= LastLineNb ) {
-            if (Qcnt == 0) printf ("Wrong line number sequence found: %lu: %lu:\n", LastLineNb, tmpL);
+        if (tmpL <= ptrFile->last_line_nb ) {
+            if (ptrFile->opt.Qcnt == 0) printf ("Wrong line number sequence found: %lu: %lu:\n", ptrFile->last_line_nb, tmpL);
             error = count_errors( ERR_LINE, ptrFile );
             if (error != ERR_OK) break ;
         }
-        LastLineNb = tmpL ;
+        ptrFile->last_line_nb = tmpL ;
 
         /* Read the line */
         if ( (ptrFile->ident == IDENT_PC1211)  ||
@@ -5193,7 +5116,7 @@ int ReadLineFromBasWav (ulong  order,
                 }
                 else {
                     if (strcmp (CodeOld[byte], REMstr)== 0) REM_line = true ;
-                    if (byte == apostrophe) string_open = !string_open ;
+                    if (byte == ptrFile->apostrophe) string_open = !string_open ;
 
                     if ( byte == 0x1A  || ( 0x9F < byte && byte < 0xB0 ) ||
                         ( 0x7C < byte && byte < 0x80 ) || byte == 0x87 ) FN_old = true ; /* token of a function */
@@ -5201,13 +5124,13 @@ int ReadLineFromBasWav (ulong  order,
 
                     if (byte > 0) {
                         error = ConvertByteToBas (ptrText, CodeOld[byte], byte, ptrFile->utf8,
-                                                  IDENT_OLD_BAS, REM_line || string_open) ;
+                                                  IDENT_OLD_BAS, REM_line || string_open, ptrFile) ;
                         if (error == STAT_FMT) {
                             if ( FN_old == true ) {
                                 ++ ptrFile->wrn_cnt ;
-                                if (Qcnt == 0)
+                                if (ptrFile->opt.Qcnt == 0)
                                     printf ("* Star added in %lu: before %c at %lu. Check for function brackets manually!\n",
-                                            LastLineNb, CodeOld[byte][0], (ulong) strlen (ptrText)-1 ); // PI -> x
+                                            ptrFile->last_line_nb, CodeOld[byte][0], (ulong) strlen (ptrText)-1 ); // PI -> x
                             }
                             error = ERR_OK ;
                         }
@@ -5217,7 +5140,7 @@ int ReadLineFromBasWav (ulong  order,
                 ++ii ;
             } while (byte != 0) ;
             if (error != ERR_OK) break ;
-            if (ii > ll_Img ) {
+            if (ii > ptrFile->ll_img ) {
                 printf ("Image line with length of %i bytes is not editable, end at byte: %lu\n", (int) ii, ptrFile->total) ;
                 error = count_errors( ERR_MEM, ptrFile) ;
                 if (error != ERR_OK) break ;
@@ -5227,7 +5150,7 @@ int ReadLineFromBasWav (ulong  order,
             /* Read the Line length */
             error = ReadByteSumFromWav (order, &tmpL, ptrFile);
             if (error != ERR_OK) break ;
-            if (tmpL > ll_Img ) {
+            if (tmpL > ptrFile->ll_img ) {
                 printf ("Image line of %lu bytes is to long, begin at byte: %lu\n", tmpL, ptrFile->total) ;
                 error = count_errors( ERR_MEM, ptrFile) ;
                 if (error != ERR_OK) break ;
@@ -5243,7 +5166,7 @@ int ReadLineFromBasWav (ulong  order,
             /* line body processing */
             for ( ii = 1 ; ii < tmpL ; ++ii ) {
                 /* after errors this check can help to stay synchronous in line, but only if the nibbles in right order */
-                if ((ptrFile->type != TYPE_IMG || pcgrpId == IDENT_PC1500 || pcgrpId == GRP_NEW)
+                if ((ptrFile->type != TYPE_IMG || ptrFile->pcgrp_id == IDENT_PC1500 || ptrFile->pcgrp_id == GRP_NEW)
                     && byte == 0x0D) {    /* Binary coded line numbers may contain 0D in line */
                     printf ("Unexpected 'End of Line' at byte: %lu\n", ptrFile->total) ;
                     error = count_errors( ERR_MEM, ptrFile) ;
@@ -5259,22 +5182,22 @@ int ReadLineFromBasWav (ulong  order,
                     case IDENT_NEW_PAS :
 
                         if (strcmp (CodeNew[byte], REMstr)== 0) REM_line = true ;
-                        if (byte == apostrophe) string_open = !string_open ;
+                        if (byte == ptrFile->apostrophe) string_open = !string_open ;
 
-                        if (pcId == 1421 || pcId == 1401 || pcId == 1402 )
+                        if (ptrFile->opt.pcId == 1421 || ptrFile->opt.pcId == 1401 || ptrFile->opt.pcId == 1402 )
                             error = ConvertByteToBas (ptrText, CodeNew1421[byte], byte, ptrFile->utf8,
-                                                      IDENT_NEW_BAS, REM_line || string_open) ;
+                                                      IDENT_NEW_BAS, REM_line || string_open, ptrFile) ;
 
                         else if (byte == BAS_NEW_CODE && ii < tmpL - 1 ) { /* 2-byte token */
                             error = ReadByteSumFromWav (order, &byte, ptrFile);
                             if (error != ERR_OK) break ;
                             ++ii ;
                             error = ConvertByteToBas (ptrText, CodeNew2[byte], byte, ptrFile->utf8,
-                                                      IDENT_NEW_BAS, REM_line || string_open) ;
+                                                      IDENT_NEW_BAS, REM_line || string_open, ptrFile) ;
                         }
                         else
                             error = ConvertByteToBas (ptrText, CodeNew[byte], byte, ptrFile->utf8,
-                                                      IDENT_NEW_BAS, REM_line || string_open) ;
+                                                      IDENT_NEW_BAS, REM_line || string_open, ptrFile) ;
                         break ;
 
                     case IDENT_E_BAS :
@@ -5282,7 +5205,7 @@ int ReadLineFromBasWav (ulong  order,
                     case IDENT_EXT_BAS :
                     case IDENT_EXT_PAS :
 
-                        if ( (pcgrpId == GRP_E || pcgrpId == GRP_G) && byte == REMidC && !string_open && !REM_line) {
+                        if ( (ptrFile->pcgrp_id == GRP_E || ptrFile->pcgrp_id == GRP_G) && byte == REMidC && !string_open && !REM_line) {
                             if (ptrText[strlen (ptrText)-1] == ':') /* Remove ':' before the REM-Character */
                                 ptrText[strlen (ptrText)-1] =  0  ;
                             error = ERR_OK ;
@@ -5333,7 +5256,7 @@ int ReadLineFromBasWav (ulong  order,
                             if (error != ERR_OK) break ;
                             ++ii ;
 
-                            if ( pcgrpId == GRP_G && byte == ELSEid_E2 && !string_open && !REM_line) {
+                            if ( ptrFile->pcgrp_id == GRP_G && byte == ELSEid_E2 && !string_open && !REM_line) {
                                 if (ptrText[strlen (ptrText)-1] == ':') /* Remove ':' before ELSE of G series */
                                     ptrText[strlen (ptrText)-1] =  0  ;
                             }
@@ -5343,7 +5266,7 @@ int ReadLineFromBasWav (ulong  order,
                             if (maxlen > 0) {
 
                                 if (strcmp (CodeT[byte], REMstr)== 0) REM_line = true ;
-                                if ( !string_open && ( pcgrpId == GRP_E || pcgrpId == GRP_G ) && byte == REMidC)
+                                if ( !string_open && ( ptrFile->pcgrp_id == GRP_E || ptrFile->pcgrp_id == GRP_G ) && byte == REMidC)
                                     REM_line = true ;
 
                                 error = InsertSpaceNeeded (ptrText, CodeT[byte], &maxlen, &textlen) ;
@@ -5354,9 +5277,9 @@ int ReadLineFromBasWav (ulong  order,
                             else error = ERR_MEM ;
                         }
                         else {
-                            if (byte == apostrophe) string_open = !string_open ;
+                            if (byte == ptrFile->apostrophe) string_open = !string_open ;
                             error = ConvertByteToBas (ptrText, CodeC[byte], byte, ptrFile->utf8,
-                                                            ptrFile->ident, REM_line || string_open) ;
+                                                            ptrFile->ident, REM_line || string_open, ptrFile) ;
                         }
                         break ;
 
@@ -5366,15 +5289,15 @@ int ReadLineFromBasWav (ulong  order,
                              (byte != 0xE2) && (byte != 0xE1) &&
                              (byte != 0xF0) &&
                              (byte != 0xF1) ) {
-                            if (byte == apostrophe) string_open = !string_open ;
+                            if (byte == ptrFile->apostrophe) string_open = !string_open ;
                             error = ConvertByteToBas (ptrText, CodePc1500_1[byte], byte, ptrFile->utf8,
-                                                      IDENT_PC1500, REM_line || string_open) ;
+                                                      IDENT_PC1500, REM_line || string_open, ptrFile) ;
 
-                            if (byte == 0xF2 && (Qcnt == 0 || ptrFile->debug > 0) && WarnPC156M1) {
-                                printf ("\n%s: Token of PC-1600 found in the wave format of PC-1500.\n", argP );
+                            if (byte == 0xF2 && (ptrFile->opt.Qcnt == 0 || ptrFile->debug > 0) && ptrFile->warn_pc156m1) {
+                                printf ("\n%s: Token of PC-1600 found in the wave format of PC-1500.\n", ptrFile->opt.argP );
                                 printf ("         For PC-1600 set option --pc=1600 and start again!\n" );
                                 ++ ptrFile->wrn_cnt ;
-                                WarnPC156M1 = false ;
+                                ptrFile->warn_pc156m1 = false ;
                             }
                         }
                         else {
@@ -5451,10 +5374,10 @@ int ReadLineFromBasWav (ulong  order,
                              (byte != 0xF0) &&
                              (byte != 0xF1) &&
                              (byte != 0xF2) ) {
-                            if (byte == apostrophe) string_open = !string_open ;
+                            if (byte == ptrFile->apostrophe) string_open = !string_open ;
                             else if ( !string_open && byte == REMidC) REM_line = true ;
                             error = ConvertByteToBas (ptrText, CodeE437[byte], byte, ptrFile->utf8,
-                                                      ident, REM_line || string_open) ;
+                                                      ident, REM_line || string_open, ptrFile) ;
                         }
                         else {
                             ++ii ;
@@ -5549,7 +5472,7 @@ int ReadLineFromBasWav (ulong  order,
                         break ;
 
                     default :
-                        printf ("\n%s:RLine: Unknown Ident\n", argP) ;
+                        printf ("\n%s:RLine: Unknown Ident\n", ptrFile->opt.argP) ;
                         error = ERR_FMT;
                         break ;
                     }  // End switch: Ident
@@ -5566,7 +5489,7 @@ int ReadLineFromBasWav (ulong  order,
                 error = ReadByteSumFromWav (order, &byte, ptrFile); /* Next Byte CR */
 
                 if (ptrFile->check_end && error == ERR_EOT ) {
-                    LastLineEot = true ; /* BAS_NEW_EOF was read instead of Checksum */
+                    ptrFile->last_line_eot = true ; /* BAS_NEW_EOF was read instead of Checksum */
                     error = ERR_OK ;
                 }
                 if (error != ERR_OK) break ;
@@ -5590,7 +5513,7 @@ int ReadLineFromBasWav (ulong  order,
             if (strlen (ptrText) < (cLL - 2))
                 (void) strncat (ptrText, "\r\n", 2) ;
             else error = ERR_MEM ;
-            if (Qcnt == 0) {
+            if (ptrFile->opt.Qcnt == 0) {
                 if ( (ptrFile->debug & 0xC0) == 0xC0 ) printf("\n>"); else printf(" ");
                 if ( (ptrFile->debug & 0x80) > 0 )     printf("%s", ptrText);
             }
@@ -5612,39 +5535,40 @@ void DebugReadEndFromBinWav (ulong  order,
     ptrFile->writing  = false ;
 
     if ( (ptrFile->debug & 0x200) > 0) {
-        if (Qcnt == 0) printf ("\nEnd @%06lX, checking again: ", ftell( ptrFile->ptrFd ) ) ;
+        if (ptrFile->opt.Qcnt == 0) printf ("\nEnd @%06lX, checking again: ", WavTell (ptrFile) ) ;
         for ( ii = 0 ; ii < 0x10 ; ++ii ) {
             error = ReadByteFromWav (order, &byte, ptrFile);
             if (error > ERR_OK) break ;
 
-            if ( ( (ptrFile->debug & 0x30) == 0) && (Qcnt == 0) )
+            if ( ( (ptrFile->debug & 0x30) == 0) && (ptrFile->opt.Qcnt == 0) )
                 printf(" %02X", (uchar) byte);
 
             if (error != ERR_OK) break ;
         }
     }
     else if  ((ptrFile->debug & 0x70) > 0) {
-        if (Qcnt == 0) printf (" End, debug checking again: ") ;
+        if (ptrFile->opt.Qcnt == 0) printf (" End, debug checking again: ") ;
         /* Read one byte from the Wav file */
         byte = UNREAD ;
         error = ReadByteFromWav (order, &byte, ptrFile);
         if (error > ERR_OK) return ;
 
-        if (byte != UNREAD && Qcnt == 0) printf(" (%02X)", (uchar) byte);
+        if (byte != UNREAD && ptrFile->opt.Qcnt == 0) printf(" (%02X)", (uchar) byte);
     }
 }
 
 
 int OpenDstFile     (char*  ptrDstFile,
                      char*  ptrText,
-                     FILE** ptrDstFd)
+                     FILE** ptrDstFd,
+                 FileInfo* ptrFile)
 {
     /* Compare the destination file to "NULL", if not open the file */
     if ( strcmp (ptrDstFile, "NULL") != 0) {
         /* Open the destination file */
         *ptrDstFd = fopen (ptrDstFile, "wb") ;
         if (*ptrDstFd == NULL) {
-            printf ("\n%s: Can't open the destination file: %s\n", argP, ptrDstFile) ;
+            printf ("\n%s: Can't open the destination file: %s\n", ptrFile->opt.argP, ptrDstFile) ;
             return (ERR_FILE) ;
         }
         ptrText[0] = 0 ;
@@ -5656,12 +5580,46 @@ int OpenDstFile     (char*  ptrDstFile,
 }
 
 
+void SetDefaultOptions (OptionInfo*  ptrOpt)
+{
+    ptrOpt->argP       = "wav2bin" ;
+    ptrOpt->speed      = 1 ;
+    ptrOpt->SHAc       = 0 ;
+    ptrOpt->SHCc       = 0 ;
+    ptrOpt->TAPw       = 0 ;
+    ptrOpt->TAPc       = 0 ;
+    ptrOpt->Qcnt       = 0 ;
+    ptrOpt->linewidth  = 5 ;        /* --width default */
+    ptrOpt->devId      = DEV_PC ;
+    ptrOpt->pcId       = 0 ;
+    ptrOpt->pcgrpId    = IDENT_UNKNOWN ;
+    ptrOpt->ll_Img     = cLL_IMG ;
+    ptrOpt->debug_time = 10000.00000 ; /* [s] standard value needed */
+//  ptrOpt->debug_time = 10.00000 ;    /* start time of your debug for sample processing - for low level testing only */
+
+    /* This constants are modified by the --cspeed parameter */
+    ptrOpt->Base_FREQ1 = BASE_FREQ1 ;
+    ptrOpt->Base_FREQ2 = BASE_FREQ2 ;
+    ptrOpt->Base_FREQ3 = BASE_FREQ3 ;
+    ptrOpt->Stop_Bit_Max   = STOP_BIT_MAX ;
+    /* The following values are sample values (8 bit) or differences of them */
+    ptrOpt->Trans_High_def = TRANS_HIGH ;
+    ptrOpt->Trans_Low_def  = TRANS_LOW ;
+    ptrOpt->Trans_High_15  = TRANS_HIGH_15 ;
+    ptrOpt->Trans_Low_15   = TRANS_LOW_15 ;
+    ptrOpt->Amp_Diff_Rel   = AMP_DIFF_REL ;
+    ptrOpt->Amp_Diff_Mid   = AMP_DIFF_MID ;
+    ptrOpt->Rate_Amp_Def   = RATE_AMP_4 ;
+}
+
+
 int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
                      char*  ptrDstFile, /* Destination file string*/
                      ulong  type,       /* SHARP file type */
                      ulong  order,      /* Order of nibbles in a Byte for old generations or ORDER_E for PC-1600 and newer */
                      ulong  utf8,       /* destination type of a special char */
-                     ulong  debug)      /* special options or debug traces */
+                     ulong  debug,      /* special options or debug traces */
+         const OptionInfo*  ptrOpt)     /* options, copied into the FileInfo, not changed */
 {
     FileInfo  fileInfo ;                /* source file pointer and variables, that used near global */
     TypeInfo  typeInfo ;                /* data variable header */
@@ -5677,6 +5635,7 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
          int  error, error_tmp ;
 
     do {
+        fileInfo.opt        = *ptrOpt ;
         fileInfo.ptrFd      = NULL ;
         fileInfo.ident      = IDENT_UNKNOWN ;
         fileInfo.base_freq  = 0 ;
@@ -5693,6 +5652,9 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
         fileInfo.bytesPerP  = 1 ;   // 8-bit = 1, 16-bit = 2
         fileInfo.bgnSamples = 44 ;
         fileInfo.pre_amp    = 1 ;
+        fileInfo.samples    = NULL ;
+        fileInfo.raw        = NULL ;
+        fileInfo.cursor     = 0 ;
 
         fileInfo.bitLen     = 0 ;
         fileInfo.bitLen1    = 0 ;
@@ -5707,6 +5669,40 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
         fileInfo.skip_bits  = SYNC_NB_CNT ;
         fileInfo.sync_bit   = false ;
 
+        fileInfo.base_freq1 = fileInfo.opt.Base_FREQ1 ;
+        fileInfo.base_freq2 = fileInfo.opt.Base_FREQ2 ;
+        fileInfo.base_freq3 = fileInfo.opt.Base_FREQ3 ;
+        fileInfo.base_freq_before = 0 ;
+        fileInfo.stop_bit_max   = fileInfo.opt.Stop_Bit_Max ;
+        fileInfo.trans_high     = 0 ;
+        fileInfo.trans_low      = 0 ;
+        fileInfo.trans_high_def = fileInfo.opt.Trans_High_def ;
+        fileInfo.trans_low_def  = fileInfo.opt.Trans_Low_def ;
+        fileInfo.trans_high_15  = fileInfo.opt.Trans_High_15 ;
+        fileInfo.trans_low_15   = fileInfo.opt.Trans_Low_15 ;
+        fileInfo.amp_diff_rel   = fileInfo.opt.Amp_Diff_Rel ;
+        fileInfo.amp_diff_mid   = fileInfo.opt.Amp_Diff_Mid ;
+        fileInfo.amp_diff_min   = 0 ;
+        fileInfo.amp_max_above  = 0 ;
+        fileInfo.amp_min_below  = 0 ;
+        fileInfo.rate_amp_def   = fileInfo.opt.Rate_Amp_Def ;
+        fileInfo.amp_dpos_bas   = 0 ;
+        fileInfo.amp_dpos_max   = 0 ;
+        fileInfo.amp_dpos_min   = 0 ;
+        fileInfo.amp_dpos_err   = false ;
+        fileInfo.amp_dpos_errpos = -1 ;
+        fileInfo.stop_bit_missed = false ;
+        fileInfo.stop_bit_mispos = -1 ;
+        fileInfo.miss_stop_bits = 0 ;
+
+        fileInfo.pcgrp_id   = fileInfo.opt.pcgrpId ;
+        fileInfo.ll_img     = fileInfo.opt.ll_Img ;
+        fileInfo.apostrophe = 0x22 ;
+        fileInfo.stored_byte    = UNREAD ;
+        fileInfo.last_line_nb   = 0 ;
+        fileInfo.last_line_eot  = false ;
+        fileInfo.warn_pc156m1   = true ;
+
         fileInfo.type       = type ;
         fileInfo.utf8       = utf8 ;
 
@@ -5722,7 +5718,7 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
         /* Open the source file */
         fileInfo.ptrFd = fopen (ptrSrcFile, "rb") ;
         if (fileInfo.ptrFd == NULL) {
-            printf ("\n%s: Can't open the wave file: %s\n", argP, ptrSrcFile) ;
+            printf ("\n%s: Can't open the wave file: %s\n", fileInfo.opt.argP, ptrSrcFile) ;
             error = ERR_FILE ;
             break ;
         }
@@ -5730,7 +5726,7 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
         /* Seek to the end of the source file */
         error = fseek (fileInfo.ptrFd, 0, SEEK_END) ;
         if (error != ERR_OK) {
-            printf ("\n%s:endwav - Can't seek the wave file\n", argP) ;
+            printf ("\n%s:endwav - Can't seek the wave file\n", fileInfo.opt.argP) ;
             error = ERR_FILE ;
             break ;
         }
@@ -5738,7 +5734,7 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
         /* Get the length of the source file */
         nbByte = ftell (fileInfo.ptrFd) ;
         if (nbByte <= 0) {
-            printf ("\n%s:endwav - Can't ftell the wave file\n", argP) ;
+            printf ("\n%s:endwav - Can't ftell the wave file\n", fileInfo.opt.argP) ;
             error = ERR_FILE ;
             break ;
         }
@@ -5747,26 +5743,26 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
         /* Seek to the begining of the source file */
         error = fseek (fileInfo.ptrFd, 0, SEEK_SET) ;
         if (error != ERR_OK) {
-            printf ("\n%s:bgnwav - Can't seek the wave file\n", argP) ;
+            printf ("\n%s:bgnwav - Can't seek the wave file\n", fileInfo.opt.argP) ;
             error = ERR_FILE ;
             break ;
         }
 
-        if ( type == TYPE_RAW || SHCc != 0 ) {
-            error = OpenDstFile (ptrDstFile, text, &dstFd) ;
+        if ( type == TYPE_RAW || fileInfo.opt.SHCc != 0 ) {
+            error = OpenDstFile (ptrDstFile, text, &dstFd, &fileInfo) ;
             if (error != ERR_OK) break ;
 
             fileInfo.writing  = true ; /* total write counter on */
         }
 
-        if (TAPc > 0 ) {
-            if (Qcnt == 0) printf ("Input format  : Forced emulator tap format (no wave file)\n") ;
+        if (fileInfo.opt.TAPc > 0 ) {
+            if (fileInfo.opt.Qcnt == 0) printf ("Input format  : Forced emulator tap format (no wave file)\n") ;
             error = ReadSaveIdFromTap (&fileInfo, &dstFd);
         }
         else {
 
             if (nbByte <= 58) {
-                printf ("\n%s: Source file is not a valid WAV File\n", argP) ;
+                printf ("\n%s: Source file is not a valid WAV File\n", fileInfo.opt.argP) ;
                 error = ERR_FMT ;
                 break ;
             }
@@ -5777,28 +5773,34 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
 
             /* Check the lower frequency limit */
             if (freq < 5000) {
-                printf ("\n%s: Sampling frequency is lower than 5000 Hz: %lu Hz\n", argP, freq);
+                printf ("\n%s: Sampling frequency is lower than 5000 Hz: %lu Hz\n", fileInfo.opt.argP, freq);
                 error = ERR_FMT ;
                 break ;
             }
 
             /* Check the recommended higher frequency limit */
             if (freq > 22050)
-                if (Qcnt == 0) printf ("Sampling frequency is: %lu Hz\n", freq);
+                if (fileInfo.opt.Qcnt == 0) printf ("Sampling frequency is: %lu Hz\n", freq);
 
             /* Check the higher frequency limit */
             if (freq > 96000) {
-                printf ("\n%s: Sampling frequency is greater than 96000 Hz: %lu Hz\n", argP, freq);
+                printf ("\n%s: Sampling frequency is greater than 96000 Hz: %lu Hz\n", fileInfo.opt.argP, freq);
                 error = ERR_FMT ;
                 break ;
             }
             fileInfo.wav_freq = freq;
 
+            /* Read all samples of the wave file into memory */
+            error = LoadSamplesFromWav (&fileInfo) ;
+            if (error != ERR_OK) break ;
+
             if ((debug & NO_PRE_AMP)==0) {
-                    if (Qcnt == 0 && (debug) >0 ) printf ("Quantise the levels of the wave file...\n");
+                    if (fileInfo.opt.Qcnt == 0 && (debug) >0 ) printf ("Quantise the levels of the wave file...\n");
                     error = AnalyseSoundLevelOfWav (&fileInfo) ;
             }
-            else if (Qcnt == 0) printf ("The analysis of the wave file and pre-amplification had been turned off.\n");
+            else if (fileInfo.opt.Qcnt == 0) printf ("The analysis of the wave file and pre-amplification had been turned off.\n");
+            free (fileInfo.raw) ; /* pre-amplification is fixed now */
+            fileInfo.raw = NULL ;
             if (error != ERR_OK) break ;
 
             /* First search from begin of wave SYNC_NB_CNT-times BID_1 */
@@ -5813,13 +5815,13 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
                 /* Search the Synchro and the Frequency of the wave */
                 error = FindFreqAndSyncFromWav (&fileInfo) ;
                 if (error < ERR_OK ) { /* Sync not found with first found frequency */
-                    if (fileInfo.base_freq == Base_FREQ1){
-                        if ( Base_FREQ2 > 0) fileInfo.base_freq  = Base_FREQ2 ;
-                        else if ( Base_FREQ3 > 0) fileInfo.base_freq  = Base_FREQ3 ;
+                    if (fileInfo.base_freq == fileInfo.base_freq1){
+                        if ( fileInfo.base_freq2 > 0) fileInfo.base_freq  = fileInfo.base_freq2 ;
+                        else if ( fileInfo.base_freq3 > 0) fileInfo.base_freq  = fileInfo.base_freq3 ;
                         else error = ERR_SYNC ;
                     }
-                    else if (fileInfo.base_freq == Base_FREQ2){
-                        if ( Base_FREQ3 > 0) fileInfo.base_freq  = Base_FREQ3 ;
+                    else if (fileInfo.base_freq == fileInfo.base_freq2){
+                        if ( fileInfo.base_freq3 > 0) fileInfo.base_freq  = fileInfo.base_freq3 ;
                         else error = ERR_SYNC ;
                     }
                     else error = ERR_SYNC ;
@@ -5834,23 +5836,33 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
                 if (error == ERR_NSYNC ) continue ; /* false sync found */
                 if (error != ERR_OK) break ;
 
+                /* Without a PC given, a header not of the group of this base frequency was */
+                /* a false sync, search behind it again with all base frequencies           */
+                if (fileInfo.opt.pcId == 0 && type != TYPE_RAW && !fileInfo.writing && !IsIdentOfFreq (&fileInfo)) {
+                    if (fileInfo.opt.Qcnt == 0 && debug != 0)
+                        printf ("No valid ident 0x%02X for %lu Hz at %.5lf s, all PC groups are tried again\n",
+                                 (uint) fileInfo.ident, fileInfo.base_freq, WavTime(&fileInfo));
+                    fileInfo.ident = IDENT_UNKNOWN ;
+                    fileInfo.freq = 0 ;
+                }
+
             } while ( error == ERR_NSYNC || ( type != TYPE_RAW
                     && fileInfo.ident == IDENT_UNKNOWN ) ) ;
 
         } // End if is wave
         if (error != ERR_OK) break ;
 
-        /* Check ID, set pcgrpId */
+        /* Check ID, set fileInfo.pcgrp_id */
         error = PrintSaveIdFromWav (&fileInfo) ;
         ident = fileInfo.ident ;
 
         if ( type == TYPE_BAS) { /* check, if type BAS was used correctly */
             if ( ident == IDENT_E_ASC ) {
-                 if (Qcnt == 0) printf ("%s: ASCII file detected, type is changed from image 'bas' to 'asc' now.\n", argP);
+                 if (fileInfo.opt.Qcnt == 0) printf ("%s: ASCII file detected, type is changed from image 'bas' to 'asc' now.\n", fileInfo.opt.argP);
                  fileInfo.type = type = TYPE_IMG ; // for TYPE_ASC
             }
             else if ( ident == IDENT_PC16_CAS ) {
-                 if (Qcnt == 0) printf ("%s: This file is not an image that could be converted to 'bas'.\n", argP);
+                 if (fileInfo.opt.Qcnt == 0) printf ("%s: This file is not an image that could be converted to 'bas'.\n", fileInfo.opt.argP);
                  fileInfo.type = type = TYPE_IMG ; // for TYPE_ASC
             }
         }
@@ -5860,42 +5872,42 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
                  ident == IDENT_NEW_BAS || ident == IDENT_NEW_PAS ||
                  ident == IDENT_OLD_BAS || ident == IDENT_OLD_PAS ||
                  ident == IDENT_PC1211  || ident == IDENT_PC15_BAS ) {
-                 if (Qcnt == 0) printf ("%s: Image detected, file type is changed from 'asc' to 'bas' now.\n", argP);
-                 linewidth = 0 ;
+                 if (fileInfo.opt.Qcnt == 0) printf ("%s: Image detected, file type is changed from 'asc' to 'bas' now.\n", fileInfo.opt.argP);
+                 fileInfo.opt.linewidth = 0 ;
                  fileInfo.utf8 = utf8 = UTF8_ASC ;
                  fileInfo.type = type = TYPE_BAS ;
             }
             else fileInfo.type = type = TYPE_IMG ; /* always for TYPE_ASC further processing */
         }
 
-        if (TAPc == 0) ReadBitParamAdjust (&fileInfo) ; /* for user data */
+        if (fileInfo.opt.TAPc == 0) ReadBitParamAdjust (&fileInfo) ; /* for user data */
 
-        if ( SHCc != 0 ) {
-            if  (pcgrpId != IDENT_PC1211 && /* GRP_OLD is used for this */
-                 pcgrpId != GRP_OLD && pcgrpId != GRP_NEW && pcgrpId != GRP_EXT) {
-                printf ("\n%s: SHC file format is not supported for this ident.\n", argP);
-                printf ("\n%s: Only PC-12.. to 1475 are implemented for this.\n", argP);
+        if ( fileInfo.opt.SHCc != 0 ) {
+            if  (fileInfo.pcgrp_id != IDENT_PC1211 && /* GRP_OLD is used for this */
+                 fileInfo.pcgrp_id != GRP_OLD && fileInfo.pcgrp_id != GRP_NEW && fileInfo.pcgrp_id != GRP_EXT) {
+                printf ("\n%s: SHC file format is not supported for this ident.\n", fileInfo.opt.argP);
+                printf ("\n%s: Only PC-12.. to 1475 are implemented for this.\n", fileInfo.opt.argP);
                 error = ERR_FMT ;
                 break ;
             }
             else if (fileInfo.ident == IDENT_PC121_DAT) ident = IDENT_OLD_DAT ;
             else if (fileInfo.ident == IDENT_PC1211) ident = IDENT_OLD_BAS ;
-            if (fileInfo.ident != ident && Qcnt==0 )
-                printf ("\n%s: Pocket Pctyp PC1251 is used for this SHC file.\n", argP);
+            if (fileInfo.ident != ident && fileInfo.opt.Qcnt==0 )
+                printf ("\n%s: Pocket Pctyp PC1251 is used for this SHC file.\n", fileInfo.opt.argP);
         }
 
-        if (type == TYPE_RAW || SHCc != 0 ){
-            if (fileInfo.base_freq == Base_FREQ2 && Base_FREQ2 > 0 ) order = ORDER_INV ;
+        if (type == TYPE_RAW || fileInfo.opt.SHCc != 0 ){
+            if (fileInfo.base_freq == fileInfo.base_freq2 && fileInfo.base_freq2 > 0 ) order = ORDER_INV ;
             /* only for PC-1500 the id (and the counter in the first header) has written by ReadSaveId */
             else {
-                TAPw = 0 ; /* Destination TAP-Format is flat for other series than PC-1500 */
+                fileInfo.opt.TAPw = 0 ; /* Destination TAP-Format is flat for other series than PC-1500 */
 
-                error = WriteByteToFile (ident, &dstFd) ;
+                error = WriteByteToFile (ident, &dstFd, &fileInfo) ;
                 if (error != ERR_OK) break ;
-                if (fileInfo.base_freq == Base_FREQ1 && Base_FREQ1 > 0)
+                if (fileInfo.base_freq == fileInfo.base_freq1 && fileInfo.base_freq1 > 0)
                                           ++fileInfo.total ; /* id read in quaters */
             }
-            if (fileInfo.base_freq == Base_FREQ3 && Base_FREQ3 > 0 ) order = ORDER_E ;
+            if (fileInfo.base_freq == fileInfo.base_freq3 && fileInfo.base_freq3 > 0 ) order = ORDER_E ;
         }
         /* Map IDs here, if needed */
 
@@ -5905,7 +5917,7 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
             /* Read the Save Name */
             error = ReadSaveNameOrPassFromWav (ntext, &fileInfo, &dstFd);
             if (error != ERR_OK) break ;
-            if (Qcnt == 0) printf (" Save name     : %s\n", ntext) ;
+            if (fileInfo.opt.Qcnt == 0) printf (" Save name     : %s\n", ntext) ;
 
             /* Read the PassWord if necessary */
             if ((fileInfo.ident == IDENT_OLD_PAS) ||
@@ -5914,14 +5926,14 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
 
                 error = ReadSaveNameOrPassFromWav (ntext, &fileInfo, &dstFd);
                 if (error != ERR_OK) break ;
-                if (Qcnt == 0) printf (" Password      : %s\n", ntext) ;
+                if (fileInfo.opt.Qcnt == 0) printf (" Password      : %s\n", ntext) ;
             }
         }  //end if not raw
 
         if ( fileInfo.ident == IDENT_PC1211 ||
              fileInfo.ident == IDENT_PC121_DAT ||
              type == TYPE_RAW ) {
-                Stop_Bit_Max = STOP_BIT_M11 ;
+                fileInfo.stop_bit_max = STOP_BIT_M11 ;
         }
         if (type == TYPE_RAW){
             fileInfo.ident = IDENT_RAW ;
@@ -5929,15 +5941,15 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
             /* read the save name or pwd will be done with the first block of raw data */
         }
         else {
-            if (SHCc == 0) error = OpenDstFile (ptrDstFile, text, &dstFd) ;
+            if (fileInfo.opt.SHCc == 0) error = OpenDstFile (ptrDstFile, text, &dstFd, &fileInfo) ;
             if (error != ERR_OK) break ;
 
             order = ORDER_STD ;
         } // end if not raw
 
         /* set order, also for raw data */
-        if (fileInfo.base_freq == Base_FREQ3 && Base_FREQ3 > 0) order = ORDER_E ;
-        else if (fileInfo.base_freq == Base_FREQ2 && Base_FREQ2 > 0) order = ORDER_INV ;
+        if (fileInfo.base_freq == fileInfo.base_freq3 && fileInfo.base_freq3 > 0) order = ORDER_E ;
+        else if (fileInfo.base_freq == fileInfo.base_freq2 && fileInfo.base_freq2 > 0) order = ORDER_INV ;
 
         /* Read the rest of the Header from the Wav file */
         switch (fileInfo.ident) {
@@ -5983,7 +5995,7 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
             fileInfo.ident != IDENT_PC15_BAS  &&
             fileInfo.ident != IDENT_PC16_BAS  &&
             fileInfo.ident != IDENT_E_BAS      )) {
-                printf ("\n%s: Only images are supported for this file type from wave, not 'bas'.\n", argP) ;
+                printf ("\n%s: Only images are supported for this file type from wave, not 'bas'.\n", fileInfo.opt.argP) ;
                 printf ("         Use option --type=img (or with the correct file type)\n") ;
                 error = ERR_ARG ;
                 break ;
@@ -5998,17 +6010,17 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
             fileInfo.ident != IDENT_EXT_PAS   &&
             fileInfo.ident != IDENT_PC15_RSV  &&
             fileInfo.ident != IDENT_PC16_RSV   )) {
-                printf ("\n%s: No RSV images are supported for this file type.\n", argP) ;
+                printf ("\n%s: No RSV images are supported for this file type.\n", fileInfo.opt.argP) ;
                 error = ERR_ARG ;
                 break ;
         }
 
-        if (SHAc != 0 && type == TYPE_BAS) {
+        if (fileInfo.opt.SHAc != 0 && type == TYPE_BAS) {
             strcpy  (text, ".BAS \"" ) ;
             strncat (text, ntext, 16) ;
             strncat (text, "\"\r\n", 3) ;
 
-            error = WriteStringToFile (text, &dstFd) ;
+            error = WriteStringToFile (text, &dstFd, &fileInfo) ;
             if (error != ERR_OK) break ;
         }
 
@@ -6029,7 +6041,7 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
             fileInfo.count  = 0 ;   /* Reset the checksum counter after header */
             // fileInfo.sum = 0 ;
             fileInfo.writing  = true ; /* total write counter on */
-            if (Qcnt == 0) printf (" Output format : Binary%s\n", text) ;
+            if (fileInfo.opt.Qcnt == 0) printf (" Output format : Binary%s\n", text) ;
 
             for ( ii = 0 ; ii < length ; ++ii ) {
                 /* Read a byte from the Wav file */
@@ -6047,7 +6059,7 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
                 error_tmp = error;
 
                 /* Write it in the destination file queue */
-                error = WriteByteToFile (byte, &dstFd) ;
+                error = WriteByteToFile (byte, &dstFd, &fileInfo) ;
                 if (error != ERR_OK || error_tmp != ERR_OK) {
                     if (error == ERR_OK) error = error_tmp;
                     break ;
@@ -6067,11 +6079,11 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
             if ( fileInfo.ident == IDENT_NEW_BIN) { /* End and checksum reading */
                     error = ReadByteFromWav (order, &byte2, &fileInfo);
                     if (error != ERR_OK) break ;
-                    if ( ( (fileInfo.debug & 0x0040) > 0 ) && (Qcnt == 0) )
+                    if ( ( (fileInfo.debug & 0x0040) > 0 ) && (fileInfo.opt.Qcnt == 0) )
                         printf(" EOF:(%02X)", (uchar) byte2 ) ; /* Mark 1 of 2, real 2. not in checksum */
 
-                    if ( SHCc != 0 ) { /* End mark 1 included in SHC image */
-                        error = WriteByteToFile (byte2, &dstFd);
+                    if ( fileInfo.opt.SHCc != 0 ) { /* End mark 1 included in SHC image */
+                        error = WriteByteToFile (byte2, &dstFd, &fileInfo);
                         if (error != ERR_OK) break ;
                     }
 
@@ -6089,17 +6101,17 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
             if ( fileInfo.ident == IDENT_OLD_BIN) { /* End reading */
                     if (error==ERR_EOF || error==ERR_NSYNC) {
                         byte=BAS_OLD_EOF;  /* EOF mark was in old versions and YASM61860 not included */
-                        if (Qcnt==0) printf(" Missing EOF mark %02X\n", (uchar) byte) ;
+                        if (fileInfo.opt.Qcnt==0) printf(" Missing EOF mark %02X\n", (uchar) byte) ;
                         ++ fileInfo.wrn_cnt;
                     }
                     else {
                         error = ReadByteFromWav (order, &byte, &fileInfo);
                         if (error > ERR_OK || byte == UNREAD) break ;
-                        if ( ( (fileInfo.debug & 0x0040) > 0 ) && (Qcnt == 0) )
+                        if ( ( (fileInfo.debug & 0x0040) > 0 ) && (fileInfo.opt.Qcnt == 0) )
                             printf(" EOF:(%02X)", (uchar) byte ) ; /* Mark not in checksum */
                     }
-                    if ( SHCc != 0 ) { /* End mark included in SHC image */
-                        error = WriteByteToFile (byte, &dstFd);
+                    if ( fileInfo.opt.SHCc != 0 ) { /* End mark included in SHC image */
+                        error = WriteByteToFile (byte, &dstFd, &fileInfo);
                         if (error != ERR_OK) break ;
                     }
 
@@ -6116,7 +6128,7 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
         case IDENT_PC16_IMG : /*Saved PC-1600 device CAS: without option ",A" */
 
             fileInfo.writing  = true ; /* total write counter on */
-            if (Qcnt == 0) printf (" Output format : Image Data%s\n", text) ;
+            if (fileInfo.opt.Qcnt == 0) printf (" Output format : Image Data%s\n", text) ;
 
             do {
                 for ( ii = fileInfo.count ; ii < BLK_E_DAT ; ++ii ) {
@@ -6126,7 +6138,7 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
 
                     if (fileInfo.writing) {
                         /* Write it in the destination file queue */
-                        error = WriteByteToFile (byte, &dstFd) ;
+                        error = WriteByteToFile (byte, &dstFd, &fileInfo) ;
                         if (error != ERR_OK) break ;
 
                         if (byte == 0x0D ) {
@@ -6139,11 +6151,11 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
                         fileInfo.writing  = true ;
                         while ( fillc > 0 ) {
                             --fillc ;
-                            error = WriteByteToFile (0, &dstFd) ;
+                            error = WriteByteToFile (0, &dstFd, &fileInfo) ;
                             if (error != ERR_OK) break ;
                         }
                         if (error != ERR_OK) break ;
-                        error = WriteByteToFile (byte, &dstFd) ;
+                        error = WriteByteToFile (byte, &dstFd, &fileInfo) ;
                         if (error != ERR_OK) break ;
                     }
                 }
@@ -6165,7 +6177,7 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
         case IDENT_E_ASC :
 
             fileInfo.writing  = true ; /* total write counter on */
-            if (Qcnt == 0) printf (" Output format : Data%s\n", text) ;
+            if (fileInfo.opt.Qcnt == 0) printf (" Output format : Data%s\n", text) ;
 
             do {
                 for ( ii = fileInfo.count ; ii < BLK_E_DAT ; ++ii ) {
@@ -6175,11 +6187,11 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
 
                     if (byte == EOF_ASC) {
                         fileInfo.writing  = false ; /* total write counter on */
-                        if ( ( (fileInfo.debug & 0x0040) > 0 ) && (Qcnt == 0) ) printf(" Meaningless data:");
+                        if ( ( (fileInfo.debug & 0x0040) > 0 ) && (fileInfo.opt.Qcnt == 0) ) printf(" Meaningless data:");
                     }
                     else if (fileInfo.writing) {
                         /* Write it in the destination file queue */
-                        error = WriteByteToFile (byte, &dstFd) ;
+                        error = WriteByteToFile (byte, &dstFd, &fileInfo) ;
                         if (error != ERR_OK) break ;
                     }
                 }
@@ -6208,7 +6220,7 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
 
         case IDENT_PC16_DAT :
 
-            if (Qcnt == 0) printf (" Output format : Data%s\n", text) ;
+            if (fileInfo.opt.Qcnt == 0) printf (" Output format : Data%s\n", text) ;
             fileInfo.writing  = true ; /* total counter on */
 
             while ( error == ERR_OK ) {
@@ -6240,23 +6252,23 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
 
                 /* write the header back to file */
                 byte = ( typeInfo.length >> 8 ) & 0xff;
-                error = WriteByteToDatFile (byte, &dstFd) ;
+                error = WriteByteToDatFile (byte, &dstFd, &fileInfo) ;
                 if (error != ERR_OK) break ;
 
                 byte = typeInfo.length & 0xff;
-                error = WriteByteToDatFile (byte, &dstFd) ;
+                error = WriteByteToDatFile (byte, &dstFd, &fileInfo) ;
                 if (error != ERR_OK) break ;
 
                 byte = typeInfo.dim1;
-                error = WriteByteToDatFile (byte, &dstFd) ;
+                error = WriteByteToDatFile (byte, &dstFd, &fileInfo) ;
                 if (error != ERR_OK) break ;
 
                 byte = typeInfo.dim2;
-                error = WriteByteToDatFile (byte, &dstFd) ;
+                error = WriteByteToDatFile (byte, &dstFd, &fileInfo) ;
                 if (error != ERR_OK) break ;
 
                 byte = typeInfo.itemLen;
-                error = WriteByteToDatFile (byte, &dstFd) ;
+                error = WriteByteToDatFile (byte, &dstFd, &fileInfo) ;
                 if (error != ERR_OK) break ;
 
 /*              byte = typeInfo.type;  its the checksum of the ext. header
@@ -6265,7 +6277,7 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
 
                 if ( length == DATA_VARIABLE ) {
                     /* Variable length block, read until end of data */
-                    if (Qcnt == 0) printf (" Variable length block\n") ;
+                    if (fileInfo.opt.Qcnt == 0) printf (" Variable length block\n") ;
 
                     length = DATA_HEAD_LEN;
                     do {
@@ -6288,14 +6300,14 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
                                 else if (byte == DATA_EOF && ( length - DATA_HEAD_LEN) % DATA_STD_LEN == 0) {
                                     fileInfo.status = STAT_EOT ;
                                     fileInfo.writing =true;
-                                    if (Qcnt == 0 && fillc > 0 )
+                                    if (fileInfo.opt.Qcnt == 0 && fillc > 0 )
                                         printf ("\nEmpty variables was removed from end, use -l 0x%05X for full image\n", WRT_NUL_DATA) ;
                                 }
                                 else {
                                     fileInfo.writing  = true ;
                                     while ( fillc > 0 ) {
                                         --fillc ;
-                                        error = WriteByteToDatFile (0, &dstFd) ;
+                                        error = WriteByteToDatFile (0, &dstFd, &fileInfo) ;
                                         if (error != ERR_OK) break ;
                                     }
                                     if (error != ERR_OK) break ;
@@ -6304,7 +6316,7 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
                         }  // end if IDENT_PC121_DAT
 
                         /* Write it in the destination file queue */
-                        if (fileInfo.writing) error = WriteByteToDatFile (byte, &dstFd) ;
+                        if (fileInfo.writing) error = WriteByteToDatFile (byte, &dstFd, &fileInfo) ;
                         if (error != ERR_OK) break ;
 
                         ++length;
@@ -6314,11 +6326,11 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
                         }
                     }
                     while ( ( length - DATA_HEAD_LEN -1 ) % DATA_STD_LEN != 0 || byte != DATA_EOF );
-                    if (Qcnt == 0) printf ("...length with envelope: %ld\n", length) ;
+                    if (fileInfo.opt.Qcnt == 0) printf ("...length with envelope: %ld\n", length) ;
                 }
                 else {
                     length += 2;
-                    if (Qcnt == 0) printf (" Data block, length: %lu\n", length) ;
+                    if (fileInfo.opt.Qcnt == 0) printf (" Data block, length: %lu\n", length) ;
                     for ( ii = DATA_HEAD_LEN ; ii < length ; ++ii ) {
                         /* Read a byte from the Wav file */
                         error = ReadByteSumFromWav (order, &byte, &fileInfo);
@@ -6326,7 +6338,7 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
                         error_tmp = error ;
 
                         /* Write it in the destination file queue */
-                        error = WriteByteToDatFile (byte, &dstFd) ;
+                        error = WriteByteToDatFile (byte, &dstFd, &fileInfo) ;
                         if (error != ERR_OK) break ;
 
                         if (error_tmp != ERR_OK) {
@@ -6369,7 +6381,7 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
         case IDENT_PC1211  :
         case IDENT_OLD_BAS :
         case IDENT_OLD_PAS :
-            if (pcgrpId == GRP_OLD || pcgrpId == IDENT_PC1211) apostrophe = ApostOld ;
+            if (fileInfo.pcgrp_id == GRP_OLD || fileInfo.pcgrp_id == IDENT_PC1211) fileInfo.apostrophe = ApostOld ;
 
         case IDENT_NEW_BAS :
         case IDENT_NEW_PAS :
@@ -6381,9 +6393,9 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
                                           && fileInfo.ident != IDENT_PC16_BAS
                                           && fileInfo.ident != IDENT_E_BAS) {
                 /* RSV for PC-1500 has a separate ID but other are compatible with IMG of BASIC */
-                if (Qcnt == 0) printf (" Output format : Forced to Binary RSV-Data%s\n", text) ;
+                if (fileInfo.opt.Qcnt == 0) printf (" Output format : Forced to Binary RSV-Data%s\n", text) ;
 
-                if (pcId < 1280 && pcId >= 1100) rsvmax = rsvmin ;
+                if (fileInfo.opt.pcId < 1280 && fileInfo.opt.pcId >= 1100) rsvmax = rsvmin ;
                 else rsvmax = 144 ;
 
                 for ( ii = 0 ; ii < rsvmax + 1 ; ++ii ) { //ToDo Rewrite this code for RSV
@@ -6395,7 +6407,7 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
                             fileInfo.writing = false ; /* no end mark written */
                             error = ReadByteFromWav (order, &byte, &fileInfo);
                             if (error != ERR_OK) break ;
-                            if ( ( (fileInfo.debug & 0x0040) > 0 ) && (Qcnt == 0) ) printf(" EOF:%02X", (uchar) byte);
+                            if ( ( (fileInfo.debug & 0x0040) > 0 ) && (fileInfo.opt.Qcnt == 0) ) printf(" EOF:%02X", (uchar) byte);
                             /* 2. EOF and Last Checksum */
                             fileInfo.count = BLK_NEW - 1 ;
                             fileInfo.status = STAT_EOT ;
@@ -6405,11 +6417,11 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
                     error = ReadByteSumFromWav (order, &byte, &fileInfo);
                     if (error > ERR_OK) break ;
 
-                    if ( ii == rsvmin && byte == BAS_NEW_EOF && pcId < 1280
+                    if ( ii == rsvmin && byte == BAS_NEW_EOF && fileInfo.opt.pcId < 1280
                         && fileInfo.writing == true ) {  /* Reserve data of PC-126x max. 48 bytes */
 
                             /* unexpected EOF */
-                            if ( ( (fileInfo.debug & 0x0040) > 0 ) && (Qcnt == 0) ) printf(":EOF");
+                            if ( ( (fileInfo.debug & 0x0040) > 0 ) && (fileInfo.opt.Qcnt == 0) ) printf(":EOF");
                             rsvmax = rsvmin ;
                             --fileInfo.total;
                             fileInfo.sum = fileInfo.sum_before;
@@ -6441,12 +6453,12 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
                     }
                     else if (error != ERR_OK) break ;
 
-                    error = WriteByteToFile (byte, &dstFd) ;
+                    error = WriteByteToFile (byte, &dstFd, &fileInfo) ;
                     if (error != ERR_OK) break ;
                 }
             }   // end RSV
             else {
-                if (Qcnt == 0) {
+                if (fileInfo.opt.Qcnt == 0) {
                     if (fileInfo.type == TYPE_IMG)
                         printf (" Output format : Forced to Binary%s\n", text) ;
                     else if (fileInfo.utf8 == 1)
@@ -6466,13 +6478,13 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
 
                     if (fileInfo.type == TYPE_IMG) {
                         for ( ii = 0 ; ii < llength ; ++ii ) {
-                            error = WriteCharToFile ( text[ii], &dstFd) ;
+                            error = WriteCharToFile ( text[ii], &dstFd, &fileInfo) ;
                             if (error != ERR_OK) break ;
                         }
                     }
                     else {
                         /* Write it in the destination file */
-                        error = WriteStringToFile (text, &dstFd) ;
+                        error = WriteStringToFile (text, &dstFd, &fileInfo) ;
                         if (error != ERR_OK) break ;
                     }
                     error = error_tmp ;
@@ -6483,19 +6495,19 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
             }  // end basic
             error_tmp = error ;
 
-            if ( SHCc != 0 && type == TYPE_IMG) { /* End marks included in SHC image */
-                if ( pcgrpId == GRP_NEW || pcgrpId == GRP_EXT ) {
-                        error = WriteByteToFile (BAS_NEW_EOF, &dstFd);
+            if ( fileInfo.opt.SHCc != 0 && type == TYPE_IMG) { /* End marks included in SHC image */
+                if ( fileInfo.pcgrp_id == GRP_NEW || fileInfo.pcgrp_id == GRP_EXT ) {
+                        error = WriteByteToFile (BAS_NEW_EOF, &dstFd, &fileInfo);
                         if (error != ERR_OK) break ;
                 }
-                if ( pcgrpId == GRP_OLD) error = WriteByteToFile (BAS_OLD_EOF, &dstFd);
-                else error = WriteByteToFile (BAS_NEW_EOF, &dstFd);
+                if ( fileInfo.pcgrp_id == GRP_OLD) error = WriteByteToFile (BAS_OLD_EOF, &dstFd, &fileInfo);
+                else error = WriteByteToFile (BAS_NEW_EOF, &dstFd, &fileInfo);
                 if (error != ERR_OK) break ;
             }
-            else if (SHAc != 0) {
-                error = WriteByteToFile (EOF_ASC, &dstFd);
+            else if (fileInfo.opt.SHAc != 0) {
+                error = WriteByteToFile (EOF_ASC, &dstFd, &fileInfo);
                 if (error != ERR_OK) break ;
-                error = WriteByteToFile (EOF_ASC, &dstFd);
+                error = WriteByteToFile (EOF_ASC, &dstFd, &fileInfo);
                 if (error != ERR_OK) break ;
             }
             error = error_tmp ;
@@ -6509,7 +6521,7 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
 
 
         case IDENT_RAW :
-            if (Qcnt == 0) printf (" Output format : Forced to Binary raw data%s\n", text) ;
+            if (fileInfo.opt.Qcnt == 0) printf (" Output format : Forced to Binary raw data%s\n", text) ;
             while ( error == ERR_OK ) {
                         byte = UNREAD;
                         error = ReadByteFromWav (order, &byte, &fileInfo);
@@ -6519,12 +6531,12 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
                                 break ;
                         }
 
-                        if ( ( (fileInfo.debug & 0x0040) > 0 ) && (Qcnt == 0) )
+                        if ( ( (fileInfo.debug & 0x0040) > 0 ) && (fileInfo.opt.Qcnt == 0) )
                             printf(" %02X", (uchar) byte);
 
                         error_tmp = error ;
                         // Write it in the destination file queue
-                        error = WriteByteToFile (byte, &dstFd) ;
+                        error = WriteByteToFile (byte, &dstFd, &fileInfo) ;
                         if (error != ERR_OK) break ;
                         ++ fileInfo.total ;
 
@@ -6544,26 +6556,26 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
 
 
         default :
-            printf ("\n%s:Convert: Unknown Ident\n", argP) ;
+            printf ("\n%s:Convert: Unknown Ident\n", fileInfo.opt.argP) ;
             error = ERR_FMT;
             break ;
         } // end switch ident
 
-        if ( pcgrpId == IDENT_PC1500) { /* End mark reading */
+        if ( fileInfo.pcgrp_id == IDENT_PC1500) { /* End mark reading */
                 if (error==ERR_EOF || error==ERR_NSYNC) { /* EOF mark not included */
                     byte=EOF_15;
-                    if (Qcnt==0) printf(" Missing EOT mark %02X\n", (uchar) byte) ;
+                    if (fileInfo.opt.Qcnt==0) printf(" Missing EOT mark %02X\n", (uchar) byte) ;
                     ++ fileInfo.wrn_cnt;
                 }
                 else if (fileInfo.ident == IDENT_PC15_DAT) {
                     byte=EOF_15; /* read from ReadHeadFromDataWav */
-                    if ( ( (fileInfo.debug & 0x0040) > 0 ) && (Qcnt == 0) )
+                    if ( ( (fileInfo.debug & 0x0040) > 0 ) && (fileInfo.opt.Qcnt == 0) )
                             printf("=EOT") ;
                 }
                 else {
                     error = ReadByteFromWav (order, &byte, &fileInfo);
                     if (error > ERR_OK || byte == UNREAD) break ;
-                    if ( ( (fileInfo.debug & 0x0040) > 0 ) && (Qcnt == 0) )
+                    if ( ( (fileInfo.debug & 0x0040) > 0 ) && (fileInfo.opt.Qcnt == 0) )
                             printf(" EOT:(%02X)", (uchar) byte ) ; /* last byte */
                 }
                 /* if ( SHCc != 0 ) { //End mark included in SHC image
@@ -6583,7 +6595,7 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
     if ( error == ERR_EOT) error = ERR_OK ;
     error_tmp = error ;
 
-    if (Qcnt == 0) {
+    if (fileInfo.opt.Qcnt == 0) {
         if (fileInfo.debug !=0 ) printf ("\n") ;
         if (fileInfo.total > 0 )  printf (" Total bytes read (without header and sums): %ld", fileInfo.total );
         if (fileInfo.wrn_cnt > 0 && fileInfo.debug > 0) printf (" with %ld warnings", fileInfo.wrn_cnt );
@@ -6595,16 +6607,17 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
     if (error_tmp != ERR_ARG && dstFd != NULL) {
         error = fclose (dstFd) ;
         if (error != ERR_OK) {
-            printf ("\n%s: Can't close the destination file\n", argP) ;
+            printf ("\n%s: Can't close the destination file\n", fileInfo.opt.argP) ;
             error_tmp = ERR_FILE ;
         }
     }
 
    /* Close the source file */
+    FreeSamples (&fileInfo) ;
     if (fileInfo.ptrFd != NULL) {
         error = fclose (fileInfo.ptrFd) ;
         if (error != ERR_OK) {
-            printf ("\n%s: Can't close the source file\n", argP) ;
+            printf ("\n%s: Can't close the source file\n", fileInfo.opt.argP) ;
             error_tmp = ERR_FILE ;
         }
     }
@@ -6614,7 +6627,7 @@ int ConvertWavToBin (char*  ptrSrcFile, /* Source file string*/
 }
 
 
-void PrintHelp (char* argH)
+void PrintHelp (char* argH, char* argP)
 {
   if (strcmp (argH, "l")==0 || strcmp (argH, "1")==0 || strcmp (argH, "level")==0 || strcmp (argH, "debug")==0 ||
       strcmp (argH, "d")==0 || strcmp (argH, "device")==0 || strcmp (argH, "raw")==0) {
@@ -6689,6 +6702,7 @@ void PrintHelp (char* argH)
 	printf ("                     rsv  ReSerVe mode data (image),   tap  Emulator raw format\n") ;
 	printf ("-p, --pc=NUMBER   : SHARP pocket computer, (for BASIC-program text,\n") ;
 	printf ("                     is required for 1421, 1600 Mode 1, optionally for other)\n") ;
+	printf ("                     auto detect the PC group from the header (default)\n") ;
 	printf ("-c, --cspeed=VALUE: Ratio of CPU frequency to original (use it with a modified\n") ;
 	printf ("                     Pocket Computer, if speedup was switched on, 0.94 to 2.7)\n") ;
 	printf ("-u, --utf8=VALUE  : Convert special characters (only for BASIC-program text)\n") ;
@@ -6714,10 +6728,10 @@ void PrintHelp (char* argH)
   exit( EXIT_SUCCESS );
 }
 
-void PrintVersion (void)
+void PrintVersion (char* argP)
 {   char argPU[cLPF] = "" ;
 	strcpy(argPU, argP) ;
-	printf ("%s (%s) version: 2.0.0a\n", argP, strupr(argPU) ) ;
+	printf ("%s (%s) version: 2.0.0b\n", argP, strupr(argPU) ) ;
 	printf ("Author: Pocket -> www.pocketmuseum.com\n") ; /* Please do not remove */
 	printf ("        2013-2015 Torsten Muecker\n") ;       /* Please do not remove */
 	printf ("        for complete list see the manual and the source code\n") ;
@@ -6727,16 +6741,21 @@ void PrintVersion (void)
 }
 
 
-void MoreInfo (int error)
+void MoreInfo (char* argP, int error)
 {	printf("%s: '%s --help' gives you more information\n", argP, argP);
 	exit( error );
 }
 
 
+                        /* Compile with -DWAV2BIN_LIB to link ConvertWavToBin into another program, the
+                           options are passed with an OptionInfo, see wav2bin.h */
+#ifndef WAV2BIN_LIB
 int main( int argc, char **argv )  /* (int argc, char* argv[]) */
 {	/*        0=SrcFile 1=[DstFile] 2=[-t] 3=[-p] 4=[-d] 5=[-c] 6=[-u] 7=[-w] 8=[-h] 9=[-l] 10=[-l|] */
 	  char  argD[11][cLPF] = { "", "", "bas", "", "pc", "1.0", "yes", "5", "", DEBUG_ARG, "0" }, *ptrErr = NULL ;
       char  argS[cLPF] = "", *ptrToken ;
+      char  argP[cLPF] = "" ;   /* ProgramName */
+OptionInfo  opt ;               /* options of the conversion */
 	  uint  FILEcnt = 0, Tcnt = 0, PCcnt=0, Dcnt = 0, Ccnt = 0, Ucnt = 0, Wcnt = 0, Lcnt = 0, Hcnt = 0 ;
  	 ulong  type, utf8, debug = 0 ;
  	 ulong  order = ORDER_STD ;
@@ -6769,6 +6788,8 @@ static int  longval;
     else if (strrchr (argv[0], '/')) strncpy(argP, 1 + strrchr (argv[0], '/'), cLPF-1);    /* Linux   path separator '/' */
     else strncpy(argP, argv[0], cLPF-1);
     if ( strrchr (argP, '.')) *(strrchr (argP, '.')) = '\0';                      /* Extension separator '.'    */
+    SetDefaultOptions (&opt) ;
+    opt.argP = argP ;
 
 
     /* check, if the old argument format is used */
@@ -6829,19 +6850,19 @@ static int  longval;
             case 'c': strncpy( argD[5], optarg, cLPF-1); ++Ccnt; break;
             case 'u': strncpy( argD[6], optarg, cLPF-1); ++Ucnt; break;
             case 'w': strncpy( argD[7], optarg, cLPF-1); ++Wcnt; break;
-            case 'r': ++TAPc; break;
-            case 'q': ++Qcnt; break;
+            case 'r': ++opt.TAPc; break;
+            case 'q': ++opt.Qcnt; break;
             case 'l': { if (Lcnt < 2) strncpy( argD[9+Lcnt], optarg, cLPF-1);
                         ++Lcnt; break; }
             case 0:
                 switch (longval) {
-                    case 'v': PrintVersion (); break;
+                    case 'v': PrintVersion (argP); break;
                     case 'h': { if ( optarg != 0 ) strncpy( argD[8], optarg, cLPF-1);
                             ++Hcnt; break; }
                 } break;
             case '?':
                       printf("%s: Unknown argument for '%s'\n", argP, argP);
-            default : MoreInfo (ERR_SYNT); break;
+            default : MoreInfo (argP, ERR_SYNT); break;
             }
         }
 
@@ -6853,16 +6874,16 @@ static int  longval;
         }
 
         if ((FILEcnt > 2) || (Tcnt > 1) || (PCcnt > 1) || (Dcnt > 1) || (Ccnt > 1) || (Ucnt > 1) ||
-            (Wcnt > 1) || (TAPc > 1) || (Qcnt > 1) || (Lcnt > 2) || (Hcnt > 1)) {
+            (Wcnt > 1) || (opt.TAPc > 1) || (opt.Qcnt > 1) || (Lcnt > 2) || (Hcnt > 1)) {
                 printf("%s: To much arguments of same type for '%s'\n", argP, argP);
-                MoreInfo (ERR_SYNT);
+                MoreInfo (argP, ERR_SYNT);
         }
         if ( Hcnt == 1 ) {
             (void) strlor (argD[8]) ;
-            PrintHelp (argD[8]) ;
+            PrintHelp (argD[8], argP) ;
             break;
         }
-        if (FILEcnt < 1) { printf("%s: Missing Operand after '%s'\n", argP, argP); MoreInfo (ERR_SYNT); }
+        if (FILEcnt < 1) { printf("%s: Missing Operand after '%s'\n", argP, argP); MoreInfo (argP, ERR_SYNT); }
 
         (void) strlor(argD[2]) ;
         type = TYPE_NOK ;
@@ -6871,7 +6892,7 @@ static int  longval;
             type = TYPE_BAS ;
         else if (strcmp (argD[2], "sha") == 0) {
             type = TYPE_BAS ;
-            SHAc = 1 ;
+            opt.SHAc = 1 ;
         }
         else if (strcmp (argD[2], "img") == 0 || strcmp (argD[2], "bin") == 0 || strcmp (argD[2], "dat") == 0 ||
                  strcmp (argD[2], "txt") == 0  )
@@ -6880,13 +6901,13 @@ static int  longval;
             type = TYPE_ASC ;     /* Convert will switch it to IMG (or BAS) */
         else if (strcmp (argD[2], "shc") == 0) {
             type = TYPE_IMG ;
-            SHCc = 1 ;
+            opt.SHCc = 1 ;
         }
         else if (strcmp (argD[2], "rsv") == 0)
             type = TYPE_RSV ;
         else if (strcmp (argD[2], "tap") == 0) {
             type = TYPE_RAW ;
-            TAPw = 1 ;
+            opt.TAPw = 1 ;
         }
         else if (strcmp (argD[2], "raw") == 0)
             type = TYPE_RAW ;
@@ -6896,7 +6917,7 @@ static int  longval;
         }
         else {
             printf ("%s: Destination file type '%s' is not valid\n", argP, argD[2]) ;
-            MoreInfo (ERR_ARG);
+            MoreInfo (argP, ERR_ARG);
         }
 
         ptrToken = strrchr (argD[0], '.') ;
@@ -6915,30 +6936,30 @@ static int  longval;
             strncpy (argS, ptrToken, cLPF -1) ;
             (void) strlor(argS) ;
             if (strcmp (argS, ".tap") == 0) {
-                if (TAPc==0 && Qcnt==0) printf("%s: Switched input format from wav to --tap implicitly\n", argP);
-                TAPc |= 1;
+                if (opt.TAPc==0 && opt.Qcnt==0) printf("%s: Switched input format from wav to --tap implicitly\n", argP);
+                opt.TAPc |= 1;
             }
         }
-        else if (TAPc !=0) strncat (argD[0], ".tap", cLPF -1);
+        else if (opt.TAPc !=0) strncat (argD[0], ".tap", cLPF -1);
         else strncat (argD[0], ".wav", cLPF -1);
 
-        if (Qcnt == 0) {
-            if (TAPw !=0 ) printf ("%s: Writes Emulator TAP format with name, header and checksums.\n", argP) ;
+        if (opt.Qcnt == 0) {
+            if (opt.TAPw !=0 ) printf ("%s: Writes Emulator TAP format with name, header and checksums.\n", argP) ;
             else if (type == TYPE_RAW ) printf ("%s: Writes raw data with name, header and checksums.\n", argP) ;
         }
 
         if ( type != TYPE_BAS ) {
             if (Wcnt != 0) printf ("%s: Use option -w only for BASIC-program text file\n", argP) ;
             if (Ucnt != 0) printf ("%s: Use option -u only for BASIC-program text file\n", argP) ;
-            // MoreInfo (ERR_ARG);
+            // MoreInfo (argP, ERR_ARG);
         }
 
 
         i = 3 ;
-        if (strlen (argD[i]) == 0)
-            pcId = 0 ;      /* default pcId, because only needed for special token tab or to select frequency */
+        strupr (argD[i]) ;
+        if (strlen (argD[i]) == 0 || strcmp (argD[i], "AUTO") == 0)
+            opt.pcId = 0 ;      /* default pcId, because only needed for special token tab or to select frequency */
         else {
-            strupr (argD[i]) ;
                  if (strcmp (argD[i], "1100")   == 0) strcpy (argD[i],  "1245") ;
             else if (strcmp (argD[i], "PA-500") == 0) strcpy (argD[i],  "1150") ;
             else if (strcmp (argD[i], "EL-6300")== 0) strcpy (argD[i],  "1150") ;
@@ -7076,22 +7097,22 @@ static int  longval;
             }
             else if (strcmp (argD[i], "E1475")  == 0
                  ||  strcmp (argD[i], "E475")   == 0) {
-                 if (Qcnt == 0) printf ("\n%s: Files from Bin2wav in mode 'PC-1475' are supported with PC-%s.\n", argP, argD[i]) ;
+                 if (opt.Qcnt == 0) printf ("\n%s: Files from Bin2wav in mode 'PC-1475' are supported with PC-%s.\n", argP, argD[i]) ;
                                                       strcpy (argD[i],   "475") ;
             }
 
-            pcId = (ulong) strtol (argD[i], &ptrErr, 0) ;
-                if (pcId < 200 || pcId > 7100) {
+            opt.pcId = (ulong) strtol (argD[i], &ptrErr, 0) ;
+                if (opt.pcId < 200 || opt.pcId > 7100) {
                     printf ("%s: Pocket computer %s is not valid\n", argP, argD[i]) ;
-                    MoreInfo (ERR_ARG); // exit ;
+                    MoreInfo (argP, ERR_ARG); // exit ;
                     break ;
                 }
             /* Compare the PC Ident to the allowed tokens */
-            switch (pcId) {
+            switch (opt.pcId) {
             case 1211 :
-                pcgrpId=IDENT_PC1211 ;
-                Base_FREQ2 = 0 ;
-                Base_FREQ3 = 0 ;
+                opt.pcgrpId=IDENT_PC1211 ;
+                opt.Base_FREQ2 = 0 ;
+                opt.Base_FREQ3 = 0 ;
                 break ;
             case 1245 :
             case 1246 :
@@ -7120,39 +7141,39 @@ static int  longval;
             case 1421 :     /* for this the option -p is necessary */
             case 1401 :     /* for this optionally, Yen-sign only */
             case 1402 :
-                Base_FREQ2 = 0 ;
-                Base_FREQ3 = 0 ;
+                opt.Base_FREQ2 = 0 ;
+                opt.Base_FREQ3 = 0 ;
                 break ;
             case 1500 :
-                Base_FREQ1 = 0 ;
-                Base_FREQ3 = 0 ;
+                opt.Base_FREQ1 = 0 ;
+                opt.Base_FREQ3 = 0 ;
                 if (type == TYPE_RAW) order = ORDER_INV ; /* for debug of raw data set here */
-                pcgrpId = IDENT_PC1500 ;
+                opt.pcgrpId = IDENT_PC1500 ;
                 break ;
             case 1609 : /* PC-1600 Mode 0 */
-                Base_FREQ2 = 0 ;
+                opt.Base_FREQ2 = 0 ;
             case 1601 : /* PC-1600 Mode 1 */
-                if (pcId == 1601) Base_FREQ3 = 0 ;
+                if (opt.pcId == 1601) opt.Base_FREQ3 = 0 ;
             case 1600 :
             case 1560 :
-                Base_FREQ1 = 0 ;
+                opt.Base_FREQ1 = 0 ;
                 if (type == TYPE_RAW) order = ORDER_INV ;
-                pcgrpId = GRP_16 ;  /* Mode 1 Id changed in PrintSaveId to IDENT_PC1500 */
-                pcId = 1600 ;  /* used to select token table when saved from mode 1500 */
+                opt.pcgrpId = GRP_16 ;  /* Mode 1 Id changed in PrintSaveId to IDENT_PC1500 */
+                opt.pcId = 1600 ;  /* used to select token table when saved from mode 1500 */
                 break ;
             case  500 :
-                Base_FREQ1 = 0 ;
+                opt.Base_FREQ1 = 0 ;
             case  475 :  /* for E500 files from Bin2wav in the format of 1475 */
-                Base_FREQ2 = 0 ;
-                ll_Img = 255 ;
-                pcgrpId = GRP_E ;
+                opt.Base_FREQ2 = 0 ;
+                opt.ll_Img = 255 ;
+                opt.pcgrpId = GRP_E ;
                 break ;
             case  220 :
             case  850 :
-                Base_FREQ1 = 0 ;
-                Base_FREQ2 = 0 ;
-                ll_Img = 255 ;
-                pcgrpId = GRP_G ;
+                opt.Base_FREQ1 = 0 ;
+                opt.Base_FREQ2 = 0 ;
+                opt.ll_Img = 255 ;
+                opt.pcgrpId = GRP_G ;
                 break ;
 
             default :
@@ -7166,58 +7187,58 @@ static int  longval;
 
         strlor(argD[4]) ;
         if (strcmp (argD[4], "pc") == 0 || strcmp (argD[4], "150") == 0 )
-            devId = DEV_PC ;
+            opt.devId = DEV_PC ;
         else if (strcmp (argD[4], "cas") == 0)
-            devId = DEV_CAS ;
+            opt.devId = DEV_CAS ;
         else if (strcmp (argD[4], "air") == 0)
-            devId = DEV_AIR ;
+            opt.devId = DEV_AIR ;
         else if (strcmp (argD[4], "emu") == 0)
-            devId = DEV_EMU ;
+            opt.devId = DEV_EMU ;
         else if (strcmp (argD[4], "tap") == 0)
-            TAPc |= 1 ;
+            opt.TAPc |= 1 ;
         else {
             printf ("%s: Source device of digitalization '%s' is not valid\n", argP, argD[4]) ;
-            MoreInfo (ERR_ARG);
+            MoreInfo (argP, ERR_ARG);
         }
-        if (Qcnt == 0 ) {
-            if ( devId != DEV_PC ) printf ("%s: Device filter for waves recorded from '%s' was selected\n", argP, argD[4]) ;
+        if (opt.Qcnt == 0 ) {
+            if ( opt.devId != DEV_PC ) printf ("%s: Device filter for waves recorded from '%s' was selected\n", argP, argD[4]) ;
 
-            if ( devId == DEV_AIR ) {
-                if (pcgrpId == IDENT_PC1211 || pcgrpId == IDENT_PC1500 || pcgrpId == GRP_E || pcgrpId == GRP_G || pcgrpId == GRP_16)
+            if ( opt.devId == DEV_AIR ) {
+                if (opt.pcgrpId == IDENT_PC1211 || opt.pcgrpId == IDENT_PC1500 || opt.pcgrpId == GRP_E || opt.pcgrpId == GRP_G || opt.pcgrpId == GRP_16)
                     printf ("%s: Option 'device=%s' is not applicable for this PC group\n", argP, argD[4]) ;
             }
-            else if ( devId == DEV_CAS ) {
-                if (pcgrpId == GRP_E || pcgrpId == GRP_G || pcgrpId == GRP_16)
+            else if ( opt.devId == DEV_CAS ) {
+                if (opt.pcgrpId == GRP_E || opt.pcgrpId == GRP_G || opt.pcgrpId == GRP_16)
                     printf ("%s: Option 'device=%s' has no effect for this PC \n", argP, argD[4]) ;
             }
         }
-        if ( devId == DEV_EMU ) {
-            if (PCcnt == 0) {
+        if ( opt.devId == DEV_EMU ) {
+            if (opt.pcId == 0) {
                 printf ("%s: Option 'pc' is required with option 'device=%s' \n", argP, argD[4]) ;
-                MoreInfo (ERR_ARG);
+                MoreInfo (argP, ERR_ARG);
             }
             /* only one base frequency allowed with waves recorded from emulator */
-            if (Base_FREQ3 > 0) { Base_FREQ1 = 0; Base_FREQ2 = 0; } /* no backward compatibility with Emulator */
+            if (opt.Base_FREQ3 > 0) { opt.Base_FREQ1 = 0; opt.Base_FREQ2 = 0; } /* no backward compatibility with Emulator */
         }
 
         /* Check the range of CPU (or cassette) speed factor from modified hardware */
-        speed = strtod (argD[5], &ptrErr) ;
-        if ((*ptrErr != 0) || 0.16 > speed || speed > 5.701 ||
-            (devId != DEV_EMU && (0.939 > speed || speed > 2.701))) {
+        opt.speed = strtod (argD[5], &ptrErr) ;
+        if ((*ptrErr != 0) || 0.16 > opt.speed || opt.speed > 5.701 ||
+            (opt.devId != DEV_EMU && (0.939 > opt.speed || opt.speed > 2.701))) {
                 printf ("%s: A ratio of CPU frequency to an unmodified %s is not supported.\n", argP, argD[5]) ;
-                MoreInfo (ERR_ARG);
+                MoreInfo (argP, ERR_ARG);
         }
-        else if ((float) speed != 1.0 ) {
-            if (Qcnt == 0) printf ("%s: Option cspeed, ratio to original CPU frequency: %1.2f\n", argP, speed) ;
-            Base_FREQ1 *= speed ;
-            Base_FREQ2 *= speed ;
-            Base_FREQ3 *= speed ;
+        else if ((float) opt.speed != 1.0 ) {
+            if (opt.Qcnt == 0) printf ("%s: Option cspeed, ratio to original CPU frequency: %1.2f\n", argP, opt.speed) ;
+            opt.Base_FREQ1 *= opt.speed ;
+            opt.Base_FREQ2 *= opt.speed ;
+            opt.Base_FREQ3 *= opt.speed ;
         }
 
         /* Check the utf8 conversion flag */
         (void) strlor (argD[6]) ;
         utf8 = 0 ;
-        if (SHAc != 0 ) utf8 = UTF8_DOS ;
+        if (opt.SHAc != 0 ) utf8 = UTF8_DOS ;
         else if (type == TYPE_BAS) {
             utf8 = 4 ;
             if (strcmp (argD[6], "no") == 0) utf8 = 0 ;
@@ -7226,16 +7247,16 @@ static int  longval;
             if (strcmp (argD[6], "dos") == 0 || strcmp (argD[6], "2dos") == 0) utf8 = UTF8_DOS ;
             if (utf8 >= 4) {
                 printf ("%s: Wrong value for -u\n", argP) ;
-                MoreInfo (ERR_ARG);
+                MoreInfo (argP, ERR_ARG);
             }
         }
 
         /* Check the minimum width of line number */
-        if (SHAc != 0 ) linewidth = 0 ;
-        else linewidth = (ulong) strtol (argD[7], &ptrErr, 0) ;
-        if ((*ptrErr != 0) || (linewidth !=0 && linewidth < 3) || (linewidth > 10)) {
+        if (opt.SHAc != 0 ) opt.linewidth = 0 ;
+        else opt.linewidth = (ulong) strtol (argD[7], &ptrErr, 0) ;
+        if ((*ptrErr != 0) || (opt.linewidth !=0 && opt.linewidth < 3) || (opt.linewidth > 10)) {
                 printf ("%s: Minimum width of line number %s is not valid\n", argP, argD[7]) ;
-                MoreInfo (ERR_ARG);
+                MoreInfo (argP, ERR_ARG);
         }
 
 
@@ -7244,49 +7265,49 @@ static int  longval;
         if (*ptrErr != 0) {
             debug = 0 ;
             printf ("%s: Convert debug level number from '%s' is not valid\n", argP, argD[9]) ;
-            MoreInfo (ERR_ARG);
+            MoreInfo (argP, ERR_ARG);
         }
         debug = debug | (ulong) strtol (argD[10], &ptrErr, 0) ;
         if (*ptrErr != 0) {
             debug = 0 ;
             printf ("%s: Convert debug level number2 from '%s' is not valid\n", argP, argD[10]) ;
-            MoreInfo (ERR_ARG);
+            MoreInfo (argP, ERR_ARG);
         }
 
-        if ((debug & BASE_FRQ_FIX) > 0 && Qcnt == 0) {
+        if ((debug & BASE_FRQ_FIX) > 0 && opt.Qcnt == 0) {
             printf ("%s: Base frequency tuning deactivated", argP );
-            if (devId == DEV_EMU ) {
+            if (opt.devId == DEV_EMU ) {
                     printf (", device option '%s' ignored\n", argD[4]);
-                    devId = DEV_PC ;
+                    opt.devId = DEV_PC ;
             }
             else printf ("\n" );
         }
 
-        if ((debug & NO_RATE_AMP) > 0) Rate_Amp_Def = 0 ;
-        if ((debug & NO_RATE_AMP) > 0 && Qcnt == 0) {
+        if ((debug & NO_RATE_AMP) > 0) opt.Rate_Amp_Def = 0 ;
+        if ((debug & NO_RATE_AMP) > 0 && opt.Qcnt == 0) {
             printf ("%s: Rate amp was deactivated", argP );
-            if (devId == DEV_CAS || devId == DEV_AIR ) printf (", device option '%s' will be ignored\n", argD[4]);
+            if (opt.devId == DEV_CAS || opt.devId == DEV_AIR ) printf (", device option '%s' will be ignored\n", argD[4]);
             else printf ("\n" );
         }
 
         if ((debug & TRANS_OLD) > 0) {        /* use old definitions */
-            Trans_High_def = TRANS_HIGH_15 ;  /* audio level, for older more noisy lead ins */
-            Trans_Low_def  = TRANS_LOW_15  ;
+            opt.Trans_High_def = TRANS_HIGH_15 ;  /* audio level, for older more noisy lead ins */
+            opt.Trans_Low_def  = TRANS_LOW_15  ;
         }
-        if ((debug & TRANS_OLD ) > 0 && Qcnt == 0) printf
+        if ((debug & TRANS_OLD ) > 0 && opt.Qcnt == 0) printf
                 ("%s: will apply the method of sample processing up to Wav2bin 1.5.\n", argP );
 
-        if ((debug & IGN_ERR_SUM) > 0 && Qcnt == 0) printf
+        if ((debug & IGN_ERR_SUM) > 0 && opt.Qcnt == 0) printf
                 ("%s: Exit from Error %d is disabled. Correct destination file manually!\n", argP, ERR_SUM );
 
         /* Convert the Wav file */
-        error = ConvertWavToBin (argD[0], argD[1], type, order, utf8, debug) ;
+        error = ConvertWavToBin (argD[0], argD[1], type, order, utf8, debug, &opt) ;
 
     } while (0) ;
     if (error != ERR_OK && error != ERR_EOT) {
             if (error == ERR_EOF) error = ERR_FILE ;
             if (error == ERR_NSYNC) error = ERR_SYNC ;
-            if (error == ERR_SUM && Qcnt == 0) printf
+            if (error == ERR_SUM && opt.Qcnt == 0) printf
                 ("Note: Immediate exit from Error %d can disabled with the option '-l 0x%03X'\n", ERR_SUM, IGN_ERR_SUM );
             if (debug != 0) printf ("Exit with error %d\n", error) ;
             return (error) ; // for debugging set here a breakpoint and in MoreInfo()
@@ -7294,3 +7315,4 @@ static int  longval;
     else return (EXIT_SUCCESS) ;
 // printf("Debug# error: %i", error);
 }
+#endif // WAV2BIN_LIB